@@ -0,0 +1,157 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// VCL
+#include <vcl/hid/buttonset.h>
+#include <vcl/hid/decodeplan.h>
+
+using namespace Vcl::HID;
+
+namespace
+{
+	//! Number of buttons of the simulated board
+	const uint32_t NrButtons = 128;
+
+	//! Size of a report: report ID, two bytes of axes, buttons with padding
+	const size_t ReportSize = 32;
+
+	//! Decode the buttons the way the HID API reports them: a list of
+	//! usages of the pressed buttons, which are set one at a time
+	void decodeUsages(const std::vector<ButtonLocation>& locations, gsl::span<const uint8_t> report, ButtonSet& buttons)
+	{
+		uint16_t usages[NrButtons];
+		uint32_t nr_usages = 0;
+		for (uint32_t i = 0; i < NrButtons; i++)
+		{
+			const auto bit = locations[i].bit;
+			if ((report[bit / 8] >> (bit % 8)) & 1)
+				usages[nr_usages++] = static_cast<uint16_t>(i + 1);
+		}
+
+		buttons.clear();
+		for (uint32_t i = 0; i < nr_usages; i++)
+			buttons.set(usages[i] - 1);
+	}
+
+	template<typename Func>
+	double measure(const char* name, size_t nr_reports, size_t nr_rounds, Func&& func)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+		for (size_t r = 0; r < nr_rounds; r++)
+			for (size_t i = 0; i < nr_reports; i++)
+				func(i);
+		const auto end = std::chrono::high_resolution_clock::now();
+
+		const double ns = std::chrono::duration<double, std::nano>(end - start).count() / (nr_reports * nr_rounds);
+		std::printf("%-24s %8.2f ns/report\n", name, ns);
+		return ns;
+	}
+
+	void run(const char* layout, const std::vector<ButtonLocation>& locations, double pressed_ratio)
+	{
+		const size_t nr_reports = 1024;
+		const size_t nr_rounds = 2000;
+
+		std::mt19937 rng{ 42 };
+		std::bernoulli_distribution pressed{ pressed_ratio };
+
+		std::vector<uint8_t> reports(nr_reports * ReportSize, 0);
+		for (size_t i = 0; i < nr_reports; i++)
+		{
+			uint8_t* report = reports.data() + i * ReportSize;
+			report[0] = 1;
+			for (const auto& location : locations)
+				if (pressed(rng))
+					report[location.bit / 8] |= uint8_t(1u << (location.bit % 8));
+		}
+		auto report = [&](size_t i)
+		{
+			return gsl::span<const uint8_t>{ reports.data() + i * ReportSize, static_cast<std::ptrdiff_t>(ReportSize) };
+		};
+
+		const DecodePlan plan{ locations };
+		ButtonSet plan_buttons{ NrButtons };
+		ButtonSet usage_buttons{ NrButtons };
+
+		// Verify the plan against the reference
+		for (size_t i = 0; i < nr_reports; i++)
+		{
+			plan.decodeButtons(report(i), plan_buttons);
+			decodeUsages(locations, report(i), usage_buttons);
+			if (plan_buttons != usage_buttons)
+			{
+				std::printf("%s: decoding mismatch in report %zu\n", layout, i);
+				return;
+			}
+		}
+
+		std::printf("%s, %.0f%% pressed, %zu segments\n", layout, pressed_ratio * 100, plan.buttonSegments().size());
+		const double usages = measure("  usage list", nr_reports, nr_rounds, [&](size_t i)
+		{
+			decodeUsages(locations, report(i), usage_buttons);
+		});
+		const double words = measure("  decode plan", nr_reports, nr_rounds, [&](size_t i)
+		{
+			plan.decodeButtons(report(i), plan_buttons);
+		});
+		std::printf("  speed-up %.1fx\n", usages / words);
+	}
+}
+
+int main(int, char**)
+{
+#ifdef VCL_HID_BMI2
+	std::printf("Bit extraction: BMI2 PEXT\n");
+#else
+	std::printf("Bit extraction: portable\n");
+#endif
+
+	// Buttons packed after the axes
+	std::vector<ButtonLocation> packed;
+	for (uint32_t i = 0; i < NrButtons; i++)
+		packed.push_back({ 1, 24 + i });
+
+	// Six buttons per byte, followed by two padding bits
+	std::vector<ButtonLocation> padded;
+	for (uint32_t i = 0; i < NrButtons; i++)
+		padded.push_back({ 1, 24 + (i / 6) * 8 + (i % 6) });
+
+	for (const double ratio : { 0.05, 0.5 })
+	{
+		run("Packed 128 buttons", packed, ratio);
+		run("Padded 128 buttons", padded, ratio);
+	}
+
+	return 0;
+}
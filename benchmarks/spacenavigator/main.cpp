@@ -0,0 +1,103 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// VCL
+#include <vcl/hid/spacenavigatorreport.h>
+
+using namespace Vcl::HID;
+
+namespace
+{
+	//! Size of the reports: report ID followed by the payload
+	const size_t ReportSize = 13;
+
+	template<typename Func>
+	double measure(const char* name, size_t nr_reports, size_t nr_rounds, Func&& func)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+		for (size_t r = 0; r < nr_rounds; r++)
+			for (size_t i = 0; i < nr_reports; i++)
+				func(i);
+		const auto end = std::chrono::high_resolution_clock::now();
+
+		const double ns = std::chrono::duration<double, std::nano>(end - start).count() / (nr_reports * nr_rounds);
+		std::printf("%-24s %8.2f ns/report\n", name, ns);
+		return ns;
+	}
+
+	//! Decode a stream of reports, mixing motion and key state reports
+	//! \param layout Name of the stream
+	//! \param ids Report IDs cycled through by the stream
+	//! \param report_size Size of the motion reports
+	void run(const char* layout, const std::vector<uint8_t>& ids, size_t report_size)
+	{
+		const size_t nr_reports = 1024;
+		const size_t nr_rounds = 20000;
+
+		std::mt19937 rng{ 42 };
+		std::uniform_int_distribution<int> value{ 0, 255 };
+
+		// Reports are stored without padding, thus most of them are unaligned
+		std::vector<uint8_t> reports(nr_reports * ReportSize + 1);
+		std::vector<size_t> sizes(nr_reports);
+		for (size_t i = 0; i < nr_reports; i++)
+		{
+			uint8_t* report = reports.data() + 1 + i * ReportSize;
+			report[0] = ids[i % ids.size()];
+			for (size_t b = 1; b < ReportSize; b++)
+				report[b] = static_cast<uint8_t>(value(rng));
+
+			sizes[i] = report[0] == 0x03 ? 3 : report_size;
+		}
+
+		SpaceNavigatorSample sample;
+		uint32_t checksum = 0;
+		std::printf("%s\n", layout);
+		measure("  decode", nr_reports, nr_rounds, [&](size_t i)
+		{
+			const uint8_t* report = reports.data() + 1 + i * ReportSize;
+			checksum += decodeSpaceNavigatorReport({ report, static_cast<std::ptrdiff_t>(sizes[i]) }, sample);
+			checksum += static_cast<uint16_t>(sample.axes[i % 6]);
+		});
+		std::printf("  checksum %08x\n", checksum);
+	}
+}
+
+int main(int, char**)
+{
+	run("Split reports (0x01, 0x02, 0x03)", { 0x01, 0x02, 0x01, 0x02, 0x03 }, 7);
+	run("High-speed reports (0x01, 0x03)", { 0x01, 0x01, 0x01, 0x01, 0x03 }, 13);
+
+	return 0;
+}
@@ -171,7 +171,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 	break;
 	case WM_INPUT_DEVICE_CHANGE:
 	{
-
+		manager.processDeviceChange(hWnd, message, wParam, lParam);
 	}
 	break;
 	default:
@@ -213,10 +213,21 @@ int main(char**, int)
 
 
 	MSG msg = { 0 };
-	while (GetMessage(&msg, NULL, 0, 0) > 0)
+	bool quit = false;
+	while (!quit)
 	{
-		TranslateMessage(&msg);
-		DispatchMessage(&msg);
+		// Wake up for new messages, the raw input and the input timers.
+		// The queued raw input is read by the manager in a single pass.
+		manager.waitForInput(hWnd);
+
+		while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
+		{
+			if (msg.message == WM_QUIT)
+				quit = true;
+
+			TranslateMessage(&msg);
+			DispatchMessage(&msg);
+		}
 	}
 
 	// Tear town the window
@@ -49,29 +49,29 @@ int main(char**, int)
 	const auto devs = manager.devices();
 	for (auto dev : devs)
 	{
-		std::wcout << dev->type() << L", " << dev->vendorName() << L", " << dev->deviceName() << L"\n";
+		std::cout << dev->type() << ", " << dev->vendorName() << ", " << dev->deviceName() << "\n";
 		switch (dev->type())
 		{
 		case DeviceType::Joystick:
 
-			std::wcout << L"Number of axes: "    << dynamic_cast<const Joystick*>(dev)->nrAxes() << L"\n";
-			std::wcout << L"Number of buttons: " << dynamic_cast<const Joystick*>(dev)->nrButtons() << L"\n";
+			std::cout << "Number of axes: "    << dynamic_cast<const Joystick*>(dev)->nrAxes() << "\n";
+			std::cout << "Number of buttons: " << dynamic_cast<const Joystick*>(dev)->nrButtons() << "\n";
 			break;
 
 		case DeviceType::Gamepad:
 
-			std::wcout << L"Number of axes: "    << dynamic_cast<const Gamepad*>(dev)->nrAxes() << L"\n";
-			std::wcout << L"Number of buttons: " << dynamic_cast<const Gamepad*>(dev)->nrButtons() << L"\n";
+			std::cout << "Number of axes: "    << dynamic_cast<const Gamepad*>(dev)->nrAxes() << "\n";
+			std::cout << "Number of buttons: " << dynamic_cast<const Gamepad*>(dev)->nrButtons() << "\n";
 			break;
 
 		case DeviceType::MultiAxisController:
 
-			std::wcout << L"Number of axes: "    << dynamic_cast<const MultiAxisController*>(dev)->nrAxes() << L"\n";
-			std::wcout << L"Number of buttons: " << dynamic_cast<const MultiAxisController*>(dev)->nrButtons() << L"\n";
+			std::cout << "Number of axes: "    << dynamic_cast<const MultiAxisController*>(dev)->nrAxes() << "\n";
+			std::cout << "Number of buttons: " << dynamic_cast<const MultiAxisController*>(dev)->nrButtons() << "\n";
 			break;
 		}
 
-		std::wcout << std::endl;
+		std::cout << std::endl;
 	}
 
 	return 0;
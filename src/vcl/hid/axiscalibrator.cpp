@@ -0,0 +1,203 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "axiscalibrator.h"
+
+// C++ Standard library
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace Vcl { namespace HID
+{
+	AxisNormalization::AxisNormalization(const AxisCalibration& calibration)
+	: center(static_cast<float>(calibration.center))
+	, deadZone(static_cast<float>(calibration.noise))
+	{
+		const float negative_range = static_cast<float>(calibration.center - calibration.minimum) - deadZone;
+		const float positive_range = static_cast<float>(calibration.maximum - calibration.center) - deadZone;
+		negativeScale = negative_range > 0 ? 1.0f / negative_range : 0.0f;
+		positiveScale = positive_range > 0 ? 1.0f / positive_range : 0.0f;
+	}
+
+	void AxisCalibrator::reset(int32_t logical_minimum, int32_t logical_maximum, const AxisCalibration& initial, bool is_measured)
+	{
+		_initial = initial;
+
+		// A measured range is only ever extended. Otherwise, the range
+		// is learned starting from the rest position.
+		_observedMinimum = is_measured ? initial.minimum : initial.center;
+		_observedMaximum = is_measured ? initial.maximum : initial.center;
+
+		const int64_t range = int64_t(logical_maximum) - int64_t(logical_minimum);
+		_restTolerance = static_cast<int32_t>(std::max<int64_t>(1, range / 1024));
+		_restRange = static_cast<int32_t>(std::max<int64_t>(1, range / 4));
+
+		_isSwept = false;
+		_previous = initial.center;
+		_stableSamples = 0;
+		_restCount = 0;
+		_restSinceUpdate = 0;
+		_restMean = 0;
+		_restM2 = 0;
+
+		publish(initial);
+		_hasLearned.store(false, std::memory_order_release);
+	}
+
+	void AxisCalibrator::learn(int32_t value)
+	{
+		bool changed = false;
+		if (value < _observedMinimum)
+		{
+			_observedMinimum = value;
+			changed = true;
+		}
+		if (value > _observedMaximum)
+		{
+			_observedMaximum = value;
+			changed = true;
+		}
+
+		// The axis is at rest if it does not move over several samples
+		const int32_t tolerance = std::max(_current.noise, _restTolerance);
+		if (std::abs(int64_t(value) - int64_t(_previous)) <= tolerance)
+			_stableSamples++;
+		else
+			_stableSamples = 0;
+		_previous = value;
+
+		bool at_rest = _stableSamples >= RestSamples && std::abs(int64_t(value) - int64_t(_current.center)) <= _restRange;
+		if (at_rest && _restCount >= MinRestSamples)
+		{
+			// Reject slow movements once the rest position is known
+			const double gate = std::max(double(_restTolerance), 4.0 * std::sqrt(_restM2 / _restCount));
+			at_rest = std::abs(value - _restMean) <= gate;
+		}
+
+		if (at_rest)
+		{
+			// Welford's update. Once the window is full, older samples
+			// decay in order to follow a drifting center.
+			if (_restCount < RestWindow)
+				_restCount++;
+			else
+				_restM2 *= double(RestWindow - 1) / double(RestWindow);
+
+			const double delta = value - _restMean;
+			_restMean += delta / _restCount;
+			_restM2 += delta * (value - _restMean);
+
+			_restSinceUpdate++;
+			if (_restCount >= MinRestSamples && _restSinceUpdate >= PublishInterval)
+				changed = true;
+		}
+
+		if (changed)
+		{
+			_restSinceUpdate = 0;
+			if (!_isSwept)
+				_isSwept = isSwept();
+
+			publish(estimate());
+			if (_isSwept)
+				_hasLearned.store(true, std::memory_order_release);
+		}
+	}
+
+	AxisCalibration AxisCalibrator::calibration() const
+	{
+		AxisCalibration calibration;
+		for (;;)
+		{
+			const uint32_t begin = _sequence.load(std::memory_order_acquire);
+			if ((begin & 1) == 0)
+			{
+				calibration.minimum = _minimum.load(std::memory_order_relaxed);
+				calibration.center = _center.load(std::memory_order_relaxed);
+				calibration.maximum = _maximum.load(std::memory_order_relaxed);
+				calibration.noise = _noise.load(std::memory_order_relaxed);
+
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (_sequence.load(std::memory_order_relaxed) == begin)
+					return calibration;
+			}
+		}
+	}
+
+	AxisCalibration AxisCalibrator::estimate() const
+	{
+		AxisCalibration calibration = _current;
+		if (_restCount >= MinRestSamples)
+		{
+			// Three standard deviations cover almost all the noise at rest
+			const double variance = _restM2 / _restCount;
+			calibration.center = static_cast<int32_t>(std::lround(_restMean));
+			calibration.noise = static_cast<int32_t>(std::ceil(3.0 * std::sqrt(variance)));
+		}
+
+		// A partially observed range would saturate the axis early. The
+		// initial range is thus only widened until the axis was swept.
+		if (_isSwept)
+		{
+			calibration.minimum = _observedMinimum;
+			calibration.maximum = _observedMaximum;
+		}
+		else
+		{
+			calibration.minimum = std::min(_initial.minimum, _observedMinimum);
+			calibration.maximum = std::max(_initial.maximum, _observedMaximum);
+		}
+
+		calibration.minimum = std::min(calibration.minimum, calibration.center);
+		calibration.maximum = std::max(calibration.maximum, calibration.center);
+
+		return calibration;
+	}
+
+	bool AxisCalibrator::isSwept() const
+	{
+		const int64_t center = _current.center;
+		const int64_t negative = (center - _initial.minimum) * SweepPercentage / 100;
+		const int64_t positive = (_initial.maximum - center) * SweepPercentage / 100;
+		return center - _observedMinimum >= negative && _observedMaximum - center >= positive;
+	}
+
+	void AxisCalibrator::publish(const AxisCalibration& calibration)
+	{
+		_current = calibration;
+		_normalization = AxisNormalization{ calibration };
+
+		const uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+		_sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		_minimum.store(calibration.minimum, std::memory_order_relaxed);
+		_center.store(calibration.center, std::memory_order_relaxed);
+		_maximum.store(calibration.maximum, std::memory_order_relaxed);
+		_noise.store(calibration.noise, std::memory_order_relaxed);
+
+		_sequence.store(sequence + 2, std::memory_order_release);
+	}
+}}
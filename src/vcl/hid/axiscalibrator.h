@@ -0,0 +1,218 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <atomic>
+#include <cstdint>
+
+namespace Vcl { namespace HID
+{
+	//! Calibration of a single axis in logical units
+	struct AxisCalibration
+	{
+		//! Minimum value
+		int32_t minimum{ 0 };
+
+		//! Rest position
+		int32_t center{ 0 };
+
+		//! Maximum value
+		int32_t maximum{ 0 };
+
+		//! Deviation from the center, which is still considered as rest position
+		int32_t noise{ 0 };
+	};
+
+	//! Scale and bias mapping logical axis values to [-1, 1]
+	struct AxisNormalization
+	{
+		AxisNormalization() = default;
+		explicit AxisNormalization(const AxisCalibration& calibration);
+
+		float operator()(int32_t value) const
+		{
+			const float offset = static_cast<float>(value) - center;
+			float normalized = 0;
+			if (offset < -deadZone)
+				normalized = (offset + deadZone) * negativeScale;
+			else if (offset > deadZone)
+				normalized = (offset - deadZone) * positiveScale;
+
+			return normalized < -1.0f ? -1.0f : (normalized > 1.0f ? 1.0f : normalized);
+		}
+
+		//! Rest position
+		float center{ 0 };
+
+		//! Values closer to the center are reported as zero
+		float deadZone{ 0 };
+
+		//! Scale of values below the center
+		float negativeScale{ 0 };
+
+		//! Scale of values above the center
+		float positiveScale{ 0 };
+	};
+
+	/*!
+	 *	Online calibration of a single axis
+	 *
+	 *	The calibrator tracks the observed range of the axis. The rest
+	 *	position is detected as a series of stable samples close to the
+	 *	center, from which center and noise floor are estimated using
+	 *	streaming statistics.
+	 *	The observed range only widens the initial range until the axis
+	 *	was moved through its full range once. Only then the observed
+	 *	range replaces the initial one and the calibration is considered
+	 *	as learned.
+	 *
+	 *	Samples are fed by a single (decoding) thread without any locking.
+	 *	Other threads read a consistent copy of the calibration through
+	 *	a sequence lock, which never blocks the writer.
+	 */
+	class AxisCalibrator
+	{
+	public:
+		//! Number of consecutive stable samples identifying the rest position
+		static const uint32_t RestSamples = 8;
+
+		//! Minimum number of rest samples before the center is updated
+		static const uint32_t MinRestSamples = 32;
+
+		//! Number of rest samples after which old samples are forgotten
+		static const uint32_t RestWindow = 1024;
+
+		//! Number of rest samples between two updates of the calibration
+		static const uint32_t PublishInterval = 64;
+
+		//! Percentage of each side of the initial range, which needs to be
+		//! covered in order to consider the axis as moved through its full range
+		static const uint32_t SweepPercentage = 90;
+
+	public:
+		AxisCalibrator() = default;
+		AxisCalibrator(const AxisCalibrator&) = delete;
+		AxisCalibrator& operator=(const AxisCalibrator&) = delete;
+
+		//! Restart the calibration
+		//! \param logical_minimum Minimum value reported by the device
+		//! \param logical_maximum Maximum value reported by the device
+		//! \param initial Initial calibration
+		//! \param is_measured Indicate whether the initial calibration was
+		//!                    measured, or only derived from the logical range
+		//! \note Must not be called concurrently to 'update'
+		void reset(int32_t logical_minimum, int32_t logical_maximum, const AxisCalibration& initial, bool is_measured);
+
+		//! Add a sample and normalize it using the updated calibration
+		float update(int32_t value) { learn(value); return _normalization(value); }
+
+		//! Add a sample without normalizing it
+		void learn(int32_t value);
+
+		//! Normalize a value without updating the calibration
+		//! \note Must not be called concurrently to 'update' or 'learn'
+		float normalize(int32_t value) const { return _normalization(value); }
+
+		//! Normalize a value using the published calibration
+		//! \note Can be called from any thread
+		float normalizePublished(int32_t value) const { return AxisNormalization{ calibration() }(value); }
+
+		//! Access the current calibration from any thread
+		AxisCalibration calibration() const;
+
+		//! \returns True, if the axis was moved through its full range and
+		//!          the calibration was refined from samples
+		bool hasLearned() const { return _hasLearned.load(std::memory_order_acquire); }
+
+	private:
+		//! Compute the calibration from the collected data
+		AxisCalibration estimate() const;
+
+		//! \returns True, if the observed range covers both sides of the initial range
+		bool isSwept() const;
+
+		//! Make a new calibration available
+		void publish(const AxisCalibration& calibration);
+
+	private:
+		//! Initial calibration
+		AxisCalibration _initial;
+
+		//! Calibration used by the writer
+		AxisCalibration _current;
+
+		//! Normalization derived from '_current'
+		AxisNormalization _normalization;
+
+		//! Observed minimum value
+		int32_t _observedMinimum{ 0 };
+
+		//! Observed maximum value
+		int32_t _observedMaximum{ 0 };
+
+		//! Indicate whether the axis was moved through its full range
+		bool _isSwept{ false };
+
+		//! Maximum change between two samples at rest
+		int32_t _restTolerance{ 1 };
+
+		//! Maximum distance of a rest sample to the center
+		int32_t _restRange{ 0 };
+
+		//! Previous sample
+		int32_t _previous{ 0 };
+
+		//! Number of consecutive stable samples
+		uint32_t _stableSamples{ 0 };
+
+		//! Number of samples in the rest statistics
+		uint32_t _restCount{ 0 };
+
+		//! Rest samples added since the last update of the calibration
+		uint32_t _restSinceUpdate{ 0 };
+
+		//! Mean of the rest samples
+		double _restMean{ 0 };
+
+		//! Sum of squared differences of the rest samples to their mean
+		double _restM2{ 0 };
+
+		//! Sequence counter of the published calibration. Odd while writing.
+		std::atomic<uint32_t> _sequence{ 0 };
+
+		//! Published calibration
+		std::atomic<int32_t> _minimum{ 0 };
+		std::atomic<int32_t> _center{ 0 };
+		std::atomic<int32_t> _maximum{ 0 };
+		std::atomic<int32_t> _noise{ 0 };
+
+		//! Indicate whether the calibration was learned and can be stored
+		std::atomic<bool> _hasLearned{ false };
+	};
+}}
@@ -0,0 +1,174 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <array>
+#include <cstdint>
+
+// VCL
+#include <vcl/core/contract.h>
+#include <vcl/hid/axiscalibrator.h>
+#include <vcl/hid/bitfield.h>
+#include <vcl/hid/units.h>
+
+namespace Vcl { namespace HID
+{
+	/*!
+	 *	States of the axes of a device
+	 *
+	 *	Axes are either stored normalized, or as raw logical values, which
+	 *	are normalized lazily when they are read or all at once when the
+	 *	set is latched. The latter keeps the decoding of high-rate devices
+	 *	free of floating point work, as most of the samples are never read.
+	 *	The online calibration learns from the values while they are
+	 *	decoded; reading and latching only apply the published calibration.
+	 *	Physical values are derived from the logical values using a
+	 *	precomputed scale per axis.
+	 *	Like the rest of the device state, the set is not synchronized.
+	 */
+	class AxisSet
+	{
+	public:
+		//! Maximum number of axes
+		static const uint32_t MaxAxes = 16;
+
+	public:
+		AxisSet()
+		{
+			_raw.fill(0);
+			_states.fill(0.0f);
+			_calibrators.fill(nullptr);
+		}
+
+		//! Store a normalized state
+		//! \param axis Index of the axis
+		//! \param raw Logical value the state was computed from
+		//! \param state Normalized state
+		void set(uint32_t axis, int32_t raw, float state)
+		{
+			VclRequire(axis < MaxAxes, "Axis index is valid.");
+
+			_raw[axis] = raw;
+			_states[axis] = state;
+			_dirty &= ~(1u << axis);
+		}
+
+		//! Store a logical value, which is normalized on demand
+		//! \param axis Index of the axis
+		//! \param raw Logical value
+		//! \param calibrator Calibration used to normalize the value
+		void setRaw(uint32_t axis, int32_t raw, const AxisCalibrator* calibrator)
+		{
+			VclRequire(axis < MaxAxes, "Axis index is valid.");
+			VclRequire(calibrator, "Calibrator is valid.");
+
+			_raw[axis] = raw;
+			_calibrators[axis] = calibrator;
+			_dirty |= 1u << axis;
+		}
+
+		//! Access the logical value of an axis
+		int32_t raw(uint32_t axis) const
+		{
+			VclRequire(axis < MaxAxes, "Axis index is valid.");
+
+			return _raw[axis];
+		}
+
+		//! Set the mapping of the logical values to physical units
+		void setPhysicalScale(uint32_t axis, const PhysicalScale& scale)
+		{
+			VclRequire(axis < MaxAxes, "Axis index is valid.");
+
+			_physical[axis] = scale;
+		}
+
+		//! Access the physical value of an axis
+		float physical(uint32_t axis) const
+		{
+			VclRequire(axis < MaxAxes, "Axis index is valid.");
+
+			return _physical[axis](_raw[axis]);
+		}
+
+		//! Access the unit of the physical value of an axis
+		PhysicalUnit unit(uint32_t axis) const
+		{
+			VclRequire(axis < MaxAxes, "Axis index is valid.");
+
+			return _physical[axis].unit;
+		}
+
+		//! Access the normalized state of an axis
+		float state(uint32_t axis) const
+		{
+			VclRequire(axis < MaxAxes, "Axis index is valid.");
+
+			if (_dirty & (1u << axis))
+				return _calibrators[axis]->normalizePublished(_raw[axis]);
+
+			return _states[axis];
+		}
+
+		//! Access the normalized state of an axis as Q15 fixed-point number
+		int16_t fixed(uint32_t axis) const
+		{
+			const float s = state(axis);
+			const float clamped = s < -1.0f ? -1.0f : (s > 1.0f ? 1.0f : s);
+			return static_cast<int16_t>(clamped * 32767.0f + (clamped < 0 ? -0.5f : 0.5f));
+		}
+
+		//! Normalize all axes stored as logical values
+		void latch()
+		{
+			for (uint32_t dirty = _dirty; dirty != 0; dirty &= dirty - 1)
+			{
+				const uint32_t axis = findFirstSet(dirty);
+				_states[axis] = _calibrators[axis]->normalizePublished(_raw[axis]);
+			}
+			_dirty = 0;
+		}
+
+	private:
+		//! Logical values
+		std::array<int32_t, MaxAxes> _raw;
+
+		//! Normalized states, valid if the axis is not dirty
+		std::array<float, MaxAxes> _states;
+
+		//! Mapping of the logical values to physical units
+		std::array<PhysicalScale, MaxAxes> _physical;
+
+		//! Calibrations normalizing the dirty axes
+		std::array<const AxisCalibrator*, MaxAxes> _calibrators;
+
+		//! Axes which still need to be normalized
+		uint32_t _dirty{ 0 };
+	};
+}}
@@ -0,0 +1,135 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <cstdint>
+#include <cstring>
+
+// GSL
+#include <gsl/gsl>
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#endif
+#if defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__))
+#	include <immintrin.h>
+#	define VCL_HID_BMI2
+#endif
+
+namespace Vcl { namespace HID
+{
+	//! Index of the lowest set bit
+	//! \param word Non-zero bit pattern
+	inline uint32_t findFirstSet(uint64_t word)
+	{
+#if defined(_MSC_VER) && defined(_WIN64)
+		unsigned long idx;
+		_BitScanForward64(&idx, word);
+		return idx;
+#elif defined(_MSC_VER)
+		unsigned long idx;
+		if (_BitScanForward(&idx, static_cast<unsigned long>(word)))
+			return idx;
+		_BitScanForward(&idx, static_cast<unsigned long>(word >> 32));
+		return idx + 32;
+#else
+		return static_cast<uint32_t>(__builtin_ctzll(word));
+#endif
+	}
+
+	//! Number of set bits
+	inline uint32_t countSet(uint64_t word)
+	{
+#if defined(_MSC_VER)
+		word = word - ((word >> 1) & 0x5555555555555555ull);
+		word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+		word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0full;
+		return static_cast<uint32_t>((word * 0x0101010101010101ull) >> 56);
+#else
+		return static_cast<uint32_t>(__builtin_popcountll(word));
+#endif
+	}
+
+	//! Load 8 bytes of a report in little-endian order
+	//! \param data Report data
+	//! \param byte_offset Position of the first byte
+	//! \returns The loaded bytes. Bytes beyond the end of the report are zero.
+	inline uint64_t load64le(gsl::span<const uint8_t> data, size_t byte_offset)
+	{
+		const size_t size = static_cast<size_t>(data.size());
+		if (byte_offset >= size)
+			return 0;
+
+		uint8_t bytes[8] = {};
+		if (size - byte_offset >= 8)
+			std::memcpy(bytes, data.data() + byte_offset, 8);
+		else
+			std::memcpy(bytes, data.data() + byte_offset, size - byte_offset);
+
+		return
+			(uint64_t(bytes[0])      ) | (uint64_t(bytes[1]) <<  8) |
+			(uint64_t(bytes[2]) << 16) | (uint64_t(bytes[3]) << 24) |
+			(uint64_t(bytes[4]) << 32) | (uint64_t(bytes[5]) << 40) |
+			(uint64_t(bytes[6]) << 48) | (uint64_t(bytes[7]) << 56);
+	}
+
+	//! Gather the bits selected by a mask into the low bits of the result
+	inline uint64_t extractBits(uint64_t value, uint64_t mask)
+	{
+#ifdef VCL_HID_BMI2
+		return _pext_u64(value, mask);
+#else
+		// Process runs of consecutive mask bits at once
+		uint64_t result = 0;
+		uint32_t position = 0;
+		while (mask != 0)
+		{
+			const uint32_t start = findFirstSet(mask);
+			const uint64_t shifted = ~(mask >> start);
+			const uint32_t length = shifted == 0 ? 64 : findFirstSet(shifted);
+			const uint64_t run = length >= 64 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << length) - 1;
+
+			result |= ((value >> start) & run) << position;
+			position += length;
+			mask &= ~(run << start);
+		}
+		return result;
+#endif
+	}
+
+	//! Read a bit field of a report
+	//! \param data Report data
+	//! \param bit_offset Position of the first bit
+	//! \param bit_count Number of bits, at most 57
+	inline uint64_t readBits(gsl::span<const uint8_t> data, size_t bit_offset, uint32_t bit_count)
+	{
+		const uint64_t word = load64le(data, bit_offset / 8) >> (bit_offset % 8);
+		return bit_count >= 64 ? word : word & ((uint64_t{ 1 } << bit_count) - 1);
+	}
+}}
@@ -0,0 +1,264 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+// GSL
+#include <gsl/gsl>
+
+// VCL
+#include <vcl/core/contract.h>
+#include <vcl/hid/bitfield.h>
+
+namespace Vcl { namespace HID
+{
+	/*!
+	 *	Set of button states
+	 *
+	 *	The states are stored as bitmap, one bit per button. Sets are
+	 *	compared word-wise and iterating visits only the set bits.
+	 */
+	class ButtonSet
+	{
+	public:
+		using Word = uint64_t;
+
+		//! Number of buttons stored in a word
+		static const uint32_t BitsPerWord = 64;
+
+		//! Forward iterator over the indices of the set bits
+		class Iterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = uint32_t;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const uint32_t*;
+			using reference = uint32_t;
+
+			Iterator(const Word* words, uint32_t nr_words, uint32_t word_idx)
+			: _words(words), _nrWords(nr_words), _wordIdx(word_idx)
+			{
+				_current = _wordIdx < _nrWords ? _words[_wordIdx] : 0;
+				skipEmpty();
+			}
+
+			uint32_t operator*() const { return _wordIdx * BitsPerWord + findFirstSet(_current); }
+
+			Iterator& operator++()
+			{
+				// Clear the lowest set bit
+				_current &= _current - 1;
+				skipEmpty();
+				return *this;
+			}
+			Iterator operator++(int)
+			{
+				Iterator it = *this;
+				++(*this);
+				return it;
+			}
+
+			bool operator==(const Iterator& other) const { return _wordIdx == other._wordIdx && _current == other._current; }
+			bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+		private:
+			void skipEmpty()
+			{
+				while (_current == 0 && _wordIdx < _nrWords)
+				{
+					if (++_wordIdx < _nrWords)
+						_current = _words[_wordIdx];
+				}
+			}
+
+			//! Words of the set
+			const Word* _words;
+
+			//! Number of words in the set
+			uint32_t _nrWords;
+
+			//! Current word
+			uint32_t _wordIdx;
+
+			//! Bits of the current word not yet visited
+			Word _current{ 0 };
+		};
+
+	public:
+		ButtonSet() = default;
+		explicit ButtonSet(uint32_t size) { resize(size); }
+
+		//! \returns The number of buttons in the set
+		uint32_t size() const { return _size; }
+
+		//! Change the number of buttons. Clears all the states.
+		void resize(uint32_t size)
+		{
+			_size = size;
+			_words.assign((size + BitsPerWord - 1) / BitsPerWord, 0);
+		}
+
+		//! Clear all the states
+		void clear() { std::fill(_words.begin(), _words.end(), Word{ 0 }); }
+
+		//! \returns The state of a button
+		bool test(uint32_t idx) const
+		{
+			VclRequire(idx < _size, "Button index is valid.");
+			return (_words[idx / BitsPerWord] >> (idx % BitsPerWord)) & 1;
+		}
+
+		//! Set the state of a button
+		void set(uint32_t idx, bool state = true)
+		{
+			VclRequire(idx < _size, "Button index is valid.");
+			const Word mask = Word{ 1 } << (idx % BitsPerWord);
+			if (state)
+				_words[idx / BitsPerWord] |= mask;
+			else
+				_words[idx / BitsPerWord] &= ~mask;
+		}
+
+		//! Replace the states of a complete word
+		//! \note Bits beyond 'size()' are ignored
+		void setWord(uint32_t word_idx, Word bits)
+		{
+			VclRequire(word_idx < _words.size(), "Word index is valid.");
+			_words[word_idx] = bits & validBits(word_idx);
+		}
+
+		//! Replace the states of a range of buttons
+		//! \param first Index of the first button
+		//! \param count Number of buttons, at most 64
+		//! \param bits New states, starting at the lowest bit
+		void setBits(uint32_t first, uint32_t count, Word bits)
+		{
+			VclRequire(count <= BitsPerWord && first + count <= _size, "Range is valid.");
+			if (count == 0)
+				return;
+
+			const Word mask = count == BitsPerWord ? ~Word{ 0 } : (Word{ 1 } << count) - 1;
+			bits &= mask;
+
+			const uint32_t word_idx = first / BitsPerWord;
+			const uint32_t shift = first % BitsPerWord;
+			_words[word_idx] = (_words[word_idx] & ~(mask << shift)) | (bits << shift);
+			if (shift + count > BitsPerWord)
+			{
+				const uint32_t spill = BitsPerWord - shift;
+				_words[word_idx + 1] = (_words[word_idx + 1] & ~(mask >> spill)) | (bits >> spill);
+			}
+		}
+
+		//! \returns True, if any button is set
+		bool any() const
+		{
+			for (const auto word : _words)
+				if (word != 0)
+					return true;
+			return false;
+		}
+
+		//! \returns True, if no button is set
+		bool none() const { return !any(); }
+
+		//! \returns The number of set buttons
+		uint32_t count() const
+		{
+			uint32_t nr_set = 0;
+			for (const auto word : _words)
+				nr_set += countSet(word);
+			return nr_set;
+		}
+
+		//! Access the underlying words
+		gsl::span<const Word> words() const { return { _words.data(), static_cast<std::ptrdiff_t>(_words.size()) }; }
+
+		//! Iterate over the indices of the set buttons
+		Iterator begin() const { return { _words.data(), static_cast<uint32_t>(_words.size()), 0 }; }
+		Iterator end() const { return { _words.data(), static_cast<uint32_t>(_words.size()), static_cast<uint32_t>(_words.size()) }; }
+
+		/*!
+		 *	Update the states and compute the changed buttons
+		 *
+		 *	\param states New states, must be of the same size
+		 *	\param pressed Buttons which changed from released to pressed
+		 *	\param released Buttons which changed from pressed to released
+		 *	\param accumulate Merge the changes with the edges already stored
+		 *	                  in 'pressed' and 'released', instead of replacing them
+		 */
+		void update(const ButtonSet& states, ButtonSet& pressed, ButtonSet& released, bool accumulate = false)
+		{
+			VclRequire(states._size == _size, "Sizes match.");
+			VclRequire(pressed._size == _size && released._size == _size, "Sizes match.");
+
+			const size_t nr_words = _words.size();
+			for (size_t i = 0; i < nr_words; i++)
+			{
+				const Word previous = _words[i];
+				const Word current = states._words[i];
+				const Word changed = previous ^ current;
+
+				if (accumulate)
+				{
+					pressed._words[i]  |= changed & current;
+					released._words[i] |= changed & previous;
+				}
+				else
+				{
+					pressed._words[i]  = changed & current;
+					released._words[i] = changed & previous;
+				}
+				_words[i] = current;
+			}
+		}
+
+		bool operator==(const ButtonSet& other) const { return _size == other._size && _words == other._words; }
+		bool operator!=(const ButtonSet& other) const { return !(*this == other); }
+
+	private:
+		//! Mask of the bits of a word which belong to the set
+		Word validBits(uint32_t word_idx) const
+		{
+			const uint32_t remaining = _size - word_idx * BitsPerWord;
+			return remaining >= BitsPerWord ? ~Word{ 0 } : (Word{ 1 } << remaining) - 1;
+		}
+
+		//! Number of buttons
+		uint32_t _size{ 0 };
+
+		//! Button states
+		std::vector<Word> _words;
+	};
+}}
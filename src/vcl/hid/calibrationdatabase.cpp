@@ -0,0 +1,504 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "calibrationdatabase.h"
+
+// C++ Standard library
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+// Platform API
+#ifdef _WIN32
+#	define WIN32_LEAN_AND_MEAN
+#	include <Windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+namespace
+{
+	//! File identification
+	const char Magic[4] = { 'V', 'H', 'C', 'D' };
+
+	//! File format version
+	const uint32_t Version = 1;
+
+	//! Maximum number of displacements tried per bucket
+	const uint32_t MaxDisplacement = 1u << 20;
+
+	//! Entry flag: the calibration values are valid
+	const uint32_t EntryCalibrated = 0x1;
+
+	//! Entry flags: the upper half stores the noise floor
+	const uint32_t EntryNoiseShift = 16;
+
+	//! File header
+	struct Header
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t nrEntries;
+		uint32_t nrBuckets;
+		uint32_t namesSize;
+		uint32_t reserved;
+	};
+
+	//! Stored record
+	struct Entry
+	{
+		uint64_t key;
+		int32_t minimum;
+		int32_t center;
+		int32_t maximum;
+		uint32_t flags;
+		uint32_t nameOffset;
+		uint32_t nameLength;
+	};
+	static_assert(sizeof(Header) == 24, "Header layout is part of the file format");
+	static_assert(sizeof(Entry) == 32, "Entry layout is part of the file format");
+
+	uint64_t packKey(const Vcl::HID::CalibrationKey& key)
+	{
+		return (uint64_t(key.vendorId) << 48) | (uint64_t(key.productId) << 32) |
+		       (uint64_t(key.usagePage) << 16) | uint64_t(key.usage);
+	}
+
+	Vcl::HID::CalibrationKey unpackKey(uint64_t key)
+	{
+		return {
+			static_cast<uint16_t>(key >> 48), static_cast<uint16_t>(key >> 32),
+			static_cast<uint16_t>(key >> 16), static_cast<uint16_t>(key)
+		};
+	}
+
+	//! Seeded 64-bit mixing function (MurmurHash3 finalizer)
+	uint64_t hash(uint64_t key, uint64_t seed)
+	{
+		key ^= seed * 0x9e3779b97f4a7c15ull;
+		key ^= key >> 33;
+		key *= 0xff51afd7ed558ccdull;
+		key ^= key >> 33;
+		key *= 0xc4ceb9fe1a85ec53ull;
+		key ^= key >> 33;
+		return key;
+	}
+
+	//! Offset of the displacement table
+	size_t displacementOffset()
+	{
+		return sizeof(Header);
+	}
+
+	//! Offset of the entry table (8 byte aligned)
+	size_t entryOffset(uint32_t nr_buckets)
+	{
+		return (sizeof(Header) + nr_buckets * sizeof(uint32_t) + 7) & ~size_t(7);
+	}
+
+	//! Offset of the name table
+	size_t nameOffset(uint32_t nr_buckets, uint32_t nr_entries)
+	{
+		return entryOffset(nr_buckets) + nr_entries * sizeof(Entry);
+	}
+
+	//! Compute the displacements of a minimal perfect hash (hash and displace)
+	//! \returns True, if a perfect hash was found
+	bool buildPerfectHash(const std::vector<uint64_t>& keys, uint32_t nr_buckets, std::vector<uint32_t>& displacements, std::vector<uint32_t>& slots)
+	{
+		const auto nr_keys = static_cast<uint32_t>(keys.size());
+
+		std::vector<std::vector<uint32_t>> buckets(nr_buckets);
+		for (uint32_t i = 0; i < nr_keys; i++)
+			buckets[hash(keys[i], 0) % nr_buckets].push_back(i);
+
+		// Place the largest buckets first
+		std::vector<uint32_t> order(nr_buckets);
+		for (uint32_t b = 0; b < nr_buckets; b++)
+			order[b] = b;
+		std::stable_sort(order.begin(), order.end(), [&buckets](uint32_t a, uint32_t b)
+		{
+			return buckets[a].size() > buckets[b].size();
+		});
+
+		displacements.assign(nr_buckets, 0);
+		slots.assign(nr_keys, 0);
+		std::vector<bool> occupied(nr_keys, false);
+		std::vector<uint32_t> candidates;
+		for (const auto b : order)
+		{
+			const auto& bucket = buckets[b];
+			if (bucket.empty())
+				break;
+
+			bool placed = false;
+			for (uint32_t d = 1; d < MaxDisplacement && !placed; d++)
+			{
+				candidates.clear();
+				placed = true;
+				for (const auto k : bucket)
+				{
+					const auto slot = static_cast<uint32_t>(hash(keys[k], d) % nr_keys);
+					if (occupied[slot] || std::find(candidates.begin(), candidates.end(), slot) != candidates.end())
+					{
+						placed = false;
+						break;
+					}
+					candidates.push_back(slot);
+				}
+
+				if (placed)
+				{
+					displacements[b] = d;
+					for (size_t i = 0; i < bucket.size(); i++)
+					{
+						occupied[candidates[i]] = true;
+						slots[bucket[i]] = candidates[i];
+					}
+				}
+			}
+
+			if (!placed)
+				return false;
+		}
+
+		return true;
+	}
+}
+
+namespace Vcl { namespace HID
+{
+	CalibrationDatabase::CalibrationDatabase(CalibrationDatabase&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	CalibrationDatabase::~CalibrationDatabase()
+	{
+		close();
+	}
+
+	CalibrationDatabase& CalibrationDatabase::operator=(CalibrationDatabase&& other) noexcept
+	{
+		if (this != &other)
+		{
+			close();
+			_data = other._data;
+			_size = other._size;
+			_image = std::move(other._image);
+			_file = other._file;
+			_mapping = other._mapping;
+
+			other._data = nullptr;
+			other._size = 0;
+			other._file = nullptr;
+			other._mapping = nullptr;
+		}
+		return *this;
+	}
+
+	bool CalibrationDatabase::open(const std::string& path)
+	{
+		close();
+
+#ifdef _WIN32
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER file_size;
+		if (GetFileSizeEx(file, &file_size) == FALSE || file_size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		_file = file;
+		_mapping = mapping;
+		_data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		_size = static_cast<size_t>(file_size.QuadPart);
+#else
+		const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (file < 0)
+			return false;
+
+		struct stat file_info;
+		if (fstat(file, &file_info) != 0 || file_info.st_size == 0)
+		{
+			::close(file);
+			return false;
+		}
+
+		// The mapping stays valid after closing the file
+		void* data = mmap(nullptr, static_cast<size_t>(file_info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		::close(file);
+		if (data == MAP_FAILED)
+			return false;
+
+		_data = static_cast<const uint8_t*>(data);
+		_size = static_cast<size_t>(file_info.st_size);
+#endif
+
+		if (!_data || !validate())
+		{
+			close();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool CalibrationDatabase::load(std::vector<uint8_t> image)
+	{
+		close();
+
+		_image = std::move(image);
+		_data = _image.data();
+		_size = _image.size();
+		if (!validate())
+		{
+			close();
+			return false;
+		}
+
+		return true;
+	}
+
+	void CalibrationDatabase::close()
+	{
+		if (_data && _image.empty())
+		{
+#ifdef _WIN32
+			UnmapViewOfFile(_data);
+#else
+			munmap(const_cast<uint8_t*>(_data), _size);
+#endif
+		}
+
+#ifdef _WIN32
+		if (_mapping)
+			CloseHandle(_mapping);
+		if (_file)
+			CloseHandle(_file);
+#endif
+
+		_data = nullptr;
+		_size = 0;
+		_image.clear();
+		_file = nullptr;
+		_mapping = nullptr;
+	}
+
+	bool CalibrationDatabase::validate()
+	{
+		if (_size < sizeof(Header))
+			return false;
+
+		Header header;
+		std::memcpy(&header, _data, sizeof(Header));
+		if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version)
+			return false;
+
+		if (header.nrEntries > 0 && header.nrBuckets == 0)
+			return false;
+
+		const uint64_t required_size = uint64_t(nameOffset(header.nrBuckets, header.nrEntries)) + header.namesSize;
+		return required_size <= _size;
+	}
+
+	size_t CalibrationDatabase::size() const
+	{
+		if (!_data)
+			return 0;
+
+		Header header;
+		std::memcpy(&header, _data, sizeof(Header));
+		return header.nrEntries;
+	}
+
+	CalibrationRecord CalibrationDatabase::record(size_t idx) const
+	{
+		Header header;
+		std::memcpy(&header, _data, sizeof(Header));
+
+		Entry entry;
+		std::memcpy(&entry, _data + entryOffset(header.nrBuckets) + idx * sizeof(Entry), sizeof(Entry));
+
+		CalibrationRecord record;
+		record.key = unpackKey(entry.key);
+		record.isCalibrated = (entry.flags & EntryCalibrated) != 0;
+		record.minimum = entry.minimum;
+		record.center = entry.center;
+		record.maximum = entry.maximum;
+		record.noise = static_cast<int32_t>(entry.flags >> EntryNoiseShift);
+		if (uint64_t(entry.nameOffset) + entry.nameLength <= header.namesSize)
+		{
+			const auto names = reinterpret_cast<const char*>(_data + nameOffset(header.nrBuckets, header.nrEntries));
+			record.name = std::string_view{ names + entry.nameOffset, entry.nameLength };
+		}
+
+		return record;
+	}
+
+	bool CalibrationDatabase::find(const CalibrationKey& key, CalibrationRecord& record) const
+	{
+		if (!_data)
+			return false;
+
+		Header header;
+		std::memcpy(&header, _data, sizeof(Header));
+		if (header.nrEntries == 0)
+			return false;
+
+		const uint64_t packed_key = packKey(key);
+		const uint32_t bucket = static_cast<uint32_t>(hash(packed_key, 0) % header.nrBuckets);
+
+		uint32_t displacement;
+		std::memcpy(&displacement, _data + displacementOffset() + bucket * sizeof(uint32_t), sizeof(uint32_t));
+
+		const size_t slot = static_cast<size_t>(hash(packed_key, displacement) % header.nrEntries);
+		uint64_t stored_key;
+		std::memcpy(&stored_key, _data + entryOffset(header.nrBuckets) + slot * sizeof(Entry), sizeof(uint64_t));
+		if (stored_key != packed_key)
+			return false;
+
+		record = this->record(slot);
+		return true;
+	}
+
+	bool CalibrationDatabase::contains(uint16_t vendor_id, uint16_t product_id) const
+	{
+		CalibrationRecord record;
+		return find({ vendor_id, product_id, 0, 0 }, record);
+	}
+
+	CalibrationDatabaseBuilder::CalibrationDatabaseBuilder(const CalibrationDatabase& database)
+	{
+		for (size_t i = 0; i < database.size(); i++)
+			add(database.record(i));
+	}
+
+	void CalibrationDatabaseBuilder::addDevice(uint16_t vendor_id, uint16_t product_id)
+	{
+		CalibrationRecord record;
+		record.key = { vendor_id, product_id, 0, 0 };
+		add(record);
+	}
+
+	void CalibrationDatabaseBuilder::add(const CalibrationRecord& record)
+	{
+		auto& entry = _records[packKey(record.key)];
+		entry.key = record.key;
+		entry.isCalibrated = record.isCalibrated;
+		entry.minimum = record.minimum;
+		entry.center = record.center;
+		entry.maximum = record.maximum;
+		entry.noise = record.noise;
+		entry.name.assign(record.name.data(), record.name.size());
+	}
+
+	std::vector<uint8_t> CalibrationDatabaseBuilder::serialize() const
+	{
+		std::vector<uint64_t> keys;
+		keys.reserve(_records.size());
+		for (const auto& record : _records)
+			keys.push_back(record.first);
+
+		// Grow the bucket table until a perfect hash is found
+		std::vector<uint32_t> displacements;
+		std::vector<uint32_t> slots;
+		uint32_t nr_buckets = static_cast<uint32_t>(keys.size() / 2 + 1);
+		while (!buildPerfectHash(keys, nr_buckets, displacements, slots))
+			nr_buckets *= 2;
+
+		Header header = {};
+		std::memcpy(header.magic, Magic, sizeof(Magic));
+		header.version = Version;
+		header.nrEntries = static_cast<uint32_t>(keys.size());
+		header.nrBuckets = nr_buckets;
+
+		std::vector<Entry> entries(keys.size());
+		std::string names;
+		size_t k = 0;
+		for (const auto& record : _records)
+		{
+			auto& entry = entries[slots[k++]];
+			entry.key = record.first;
+			entry.minimum = record.second.minimum;
+			entry.center = record.second.center;
+			entry.maximum = record.second.maximum;
+			const auto noise = static_cast<uint32_t>(record.second.noise < 0 ? 0 : record.second.noise > 0xffff ? 0xffff : record.second.noise);
+			entry.flags = (record.second.isCalibrated ? EntryCalibrated : 0) | (noise << EntryNoiseShift);
+			entry.nameOffset = static_cast<uint32_t>(names.size());
+			entry.nameLength = static_cast<uint32_t>(record.second.name.size());
+			names += record.second.name;
+		}
+		header.namesSize = static_cast<uint32_t>(names.size());
+
+		std::vector<uint8_t> image(nameOffset(header.nrBuckets, header.nrEntries) + names.size(), 0);
+		std::memcpy(image.data(), &header, sizeof(Header));
+		std::memcpy(image.data() + displacementOffset(), displacements.data(), displacements.size() * sizeof(uint32_t));
+		if (!entries.empty())
+			std::memcpy(image.data() + entryOffset(header.nrBuckets), entries.data(), entries.size() * sizeof(Entry));
+		if (!names.empty())
+			std::memcpy(image.data() + nameOffset(header.nrBuckets, header.nrEntries), names.data(), names.size());
+
+		return image;
+	}
+
+	bool CalibrationDatabaseBuilder::write(const std::string& path) const
+	{
+		const auto image = serialize();
+
+		// Write to a temporary file first in order to never leave
+		// a partially written database behind
+		const std::string tmp_path = path + ".tmp";
+		{
+			std::ofstream file{ tmp_path, std::ios::binary | std::ios::trunc };
+			if (!file)
+				return false;
+
+			file.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+			if (!file)
+				return false;
+		}
+
+#ifdef _WIN32
+		return MoveFileExA(tmp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE;
+#else
+		return std::rename(tmp_path.c_str(), path.c_str()) == 0;
+#endif
+	}
+}}
@@ -0,0 +1,224 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// VCL
+#include <vcl/hid/epoch.h>
+
+namespace Vcl { namespace HID
+{
+	//! Identification of a device object (axis or button)
+	struct CalibrationKey
+	{
+		//! Vendor ID of the device
+		uint16_t vendorId;
+
+		//! Product ID of the device
+		uint16_t productId;
+
+		//! Usage page of the object. Zero identifies the device itself.
+		uint16_t usagePage;
+
+		//! Usage of the object
+		uint16_t usage;
+	};
+
+	//! Calibration and naming data of a single device object
+	struct CalibrationRecord
+	{
+		//! Associated device object
+		CalibrationKey key;
+
+		//! Indicate whether the calibration values are valid
+		bool isCalibrated{ false };
+
+		//! Calibrated minimum value
+		int32_t minimum{ 0 };
+
+		//! Calibrated center value
+		int32_t center{ 0 };
+
+		//! Calibrated maximum value
+		int32_t maximum{ 0 };
+
+		//! Noise around the center, which is considered as rest position
+		int32_t noise{ 0 };
+
+		//! Name of the object (UTF-8)
+		std::string_view name;
+	};
+
+	/*!
+	 *	Read-only database of device calibrations
+	 *
+	 *	The database is a compact binary file, which is memory mapped and
+	 *	accessed through a minimal perfect hash. Lookups do not allocate
+	 *	and do not cause any system calls.
+	 *	Files are stored in the native byte order and are not meant to be
+	 *	exchanged between machines. Files of a different byte order fail
+	 *	the validation and are treated like a missing database.
+	 */
+	class CalibrationDatabase
+	{
+	public:
+		CalibrationDatabase() = default;
+		CalibrationDatabase(CalibrationDatabase&& other) noexcept;
+		~CalibrationDatabase();
+
+		CalibrationDatabase(const CalibrationDatabase&) = delete;
+		CalibrationDatabase& operator=(const CalibrationDatabase&) = delete;
+		CalibrationDatabase& operator=(CalibrationDatabase&& other) noexcept;
+
+		//! Memory map a database file
+		//! \returns True, if the file was mapped and is valid
+		bool open(const std::string& path);
+
+		//! Use an in-memory database image
+		//! \returns True, if the image is valid
+		bool load(std::vector<uint8_t> image);
+
+		//! Release the database
+		void close();
+
+		//! \returns True, if the database is valid
+		bool isOpen() const { return _data != nullptr; }
+
+		//! \returns The number of records in the database
+		size_t size() const;
+
+		//! Access a record by index
+		CalibrationRecord record(size_t idx) const;
+
+		//! Look up a record
+		//! \param key Identification of the device object
+		//! \param record Found record
+		//! \returns True, if the record was found
+		bool find(const CalibrationKey& key, CalibrationRecord& record) const;
+
+		//! \returns True, if the database contains data of the device
+		bool contains(uint16_t vendor_id, uint16_t product_id) const;
+
+	private:
+		//! Validate the mapped database
+		bool validate();
+
+		//! Start of the database
+		const uint8_t* _data{ nullptr };
+
+		//! Size of the database
+		size_t _size{ 0 };
+
+		//! Database image if it is not memory mapped
+		std::vector<uint8_t> _image;
+
+		//! Platform specific handle of the mapped file
+		void* _file{ nullptr };
+
+		//! Platform specific handle of the file mapping
+		void* _mapping{ nullptr };
+	};
+
+	/*!
+	 *	Calibration database pinned for reading
+	 *
+	 *	The database stays valid while the view is alive, even if its
+	 *	owner replaces it in the meantime.
+	 */
+	class CalibrationView
+	{
+	public:
+		CalibrationView(EpochDomain::Guard guard, const CalibrationDatabase* database)
+		: _guard(std::move(guard))
+		, _database(database)
+		{
+		}
+
+		const CalibrationDatabase& operator*() const { return *_database; }
+		const CalibrationDatabase* operator->() const { return _database; }
+
+	private:
+		//! Epoch pinned while the database is accessed
+		EpochDomain::Guard _guard;
+
+		//! Viewed database
+		const CalibrationDatabase* _database;
+	};
+
+	/*!
+	 *	Collect calibration records and write calibration databases
+	 */
+	class CalibrationDatabaseBuilder
+	{
+	public:
+		CalibrationDatabaseBuilder() = default;
+
+		//! Start with the records of an existing database
+		explicit CalibrationDatabaseBuilder(const CalibrationDatabase& database);
+
+		//! Mark a device as known, even if it does not have any records
+		void addDevice(uint16_t vendor_id, uint16_t product_id);
+
+		//! Add or replace a record
+		void add(const CalibrationRecord& record);
+
+		//! \returns The number of records
+		size_t size() const { return _records.size(); }
+
+		//! Create the binary database image
+		std::vector<uint8_t> serialize() const;
+
+		//! Write the database to a file
+		//! The file is replaced atomically where the platform supports it.
+		//! \note On Windows, a mapped database must be closed before
+		//!       it can be replaced.
+		//! \returns True, if the file was written
+		bool write(const std::string& path) const;
+
+	private:
+		//! Record owning its name
+		struct Record
+		{
+			CalibrationKey key;
+			bool isCalibrated;
+			int32_t minimum;
+			int32_t center;
+			int32_t maximum;
+			int32_t noise;
+			std::string name;
+		};
+
+		//! Records ordered by their key
+		std::map<uint64_t, Record> _records;
+	};
+}}
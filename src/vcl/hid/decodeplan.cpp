@@ -0,0 +1,229 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "decodeplan.h"
+
+// C++ Standard library
+#include <algorithm>
+
+// VCL
+#include <vcl/hid/bitfield.h>
+
+namespace Vcl { namespace HID
+{
+	uint64_t layoutHash(gsl::span<const ButtonLocation> buttons, gsl::span<const ValueLocation> values)
+	{
+		// FNV-1a over the fields in the order of the reports
+		uint64_t hash = 0xcbf29ce484222325ull;
+		const auto combine = [&hash](uint32_t value)
+		{
+			for (int i = 0; i < 4; i++)
+			{
+				hash ^= (value >> (8 * i)) & 0xff;
+				hash *= 0x100000001b3ull;
+			}
+		};
+
+		combine(static_cast<uint32_t>(buttons.size()));
+		for (const auto idx : reportOrder(buttons))
+		{
+			const auto& button = buttons[idx];
+			combine(button.reportId);
+			combine(button.bit);
+		}
+
+		combine(static_cast<uint32_t>(values.size()));
+		for (const auto idx : reportOrder(values))
+		{
+			const auto& value = values[idx];
+			combine(value.reportId);
+			combine(value.bit);
+			combine(value.bitSize | (value.isSigned ? 0x100u : 0u));
+		}
+
+		return hash;
+	}
+
+	DecodePlan::DecodePlan(gsl::span<const ButtonLocation> buttons, gsl::span<const ValueLocation> values)
+	: _nrButtons(static_cast<uint32_t>(buttons.size()))
+	, _nrValues(static_cast<uint32_t>(values.size()))
+	{
+		// Extend a segment as long as the buttons are stored in increasing
+		// order within the 64 bits following the first button of the segment
+		ButtonSegment segment = {};
+		uint32_t last_bit = 0;
+		for (uint32_t i = 0; i < _nrButtons; i++)
+		{
+			const auto& location = buttons[i];
+			const bool fits =
+				segment.count > 0 &&
+				segment.reportId == location.reportId &&
+				location.bit > last_bit &&
+				location.bit < segment.byteOffset * 8 + 64;
+
+			if (!fits)
+			{
+				if (segment.count > 0)
+					addSegment(segment);
+
+				segment.reportId = location.reportId;
+				segment.byteOffset = location.bit / 8;
+				segment.mask = 0;
+				segment.first = i;
+				segment.count = 0;
+			}
+
+			segment.mask |= uint64_t{ 1 } << (location.bit - segment.byteOffset * 8);
+			segment.count++;
+			last_bit = location.bit;
+		}
+
+		if (segment.count > 0)
+			addSegment(segment);
+
+		// Values are read with a single load starting at the byte containing the first bit
+		_valueFields.reserve(_nrValues);
+		for (uint32_t i = 0; i < _nrValues; i++)
+		{
+			const auto& location = values[i];
+			VclRequire(location.bitSize > 0 && location.bitSize <= 32, "Value fits into 32 bits.");
+
+			ValueField field;
+			field.reportId = location.reportId;
+			field.byteOffset = location.bit / 8;
+			field.shift = location.bit % 8;
+			field.bitSize = location.bitSize;
+			field.isSigned = location.isSigned;
+			field.index = i;
+			_valueFields.push_back(field);
+		}
+
+		buildReportIndex();
+	}
+
+	void DecodePlan::buildReportIndex()
+	{
+		// Group the fields by report, keeping the order within a report
+		std::stable_sort(_buttonSegments.begin(), _buttonSegments.end(), [](const ButtonSegment& a, const ButtonSegment& b)
+		{
+			return a.reportId < b.reportId;
+		});
+		std::stable_sort(_valueFields.begin(), _valueFields.end(), [](const ValueField& a, const ValueField& b)
+		{
+			return a.reportId < b.reportId;
+		});
+
+		const uint32_t nr_segments = static_cast<uint32_t>(_buttonSegments.size());
+		const uint32_t nr_fields = static_cast<uint32_t>(_valueFields.size());
+
+		uint32_t segment = 0;
+		uint32_t field = 0;
+		while (segment < nr_segments || field < nr_fields)
+		{
+			const uint32_t segment_id = segment < nr_segments ? _buttonSegments[segment].reportId : 0x100;
+			const uint32_t field_id = field < nr_fields ? _valueFields[field].reportId : 0x100;
+			const uint8_t report_id = static_cast<uint8_t>(segment_id < field_id ? segment_id : field_id);
+
+			ReportEntry report = { segment, 0, field, 0 };
+			for (; segment < nr_segments && _buttonSegments[segment].reportId == report_id; segment++)
+				report.nrSegments++;
+			for (; field < nr_fields && _valueFields[field].reportId == report_id; field++)
+				report.nrValues++;
+
+			_reports.push_back(report);
+			_reportIndex[report_id] = static_cast<uint16_t>(_reports.size());
+		}
+	}
+
+	void DecodePlan::addSegment(ButtonSegment segment)
+	{
+		// Contiguous buttons are extracted with a shift
+		segment.shift = findFirstSet(segment.mask);
+		segment.isContiguous = ((segment.mask >> segment.shift) & ((segment.mask >> segment.shift) + 1)) == 0;
+
+		_buttonSegments.push_back(segment);
+	}
+
+	bool DecodePlan::decodeButtons(gsl::span<const uint8_t> report, ButtonSet& buttons) const
+	{
+		VclRequire(buttons.size() >= _nrButtons, "Button set can store all buttons.");
+
+		if (report.empty())
+			return false;
+
+		const auto segments = fields(report[0]).buttons;
+		for (const auto& segment : segments)
+		{
+			const uint64_t word = load64le(report, segment.byteOffset);
+			const uint64_t bits = segment.isContiguous ? word >> segment.shift : extractBits(word, segment.mask);
+			buttons.setBits(segment.first, segment.count, bits);
+		}
+
+		return !segments.empty();
+	}
+
+	bool DecodePlan::buttonsDiffer(gsl::span<const uint8_t> report, gsl::span<const uint8_t> previous) const
+	{
+		VclRequire(!report.empty() && !previous.empty() && report[0] == previous[0], "Reports have the same report ID.");
+
+		for (const auto& segment : fields(report[0]).buttons)
+		{
+			const uint64_t changed = load64le(report, segment.byteOffset) ^ load64le(previous, segment.byteOffset);
+			if (changed & segment.mask)
+				return true;
+		}
+
+		return false;
+	}
+
+	int32_t DecodePlan::readValue(gsl::span<const uint8_t> report, const ValueField& field)
+	{
+		const uint64_t word = load64le(report, field.byteOffset) >> field.shift;
+		const uint64_t value = word & ((uint64_t{ 1 } << field.bitSize) - 1);
+		if (field.isSigned)
+		{
+			// Sign extend the value
+			const uint64_t sign = uint64_t{ 1 } << (field.bitSize - 1);
+			return static_cast<int32_t>(static_cast<int64_t>(value ^ sign) - static_cast<int64_t>(sign));
+		}
+
+		return static_cast<int32_t>(value);
+	}
+
+	size_t DecodePlan::decodeValues(gsl::span<const uint8_t> report, gsl::span<int32_t> values) const
+	{
+		VclRequire(static_cast<size_t>(values.size()) >= _nrValues, "Value buffer can store all values.");
+
+		if (report.empty())
+			return 0;
+
+		const auto value_fields = fields(report[0]).values;
+		for (const auto& field : value_fields)
+		{
+			values[field.index] = readValue(report, field);
+		}
+
+		return static_cast<size_t>(value_fields.size());
+	}
+}}
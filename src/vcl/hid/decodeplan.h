@@ -0,0 +1,278 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// GSL
+#include <gsl/gsl>
+
+// VCL
+#include <vcl/hid/buttonset.h>
+
+namespace Vcl { namespace HID
+{
+	//! Location of a button in the input reports
+	struct ButtonLocation
+	{
+		//! ID of the report containing the button
+		uint8_t reportId;
+
+		//! Position of the button bit. Counted from the start of the
+		//! report, including the report ID byte.
+		uint32_t bit;
+	};
+
+	//! Location of a value (e.g. an axis) in the input reports
+	struct ValueLocation
+	{
+		//! ID of the report containing the value
+		uint8_t reportId;
+
+		//! Position of the least significant bit of the value. Counted
+		//! from the start of the report, including the report ID byte.
+		uint32_t bit;
+
+		//! Number of bits of the value (at most 32)
+		uint8_t bitSize;
+
+		//! Indicate whether the value is stored in two's complement
+		bool isSigned;
+	};
+
+	//! Order two fields by their position in the reports
+	//! \returns True, if 'a' is stored in a report with a lower ID than 'b',
+	//!          or in front of 'b' in the same report
+	template<typename Location>
+	inline bool isStoredBefore(const Location& a, const Location& b)
+	{
+		return a.reportId != b.reportId ? a.reportId < b.reportId : a.bit < b.bit;
+	}
+
+	//! Sort fields by their position in the reports
+	//! \param locations Location of each field, ordered by field index
+	//! \returns The field indices in the order of the positions of the fields
+	template<typename Location>
+	std::vector<uint32_t> reportOrder(gsl::span<const Location> locations)
+	{
+		std::vector<uint32_t> order(static_cast<size_t>(locations.size()));
+		for (size_t i = 0; i < order.size(); i++)
+			order[i] = static_cast<uint32_t>(i);
+
+		std::stable_sort(order.begin(), order.end(), [locations](uint32_t a, uint32_t b)
+		{
+			return isStoredBefore(locations[a], locations[b]);
+		});
+		return order;
+	}
+
+	//! Compute a hash identifying the layout of the input reports
+	//! Devices with equal hashes store their buttons and values at the same
+	//! locations and can share decoders. The fields are hashed in the order
+	//! of their position in the reports, such that the hash does not depend
+	//! on the order in which the fields are enumerated.
+	//! \param buttons Location of each button
+	//! \param values Location of each value
+	uint64_t layoutHash(gsl::span<const ButtonLocation> buttons, gsl::span<const ValueLocation> values);
+
+	/*!
+	 *	Precompiled description how to decode the input reports of a device
+	 *
+	 *	Buttons are grouped into segments, which are read with a single
+	 *	64-bit load and compacted using a bit mask. Decoding a report
+	 *	takes a few instructions per segment, independent of the
+	 *	number of pressed buttons.
+	 *	Buttons and values are grouped by the report containing them.
+	 *	A report is dispatched through a table indexed by its report ID,
+	 *	such that only the fields present in the report are decoded.
+	 */
+	class DecodePlan
+	{
+	public:
+		//! Buttons extracted with a single load
+		struct ButtonSegment
+		{
+			//! ID of the report containing the buttons
+			uint8_t reportId;
+
+			//! Position of the loaded bytes
+			uint32_t byteOffset;
+
+			//! Bits of the loaded word belonging to the buttons
+			uint64_t mask;
+
+			//! Position of the first button in the loaded word
+			uint32_t shift;
+
+			//! Indicate whether the buttons are stored without gaps
+			bool isContiguous;
+
+			//! Index of the first button
+			uint32_t first;
+
+			//! Number of buttons
+			uint32_t count;
+		};
+
+		//! Value extracted with a single load
+		struct ValueField
+		{
+			//! ID of the report containing the value
+			uint8_t reportId;
+
+			//! Position of the loaded bytes
+			uint32_t byteOffset;
+
+			//! Position of the value in the loaded word
+			uint32_t shift;
+
+			//! Number of bits of the value
+			uint8_t bitSize;
+
+			//! Indicate whether the value is stored in two's complement
+			bool isSigned;
+
+			//! Index of the value
+			uint32_t index;
+		};
+
+		//! Fields contained in a single report
+		struct ReportFields
+		{
+			//! Button segments of the report
+			gsl::span<const ButtonSegment> buttons;
+
+			//! Values of the report
+			gsl::span<const ValueField> values;
+		};
+
+	public:
+		DecodePlan() = default;
+
+		//! Compile a plan
+		//! \param buttons Location of each button, ordered by button index
+		//! \param values Location of each value, ordered by value index
+		explicit DecodePlan(gsl::span<const ButtonLocation> buttons, gsl::span<const ValueLocation> values = {});
+
+		//! \returns True, if the plan does not decode anything
+		bool empty() const { return _buttonSegments.empty() && _valueFields.empty(); }
+
+		//! \returns True, if the plan decodes the buttons
+		bool hasButtons() const { return !_buttonSegments.empty(); }
+
+		//! \returns True, if the plan decodes the values
+		bool hasValues() const { return !_valueFields.empty(); }
+
+		//! \returns The number of buttons decoded by the plan
+		uint32_t nrButtons() const { return _nrButtons; }
+
+		//! \returns The number of values decoded by the plan
+		uint32_t nrValues() const { return _nrValues; }
+
+		//! Access the button segments, grouped by report ID
+		const std::vector<ButtonSegment>& buttonSegments() const { return _buttonSegments; }
+
+		//! Access the value fields, grouped by report ID
+		const std::vector<ValueField>& valueFields() const { return _valueFields; }
+
+		//! Access the fields of a single report
+		//! \returns The fields, empty if the plan does not know the report
+		ReportFields fields(uint8_t report_id) const
+		{
+			const uint16_t entry = _reportIndex[report_id];
+			if (entry == 0)
+				return {};
+
+			const auto& report = _reports[entry - 1];
+			return
+			{
+				{ _buttonSegments.data() + report.firstSegment, static_cast<std::ptrdiff_t>(report.nrSegments) },
+				{ _valueFields.data() + report.firstValue, static_cast<std::ptrdiff_t>(report.nrValues) }
+			};
+		}
+
+		//! Read a single value from a report
+		static int32_t readValue(gsl::span<const uint8_t> report, const ValueField& field);
+
+		//! Update the button states from a report
+		//! \param report Report data starting with the report ID
+		//! \param buttons Button states. Buttons of other reports are not changed.
+		//! \returns True, if the report contained buttons
+		bool decodeButtons(gsl::span<const uint8_t> report, ButtonSet& buttons) const;
+
+		//! Compare the buttons of two reports with the same report ID
+		//! without decoding them
+		//! \returns True, if any button differs between the reports
+		bool buttonsDiffer(gsl::span<const uint8_t> report, gsl::span<const uint8_t> previous) const;
+
+		//! Update the values from a report
+		//! \param report Report data starting with the report ID
+		//! \param values Values indexed by value index. Values of other reports are not changed.
+		//! \returns The number of decoded values
+		size_t decodeValues(gsl::span<const uint8_t> report, gsl::span<int32_t> values) const;
+
+	private:
+		//! Range of the fields of a single report
+		struct ReportEntry
+		{
+			uint32_t firstSegment;
+			uint32_t nrSegments;
+			uint32_t firstValue;
+			uint32_t nrValues;
+		};
+
+		//! Finalize and store a button segment
+		void addSegment(ButtonSegment segment);
+
+		//! Build the table dispatching the report IDs
+		void buildReportIndex();
+
+	private:
+		//! Number of decoded buttons
+		uint32_t _nrButtons{ 0 };
+
+		//! Number of decoded values
+		uint32_t _nrValues{ 0 };
+
+		//! Button segments
+		std::vector<ButtonSegment> _buttonSegments;
+
+		//! Value fields
+		std::vector<ValueField> _valueFields;
+
+		//! Fields of each report present in the plan
+		std::vector<ReportEntry> _reports;
+
+		//! Entry in '_reports' of each report ID (one based, zero if unknown)
+		std::array<uint16_t, 256> _reportIndex{};
+	};
+}}
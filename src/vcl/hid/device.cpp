@@ -24,10 +24,38 @@
  */
 #include "device.h"
 
+// C++ Standard library
+#include <tuple>
+
 namespace Vcl { namespace HID
 {
 	Device::Device(DeviceType::Enum type)
 	: _type(type)
 	{
 	}
+
+	std::string_view Device::vendorName() const
+	{
+		loadNames();
+		return _vendor;
+	}
+
+	std::string_view Device::deviceName() const
+	{
+		loadNames();
+		return _name;
+	}
+
+	auto Device::readNames() const -> std::pair<std::string_view, std::string_view>
+	{
+		return {};
+	}
+
+	void Device::loadNames() const
+	{
+		std::call_once(_namesRead, [this]()
+		{
+			std::tie(_vendor, _name) = readNames();
+		});
+	}
 }}
@@ -28,6 +28,9 @@
 #include <vcl/config/global.h>
 
 // C++ Standard library
+#include <mutex>
+#include <string_view>
+#include <utility>
 
 // VCL
 #include <vcl/core/flags.h>
@@ -56,21 +59,34 @@ namespace Vcl { namespace HID
 
 		DeviceType::Enum type() const { return _type; }
 
-		const std::wstring& vendorName() const { return _vendor; }
-		const std::wstring& deviceName() const { return _name; }
+		//! \returns The UTF-8 encoded vendor name.
+		//! \note The name is read from the device on first access
+		std::string_view vendorName() const;
+
+		//! \returns The UTF-8 encoded, vendor defined device name.
+		//! \note The name is read from the device on first access
+		std::string_view deviceName() const;
 
 	protected:
-		void setVendorName(const std::wstring& name) { _vendor = name; }
-		void setDeviceName(const std::wstring& name) { _name = name; }
+		//! Read the vendor defined names from the device.
+		//! Called at most once, on the first access of either name.
+		//! \returns The vendor defined names (vendor, product)
+		virtual auto readNames() const -> std::pair<std::string_view, std::string_view>;
 
 	private:
+		//! Load the names of the device if necessary
+		void loadNames() const;
+
 		/// Device type
 		DeviceType::Enum _type;
 
+		/// Guard the lazy initialization of the names
+		mutable std::once_flag _namesRead;
+
 		/// Vendor name
-		std::wstring _vendor;
+		mutable std::string_view _vendor;
 
 		/// Vendor defined device name
-		std::wstring _name;
+		mutable std::string_view _name;
 	};
 }}
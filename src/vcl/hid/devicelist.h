@@ -0,0 +1,70 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// GSL
+#include <gsl/gsl>
+
+// VCL
+#include <vcl/hid/device.h>
+#include <vcl/hid/epoch.h>
+
+namespace Vcl { namespace HID
+{
+	/*!
+	 *	Snapshot of the devices of a device manager
+	 *
+	 *	The listed devices stay valid as long as the list is alive, even
+	 *	if they are removed from the manager in the meantime. The list
+	 *	should thus be short-lived, e.g. the iteration in a single frame.
+	 */
+	class DeviceList
+	{
+	public:
+		DeviceList(EpochDomain::Guard guard, gsl::span<Device const* const> devices)
+		: _guard(std::move(guard))
+		, _devices(devices)
+		{
+		}
+
+		auto begin() const { return _devices.begin(); }
+		auto end() const { return _devices.end(); }
+
+		size_t size() const { return static_cast<size_t>(_devices.size()); }
+		bool empty() const { return size() == 0; }
+
+		Device const* operator[](size_t idx) const { return _devices[idx]; }
+
+	private:
+		//! Pinned epoch keeping the devices alive
+		EpochDomain::Guard _guard;
+
+		//! Devices of the snapshot
+		gsl::span<Device const* const> _devices;
+	};
+}}
@@ -0,0 +1,103 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "epoch.h"
+
+// C++ Standard library
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <thread>
+
+namespace Vcl { namespace HID
+{
+	EpochDomain::~EpochDomain()
+	{
+		for (const auto& retired : _retired)
+			retired.reclaim(retired.object);
+	}
+
+	EpochDomain::Guard EpochDomain::pin() const
+	{
+		// Start at a thread specific slot in order to avoid contention
+		const size_t start = std::hash<std::thread::id>{}(std::this_thread::get_id()) % MaxReaders;
+		for (;;)
+		{
+			for (size_t i = 0; i < MaxReaders; i++)
+			{
+				auto& slot = _slots[(start + i) % MaxReaders].epoch;
+
+				// Publishing a stale epoch is safe. It only delays the reclamation.
+				uint64_t unused = 0;
+				const uint64_t epoch = _epoch.load(std::memory_order_seq_cst);
+				if (slot.load(std::memory_order_relaxed) == 0 &&
+					slot.compare_exchange_strong(unused, epoch, std::memory_order_seq_cst))
+				{
+					return Guard{ &slot };
+				}
+			}
+
+			// All slots are in use
+			std::this_thread::yield();
+		}
+	}
+
+	void EpochDomain::retire(void* object, void (*reclaim)(void*))
+	{
+		std::lock_guard<std::mutex> guard{ _retiredLock };
+
+		// Readers pinning a later epoch cannot reach the object anymore
+		const uint64_t epoch = _epoch.fetch_add(1, std::memory_order_seq_cst);
+		_retired.push_back({ epoch, object, reclaim });
+	}
+
+	size_t EpochDomain::collect()
+	{
+		std::vector<Retired> reclaimable;
+		{
+			// Scan the readers only after all objects in the list were retired
+			std::lock_guard<std::mutex> guard{ _retiredLock };
+
+			uint64_t oldest_pinned = std::numeric_limits<uint64_t>::max();
+			for (const auto& slot : _slots)
+			{
+				const uint64_t epoch = slot.epoch.load(std::memory_order_seq_cst);
+				if (epoch != 0)
+					oldest_pinned = std::min(oldest_pinned, epoch);
+			}
+
+			auto first_reclaimable = std::partition(_retired.begin(), _retired.end(), [oldest_pinned](const Retired& retired)
+			{
+				return retired.epoch >= oldest_pinned;
+			});
+			reclaimable.assign(first_reclaimable, _retired.end());
+			_retired.erase(first_reclaimable, _retired.end());
+		}
+
+		for (const auto& retired : reclaimable)
+			retired.reclaim(retired.object);
+
+		return reclaimable.size();
+	}
+}}
@@ -0,0 +1,149 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace Vcl { namespace HID
+{
+	/*!
+	 *	Epoch based reclamation of shared objects
+	 *
+	 *	Readers pin the current epoch while they access shared objects.
+	 *	Writers replace the objects and retire the old versions, which are
+	 *	destroyed once no reader pinned an epoch in which the old versions
+	 *	were still reachable.
+	 *	Pinning is wait-free as long as less than 'MaxReaders' readers
+	 *	are active at the same time. Readers never wait for writers.
+	 */
+	class EpochDomain
+	{
+	public:
+		//! Maximum number of concurrently active readers
+		static const size_t MaxReaders = 64;
+
+		//! Scoped pin of an epoch
+		class Guard
+		{
+		public:
+			Guard() = default;
+			Guard(Guard&& other) noexcept : _slot(other._slot) { other._slot = nullptr; }
+			~Guard() { release(); }
+
+			Guard(const Guard&) = delete;
+			Guard& operator=(const Guard&) = delete;
+			Guard& operator=(Guard&& other) noexcept
+			{
+				if (this != &other)
+				{
+					release();
+					_slot = other._slot;
+					other._slot = nullptr;
+				}
+				return *this;
+			}
+
+			//! \returns True, if the guard pins an epoch
+			bool isPinned() const { return _slot != nullptr; }
+
+		private:
+			friend class EpochDomain;
+			explicit Guard(std::atomic<uint64_t>* slot) : _slot(slot) {}
+
+			void release()
+			{
+				if (_slot)
+					_slot->store(0, std::memory_order_release);
+				_slot = nullptr;
+			}
+
+			//! Reader slot holding the pinned epoch
+			std::atomic<uint64_t>* _slot{ nullptr };
+		};
+
+	public:
+		EpochDomain() = default;
+		EpochDomain(const EpochDomain&) = delete;
+		EpochDomain& operator=(const EpochDomain&) = delete;
+
+		//! Reclaims all remaining objects.
+		//! \note No reader may be active anymore.
+		~EpochDomain();
+
+		//! Pin the current epoch
+		//! Shared objects loaded while the guard is alive stay valid.
+		Guard pin() const;
+
+		//! Defer the destruction of an object until no reader can access it
+		template<typename T>
+		void retire(T* object)
+		{
+			retire(object, [](void* ptr) { delete static_cast<T*>(ptr); });
+		}
+
+		//! Defer the reclamation of an object until no reader can access it
+		//! \param object Object which is not reachable anymore for new readers
+		//! \param reclaim Function reclaiming the object
+		void retire(void* object, void (*reclaim)(void*));
+
+		//! Reclaim the retired objects no reader can access anymore
+		//! \returns The number of reclaimed objects
+		size_t collect();
+
+	private:
+		//! Per reader epoch. Zero marks an unused slot.
+		struct alignas(64) Slot
+		{
+			std::atomic<uint64_t> epoch{ 0 };
+		};
+
+		//! Object waiting for its reclamation
+		struct Retired
+		{
+			uint64_t epoch;
+			void* object;
+			void (*reclaim)(void*);
+		};
+
+		//! Global epoch
+		std::atomic<uint64_t> _epoch{ 1 };
+
+		//! Epochs pinned by the readers
+		mutable std::array<Slot, MaxReaders> _slots;
+
+		//! Protect the list of retired objects
+		std::mutex _retiredLock;
+
+		//! Objects waiting for their reclamation
+		std::vector<Retired> _retired;
+	};
+}}
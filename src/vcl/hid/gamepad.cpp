@@ -32,7 +32,6 @@ namespace Vcl { namespace HID
 	Gamepad::Gamepad()
 	: Device(DeviceType::Gamepad)
 	{
-		_axes.assign(0);
 	}
 
 	uint32_t Gamepad::nrAxes() const
@@ -51,28 +50,36 @@ namespace Vcl { namespace HID
 	void Gamepad::setNrButtons(uint32_t nr_buttons)
 	{
 		_nrButtons = nr_buttons;
+		_buttons.resize(nr_buttons);
+		_pressed.resize(nr_buttons);
+		_released.resize(nr_buttons);
 	}
 
 	float Gamepad::axisState(uint32_t axis) const
 	{
-		return _axes[axis];
+		return _axes.state(axis);
 	}
 
-	void Gamepad::setAxisState(uint32_t axis, float state)
+	void Gamepad::setAxisState(uint32_t axis, int32_t raw, float state)
 	{
-		_axes[axis] = state;
+		_axes.set(axis, raw, state);
+	}
+
+	void Gamepad::setAxisRaw(uint32_t axis, int32_t raw, const AxisCalibrator* calibrator)
+	{
+		_axes.setRaw(axis, raw, calibrator);
 	}
 
 	bool Gamepad::buttonState(uint32_t idx) const
 	{
-		VclRequire(idx < std::min(32u, nrButtons()), "Button index is valid.");
+		VclRequire(idx < nrButtons(), "Button index is valid.");
 
-		return _buttons[idx];
+		return _buttons.test(idx);
 	}
 
-	void Gamepad::setButtonStates(std::bitset<32>&& states)
+	void Gamepad::setButtonStates(const ButtonSet& states, bool accumulate_edges)
 	{
-		_buttons = states;
+		_buttons.update(states, _pressed, _released, accumulate_edges);
 	}
 
 	void Gamepad::setHatState(uint32_t state)
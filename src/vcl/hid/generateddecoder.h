@@ -0,0 +1,115 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <cstdint>
+
+// GSL
+#include <gsl/gsl>
+
+// VCL
+#include <vcl/hid/bitfield.h>
+#include <vcl/hid/buttonset.h>
+
+namespace Vcl { namespace HID
+{
+	/*!
+	 *	Decoder generated by 'vcl.hid.gen' for a known device
+	 *
+	 *	The field locations of generated decoders are compile-time
+	 *	constants, such that each report is decoded by a fixed sequence
+	 *	of loads and shifts.
+	 *	Buttons and values are numbered in the order of their position in
+	 *	the reports (see 'isStoredBefore'), independent of the order in
+	 *	which the platform enumerates them.
+	 */
+	struct GeneratedDecoder
+	{
+		//! Name of the device
+		const char* name;
+
+		//! Vendor ID of the device
+		uint16_t vendorId;
+
+		//! Product ID of the device
+		uint16_t productId;
+
+		//! Hash of the layout the decoder was generated for (see 'layoutHash')
+		uint64_t layoutHash;
+
+		//! Number of decoded buttons
+		uint32_t nrButtons;
+
+		//! Number of decoded values (at most 64)
+		uint32_t nrValues;
+
+		//! Update the button states from a report
+		//! \returns True, if the report contained buttons
+		bool (*decodeButtons)(gsl::span<const uint8_t> report, ButtonSet& buttons);
+
+		//! Update the values from a report
+		//! \returns The mask of the values contained in the report
+		uint64_t (*decodeValues)(gsl::span<const uint8_t> report, gsl::span<int32_t> values);
+	};
+
+	//! Find the generated decoder of a device
+	//! \param vendor_id Vendor ID of the device
+	//! \param product_id Product ID of the device
+	//! \param layout_hash Hash of the layout determined from the device
+	//! \returns The decoder, or null if no decoder matches the device
+	const GeneratedDecoder* findGeneratedDecoder(uint16_t vendor_id, uint16_t product_id, uint64_t layout_hash);
+
+	namespace Generated
+	{
+		//! Read bits at a location known at compile time
+		template<uint32_t Bit, uint32_t Count>
+		inline uint64_t readBits(gsl::span<const uint8_t> report)
+		{
+			static_assert(Count > 0 && Count <= 56, "Bits are read with a single load");
+
+			return (load64le(report, Bit / 8) >> (Bit % 8)) & ((uint64_t{ 1 } << Count) - 1);
+		}
+
+		//! Read a value at a location known at compile time
+		template<uint32_t Bit, uint32_t Size, bool IsSigned>
+		inline int32_t readValue(gsl::span<const uint8_t> report)
+		{
+			static_assert(Size > 0 && Size <= 32, "Values have at most 32 bits");
+
+			const uint64_t value = readBits<Bit, Size>(report);
+			if (IsSigned)
+			{
+				constexpr uint64_t sign = uint64_t{ 1 } << (Size - 1);
+				return static_cast<int32_t>(static_cast<int64_t>(value ^ sign) - static_cast<int64_t>(sign));
+			}
+
+			return static_cast<int32_t>(value);
+		}
+	}
+}}
@@ -0,0 +1,200 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// VCL
+#include <vcl/hid/epoch.h>
+#include <vcl/hid/smallfunction.h>
+
+namespace Vcl { namespace HID
+{
+	//! Reclamation of the replaced subscription tables of all registries
+	EpochDomain& handlerRegistryEpochs();
+
+	/*!
+	 *	Subscriptions to the events of a source
+	 *
+	 *	Each subscription selects the event types it receives with a mask.
+	 *	Changes of the subscriptions are published as a new immutable table,
+	 *	thus events are dispatched without locking and subscriptions may be
+	 *	changed from within a callback. Callbacks removed during a dispatch
+	 *	may still be called by that dispatch.
+	 */
+	template<typename Event>
+	class HandlerRegistry
+	{
+	public:
+		//! Callback receiving the events
+		using Callback = SmallFunction<void(const Event&)>;
+
+		//! Identification of a subscription. Zero is never used.
+		using Id = uint64_t;
+
+	public:
+		HandlerRegistry() = default;
+		HandlerRegistry(const HandlerRegistry&) = delete;
+		~HandlerRegistry()
+		{
+			// No dispatch may be active anymore
+			delete _table.load();
+		}
+
+		HandlerRegistry& operator=(const HandlerRegistry&) = delete;
+
+		//! Add a subscription
+		//! \param mask Types of the events passed to the callback
+		//! \param callback Callback receiving the events
+		//! \returns The identification of the subscription
+		Id subscribe(uint32_t mask, Callback callback)
+		{
+			std::lock_guard<std::mutex> guard{ _writeLock };
+
+			auto subscription = std::make_shared<Subscription>();
+			subscription->id = ++_lastId;
+			subscription->mask = mask;
+			subscription->callback = std::move(callback);
+
+			auto table = copyTable();
+			table->subscriptions.emplace_back(std::move(subscription));
+			table->mask |= mask;
+			publish(std::move(table));
+
+			return _lastId;
+		}
+
+		//! Remove a subscription
+		//! \returns True, if the subscription existed
+		bool unsubscribe(Id id)
+		{
+			std::lock_guard<std::mutex> guard{ _writeLock };
+
+			auto table = copyTable();
+			auto& subscriptions = table->subscriptions;
+			const auto size = subscriptions.size();
+			subscriptions.erase(std::remove_if(subscriptions.begin(), subscriptions.end(), [id](const auto& subscription)
+			{
+				return subscription->id == id;
+			}), subscriptions.end());
+			if (subscriptions.size() == size)
+				return false;
+
+			table->mask = 0;
+			for (const auto& subscription : subscriptions)
+				table->mask |= subscription->mask;
+			publish(std::move(table));
+
+			return true;
+		}
+
+		//! \returns True, if any subscription receives events of the given types
+		bool isSubscribed(uint32_t type) const
+		{
+			return (_mask.load(std::memory_order_relaxed) & type) != 0;
+		}
+
+		//! Pass an event to the subscriptions of its type
+		//! \param type Type of the event
+		//! \param event Event passed to the callbacks
+		void dispatch(uint32_t type, const Event& event) const
+		{
+			if (!isSubscribed(type))
+				return;
+
+			const auto guard = handlerRegistryEpochs().pin();
+			const Table* table = _table.load(std::memory_order_seq_cst);
+			if (!table)
+				return;
+
+			for (const auto& subscription : table->subscriptions)
+			{
+				if (subscription->mask & type)
+					subscription->callback(event);
+			}
+		}
+
+	private:
+		//! Single subscription
+		struct Subscription
+		{
+			Id id;
+			uint32_t mask;
+			Callback callback;
+		};
+
+		//! Immutable snapshot of the subscriptions
+		struct Table
+		{
+			//! Subscriptions in the order they were added
+			std::vector<std::shared_ptr<const Subscription>> subscriptions;
+
+			//! Union of the masks of all subscriptions
+			uint32_t mask{ 0 };
+		};
+
+		//! Copy the current table
+		//! \note Requires '_writeLock' to be held
+		std::unique_ptr<Table> copyTable() const
+		{
+			const Table* current = _table.load(std::memory_order_seq_cst);
+			return current ? std::make_unique<Table>(*current) : std::make_unique<Table>();
+		}
+
+		//! Publish a new table and retire the old one
+		//! \note Requires '_writeLock' to be held
+		void publish(std::unique_ptr<Table> table)
+		{
+			_mask.store(table->mask, std::memory_order_relaxed);
+			auto old_table = _table.exchange(table.release(), std::memory_order_seq_cst);
+			if (old_table)
+			{
+				handlerRegistryEpochs().retire(const_cast<Table*>(old_table));
+				handlerRegistryEpochs().collect();
+			}
+		}
+
+		//! Serialize changes of the subscriptions
+		std::mutex _writeLock;
+
+		//! Last assigned identification
+		Id _lastId{ 0 };
+
+		//! Current subscriptions
+		std::atomic<const Table*> _table{ nullptr };
+
+		//! Union of the masks of the current subscriptions
+		std::atomic<uint32_t> _mask{ 0 };
+	};
+}}
@@ -0,0 +1,69 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <vector>
+
+namespace Vcl { namespace HID
+{
+	//! Type of a device change
+	enum class HotplugAction
+	{
+		Arrival,
+		Removal
+	};
+
+	//! Notification about an added or removed device
+	struct HotplugEvent
+	{
+		//! Kind of change
+		HotplugAction action;
+
+		//! Native handle of the device
+		void* handle{ nullptr };
+	};
+
+	/*!
+	 *	Source of device arrival and removal notifications
+	 *
+	 *	Device managers consume the events in order to add or remove
+	 *	single devices without enumerating all the devices again.
+	 *	Implementations can be replaced, e.g. to inject events in tests.
+	 */
+	class HotplugSource
+	{
+	public:
+		virtual ~HotplugSource() = default;
+
+		//! Fetch the pending device changes without blocking
+		//! \param events List to which the new events are appended
+		//! \returns The number of appended events
+		virtual size_t poll(std::vector<HotplugEvent>& events) = 0;
+	};
+}}
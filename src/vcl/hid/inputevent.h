@@ -0,0 +1,91 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <cstdint>
+
+// GSL
+#include <gsl/gsl>
+
+namespace Vcl { namespace HID
+{
+	//! Forward declaration
+	class Device;
+
+	//! Type of an input event
+	enum class InputEventType : uint8_t
+	{
+		//! Normalized state of an axis. The index is the axis slot.
+		Axis,
+
+		//! State of a button (0 or 1). The index is the button number.
+		Button,
+
+		//! Motion of a 3D mouse per millisecond. The index is the component
+		//! (pan zoom x, y, z, rotation x, y, z).
+		Motion,
+
+		//! State of a 3D mouse key (0 or 1). The index is the virtual key.
+		Key
+	};
+
+	//! Compact, timestamped input event
+	struct InputEvent
+	{
+		//! Time the event was received (steady clock, microseconds)
+		uint64_t timestamp;
+
+		//! Type of the event
+		InputEventType type;
+
+		//! Index of the axis, button or component
+		uint16_t index;
+
+		//! New value
+		float value;
+	};
+	static_assert(sizeof(InputEvent) == 16, "Events are compact");
+
+	//! Callback interface receiving the events of a device in batches
+	class BatchedInputHandler
+	{
+	public:
+		virtual ~BatchedInputHandler() = default;
+
+		/*!
+		 * \brief onInputEvents is invoked once per device and processed batch
+		 *        with the events gathered since the last invocation
+		 *
+		 * \param device Pointer to the device that triggered the callback
+		 * \param events Events in the order they were received. The span is
+		 *               only valid during the call.
+		 */
+		virtual void onInputEvents(const Device* device, gsl::span<const InputEvent> events) = 0;
+	};
+}}
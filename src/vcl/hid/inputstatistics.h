@@ -0,0 +1,92 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <cstdint>
+
+namespace Vcl { namespace HID
+{
+	//! Counters of the input processing
+	struct InputStatistics
+	{
+		//! Number of processed reports
+		uint64_t nrReports{ 0 };
+
+		//! Number of processed batches
+		uint64_t nrBatches{ 0 };
+
+		//! Number of per-device groups over all batches
+		uint64_t nrDeviceGroups{ 0 };
+
+		//! Number of reports, which did not belong to a known device
+		uint64_t nrUnknownReports{ 0 };
+
+		//! Number of reports skipped, because they repeated their predecessor
+		uint64_t nrDuplicateReports{ 0 };
+
+		//! Number of reports superseded by a newer report in the same batch.
+		//! Only button edges and relative values were decoded.
+		uint64_t nrCoalescedReports{ 0 };
+
+		//! Number of times the input thread woke up in 'waitForInput'
+		uint64_t nrWakeups{ 0 };
+
+		//! Number of times reports were processed. Reports deferred by
+		//! the latency budget are processed in a single pass.
+		uint64_t nrProcessingPasses{ 0 };
+
+		//! Number of times deferred reports were processed early, because
+		//! a report changed a button
+		uint64_t nrImmediatePasses{ 0 };
+
+		//! Number of reports deferred by the latency budget
+		uint64_t nrDeferredReports{ 0 };
+
+		//! Latency added to all the deferred reports (microseconds)
+		uint64_t totalAddedLatency{ 0 };
+
+		//! Largest latency added to a single report (microseconds)
+		uint64_t maxAddedLatency{ 0 };
+
+		//! Configured latency budget (microseconds)
+		uint64_t latencyBudget{ 0 };
+
+		//! Time covered by the counters (microseconds)
+		uint64_t uptime{ 0 };
+
+		//! \returns The average number of times the input thread woke up per second
+		double wakeupsPerSecond() const { return uptime > 0 ? 1e6 * static_cast<double>(nrWakeups) / static_cast<double>(uptime) : 0.0; }
+
+		//! \returns The average number of processing passes per second
+		double processingPassesPerSecond() const { return uptime > 0 ? 1e6 * static_cast<double>(nrProcessingPasses) / static_cast<double>(uptime) : 0.0; }
+
+		//! \returns The average latency added to a deferred report (microseconds)
+		double averageAddedLatency() const { return nrDeferredReports > 0 ? static_cast<double>(totalAddedLatency) / static_cast<double>(nrDeferredReports) : 0.0; }
+	};
+}}
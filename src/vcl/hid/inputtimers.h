@@ -0,0 +1,101 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <cstdint>
+
+namespace Vcl { namespace HID
+{
+	//! Forward declaration
+	class Device;
+
+	//! Timers maintained for the input devices
+	enum class InputTimer : uint32_t
+	{
+		//! Device did not send any report for its stale timeout
+		Stale,
+
+		//! Button is held beyond the repeat delay
+		Repeat,
+
+		//! Button is held for the long-press time
+		LongPress
+	};
+
+	//! Configuration of the timed device and button events. Zero disables an event.
+	struct InputTimerSettings
+	{
+		//! Time without reports after which the state of a device is reset to
+		//! rest (microseconds). Only suitable for devices sending reports
+		//! continuously, as most devices only report changes.
+		//! Devices with a known report rate use their own timeout.
+		uint64_t staleTimeout{ 0 };
+
+		//! Time a button needs to be held before it repeats (microseconds)
+		uint64_t repeatDelay{ 0 };
+
+		//! Time between two repetitions (microseconds)
+		uint64_t repeatInterval{ 0 };
+
+		//! Time a button needs to be held to be pressed long (microseconds)
+		uint64_t longPressTime{ 0 };
+	};
+
+	//! Callback interface of the events synthesized by the input timers
+	class InputTimerHandler
+	{
+	public:
+		virtual ~InputTimerHandler() = default;
+
+		/*!
+		 * \brief onDeviceStale is invoked when a device stopped sending reports
+		 *        and its state was reset to rest.
+		 *
+		 * \param device Pointer to the device that triggered the callback
+		 */
+		virtual void onDeviceStale(const Device* device) = 0;
+
+		/*!
+		 * \brief onButtonRepeat is invoked repeatedly while a button is held
+		 *
+		 * \param device Pointer to the device that triggered the callback
+		 * \param button Index of the held button
+		 */
+		virtual void onButtonRepeat(const Device* device, uint32_t button) = 0;
+
+		/*!
+		 * \brief onButtonLongPress is invoked once a button was held
+		 *        for the long-press time
+		 *
+		 * \param device Pointer to the device that triggered the callback
+		 * \param button Index of the held button
+		 */
+		virtual void onButtonLongPress(const Device* device, uint32_t button) = 0;
+	};
+}}
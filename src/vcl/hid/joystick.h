@@ -29,9 +29,10 @@
 
 // C++ Standard library
 #include <array>
-#include <bitset>
 
 // VCL
+#include <vcl/hid/axisset.h>
+#include <vcl/hid/buttonset.h>
 #include <vcl/hid/device.h>
 
 namespace Vcl { namespace HID
@@ -43,7 +44,16 @@ namespace Vcl { namespace HID
 		Z,
 		RX,
 		RY,
-		RZ
+		RZ,
+		Slider,
+		Slider2,
+		Dial,
+		Wheel,
+		Throttle,
+		Rudder,
+		Accelerator,
+		Brake,
+		Steering
 	};
 
 	class Joystick : public Device
@@ -57,11 +67,38 @@ namespace Vcl { namespace HID
 		float axisState(uint32_t axis) const;
 		bool buttonState(uint32_t idx) const;
 
+		//! \returns The logical value of an axis, as reported by the device
+		int32_t axisRaw(uint32_t axis) const { return _axes.raw(axis); }
+
+		//! \returns The value of an axis in the physical unit given by 'axisUnit'
+		float axisPhysical(uint32_t axis) const { return _axes.physical(axis); }
+
+		//! \returns The physical unit of an axis
+		PhysicalUnit axisUnit(uint32_t axis) const { return _axes.unit(axis); }
+
+		//! \returns The state of an axis as Q15 fixed-point number
+		int16_t axisFixed(uint32_t axis) const { return _axes.fixed(axis); }
+
+		//! Normalize all the axes updated since the last call in one pass
+		//! \note Only required if the device defers the normalization
+		void latchAxes() { _axes.latch(); }
+
+		//! \returns The states of all buttons
+		const ButtonSet& buttonStates() const { return _buttons; }
+
+		//! \returns The buttons pressed with the last update
+		const ButtonSet& pressedButtons() const { return _pressed; }
+
+		//! \returns The buttons released with the last update
+		const ButtonSet& releasedButtons() const { return _released; }
+
 	protected:
 		void setNrAxes(uint32_t nr_axes);
 		void setNrButtons(uint32_t nr_buttons);
-		void setAxisState(uint32_t axis, float state);
-		void setButtonStates(std::bitset<32>&& states);
+		void setAxisState(uint32_t axis, int32_t raw, float state);
+		void setAxisRaw(uint32_t axis, int32_t raw, const AxisCalibrator* calibrator);
+		void setAxisPhysicalScale(uint32_t axis, const PhysicalScale& scale) { _axes.setPhysicalScale(axis, scale); }
+		void setButtonStates(const ButtonSet& states, bool accumulate_edges = false);
 
 	private:
 		/// Number of reported axes
@@ -71,9 +108,15 @@ namespace Vcl { namespace HID
 		uint32_t _nrButtons{ 0 };
 
 		/// Axes states
-		std::array<float, 8> _axes;
+		AxisSet _axes;
 
 		/// Buttons states
-		std::bitset<32> _buttons;
+		ButtonSet _buttons;
+
+		/// Buttons pressed with the last update
+		ButtonSet _pressed;
+
+		/// Buttons released with the last update
+		ButtonSet _released;
 	};
 }}
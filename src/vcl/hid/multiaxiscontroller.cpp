@@ -32,7 +32,6 @@ namespace Vcl { namespace HID
 	MultiAxisController::MultiAxisController()
 	: Device(DeviceType::MultiAxisController)
 	{
-		_axes.assign(0);
 	}
 
 	uint32_t MultiAxisController::nrAxes() const
@@ -51,27 +50,35 @@ namespace Vcl { namespace HID
 	void MultiAxisController::setNrButtons(uint32_t nr_buttons)
 	{
 		_nrButtons = nr_buttons;
+		_buttons.resize(nr_buttons);
+		_pressed.resize(nr_buttons);
+		_released.resize(nr_buttons);
 	}
 
 	float MultiAxisController::axisState(uint32_t axis) const
 	{
-		return _axes[axis];
+		return _axes.state(axis);
 	}
 
-	void MultiAxisController::setAxisState(uint32_t axis, float state)
+	void MultiAxisController::setAxisState(uint32_t axis, int32_t raw, float state)
 	{
-		_axes[axis] = state;
+		_axes.set(axis, raw, state);
+	}
+
+	void MultiAxisController::setAxisRaw(uint32_t axis, int32_t raw, const AxisCalibrator* calibrator)
+	{
+		_axes.setRaw(axis, raw, calibrator);
 	}
 
 	bool MultiAxisController::buttonState(uint32_t idx) const
 	{
-		VclRequire(idx < std::min(32u, nrButtons()), "Button index is valid.");
+		VclRequire(idx < nrButtons(), "Button index is valid.");
 
-		return _buttons[idx];
+		return _buttons.test(idx);
 	}
 
-	void MultiAxisController::setButtonStates(std::bitset<32>&& states)
+	void MultiAxisController::setButtonStates(const ButtonSet& states, bool accumulate_edges)
 	{
-		_buttons = states;
+		_buttons.update(states, _pressed, _released, accumulate_edges);
 	}
 }}
@@ -0,0 +1,264 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "pollscheduler.h"
+
+// C++ Standard library
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// Platform API
+#ifdef _WIN32
+#	define WIN32_LEAN_AND_MEAN
+#	include <Windows.h>
+#	ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#		define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#	endif
+#endif
+
+namespace Vcl { namespace HID
+{
+	PollScheduler::PollScheduler(std::function<void()> poll)
+	: _poll(std::move(poll))
+	, _created(now())
+	{
+#ifdef _WIN32
+		// Regular waitable timers are bound to the resolution of the system timer
+		_timer = ::CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+		if (!_timer)
+			_timer = ::CreateWaitableTimerW(nullptr, FALSE, nullptr);
+		_event = ::CreateEventW(nullptr, FALSE, FALSE, nullptr);
+#endif
+
+		_thread = std::thread{ [this]() { run(); } };
+	}
+
+	PollScheduler::~PollScheduler()
+	{
+		{
+			std::lock_guard<std::mutex> guard{ _lock };
+			_stop = true;
+			signal();
+		}
+		_thread.join();
+
+#ifdef _WIN32
+		if (_timer)
+			::CloseHandle(_timer);
+		if (_event)
+			::CloseHandle(_event);
+#endif
+	}
+
+	void PollScheduler::configure(const PollSchedulerSettings& settings)
+	{
+		std::lock_guard<std::mutex> guard{ _lock };
+
+		_settings = settings;
+		_settings.maxRate = std::min(std::max(_settings.maxRate, 1.0f), MaxRate);
+		_settings.minRate = std::min(std::max(_settings.minRate, 1.0f), _settings.maxRate);
+		_settings.decayHalfLife = std::max<uint64_t>(_settings.decayHalfLife, 1);
+
+		if (_active)
+		{
+			_rate = std::min(std::max(_rate, _settings.minRate), _settings.maxRate);
+			signal();
+		}
+	}
+
+	PollSchedulerSettings PollScheduler::settings() const
+	{
+		std::lock_guard<std::mutex> guard{ _lock };
+		return _settings;
+	}
+
+	void PollScheduler::wake()
+	{
+		std::lock_guard<std::mutex> guard{ _lock };
+		if (_active)
+			return;
+
+		// Poll the new activity right away
+		const uint64_t time = now();
+		_active = true;
+		_rate = _settings.maxRate;
+		_rateTime = time;
+		_activeSince = time;
+		_deadline = time;
+		signal();
+	}
+
+	void PollScheduler::reportActivity(float activity)
+	{
+		std::lock_guard<std::mutex> guard{ _lock };
+		if (!_active)
+			return;
+
+		const uint64_t time = now();
+		if (!(activity > 0.0f))
+		{
+			deactivate(time);
+			return;
+		}
+
+		// Follow increasing activity immediately, decreasing activity gradually
+		const float target = _settings.minRate + (_settings.maxRate - _settings.minRate) * std::min(activity, 1.0f);
+		if (target >= _rate)
+		{
+			_rate = target;
+		}
+		else
+		{
+			const double elapsed = static_cast<double>(time - _rateTime);
+			const float decay = static_cast<float>(std::exp2(-elapsed / static_cast<double>(_settings.decayHalfLife)));
+			_rate = target + (_rate - target) * decay;
+		}
+		_rateTime = time;
+	}
+
+	bool PollScheduler::isActive() const
+	{
+		std::lock_guard<std::mutex> guard{ _lock };
+		return _active;
+	}
+
+	float PollScheduler::rate() const
+	{
+		std::lock_guard<std::mutex> guard{ _lock };
+		return _active ? _rate : 0.0f;
+	}
+
+	PollStatistics PollScheduler::statistics() const
+	{
+		std::lock_guard<std::mutex> guard{ _lock };
+
+		const uint64_t time = now();
+		PollStatistics stats = _stats;
+		stats.uptime = time - _created;
+		if (_active)
+		{
+			stats.activeTime += time - _activeSince;
+			stats.rate = _rate;
+		}
+		return stats;
+	}
+
+	void PollScheduler::run()
+	{
+		std::unique_lock<std::mutex> lock{ _lock };
+		while (!_stop)
+		{
+			if (!_active)
+			{
+				waitForSignal(lock);
+				continue;
+			}
+
+			// Waiting may be interrupted by a change of the state
+			const uint64_t deadline = _deadline;
+			uint64_t time = now();
+			if (time < deadline)
+			{
+				waitUntil(lock, deadline);
+				continue;
+			}
+
+			const uint64_t latency = time - deadline;
+			_stats.nrWakeups++;
+			_stats.totalLatency += latency;
+			_stats.maxLatency = std::max(_stats.maxLatency, latency);
+
+			lock.unlock();
+			_poll();
+			lock.lock();
+
+			// Keep the cadence, unless the polling fell behind by more than a period
+			const auto period = static_cast<uint64_t>(1e6f / std::max(_rate, 1.0f));
+			time = now();
+			_deadline = deadline + period;
+			if (_deadline + period < time)
+				_deadline = time;
+		}
+	}
+
+	void PollScheduler::deactivate(uint64_t time)
+	{
+		_stats.activeTime += time - _activeSince;
+		_active = false;
+		_rate = 0.0f;
+	}
+
+	void PollScheduler::signal()
+	{
+#ifdef _WIN32
+		::SetEvent(_event);
+#else
+		_signal.notify_one();
+#endif
+	}
+
+#ifdef _WIN32
+	void PollScheduler::waitUntil(std::unique_lock<std::mutex>& lock, uint64_t deadline)
+	{
+		const uint64_t time = now();
+		if (deadline <= time)
+			return;
+
+		// Relative due time in units of 100 nanoseconds
+		LARGE_INTEGER due_time;
+		due_time.QuadPart = -static_cast<LONGLONG>((deadline - time) * 10);
+		::SetWaitableTimer(_timer, &due_time, 0, nullptr, nullptr, FALSE);
+
+		const HANDLE handles[] = { _event, _timer };
+		lock.unlock();
+		::WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+		lock.lock();
+	}
+
+	void PollScheduler::waitForSignal(std::unique_lock<std::mutex>& lock)
+	{
+		lock.unlock();
+		::WaitForSingleObject(_event, INFINITE);
+		lock.lock();
+	}
+#else
+	void PollScheduler::waitUntil(std::unique_lock<std::mutex>& lock, uint64_t deadline)
+	{
+		const std::chrono::steady_clock::time_point time_point{ std::chrono::microseconds{ deadline } };
+		_signal.wait_until(lock, time_point);
+	}
+
+	void PollScheduler::waitForSignal(std::unique_lock<std::mutex>& lock)
+	{
+		_signal.wait(lock);
+	}
+#endif
+
+	uint64_t PollScheduler::now()
+	{
+		const auto time = std::chrono::steady_clock::now().time_since_epoch();
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(time).count());
+	}
+}}
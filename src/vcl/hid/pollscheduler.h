@@ -0,0 +1,194 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Vcl { namespace HID
+{
+	//! Configuration of a poll scheduler
+	struct PollSchedulerSettings
+	{
+		//! Polling rate at full activity (Hz)
+		float maxRate{ 1000.0f };
+
+		//! Polling rate at the lowest activity before becoming idle (Hz)
+		float minRate{ 60.0f };
+
+		//! Time after which the polling rate is halved towards the rate
+		//! matching a decreased activity (microseconds)
+		uint64_t decayHalfLife{ 50000 };
+	};
+
+	//! Counters of a poll scheduler
+	struct PollStatistics
+	{
+		//! Number of times the scheduler woke up to poll
+		uint64_t nrWakeups{ 0 };
+
+		//! Time since the scheduler was created (microseconds)
+		uint64_t uptime{ 0 };
+
+		//! Time the scheduler was polling (microseconds)
+		uint64_t activeTime{ 0 };
+
+		//! Accumulated delay between the scheduled and the actual wake ups (microseconds)
+		uint64_t totalLatency{ 0 };
+
+		//! Largest delay between the scheduled and the actual wake up (microseconds)
+		uint64_t maxLatency{ 0 };
+
+		//! Current polling rate, zero if idle (Hz)
+		float rate{ 0.0f };
+
+		//! \returns The average number of wake ups per second since the scheduler was created
+		double wakeupsPerSecond() const { return uptime > 0 ? 1e6 * static_cast<double>(nrWakeups) / static_cast<double>(uptime) : 0.0; }
+
+		//! \returns The average delay of the wake ups (microseconds)
+		double averageLatency() const { return nrWakeups > 0 ? static_cast<double>(totalLatency) / static_cast<double>(nrWakeups) : 0.0; }
+	};
+
+	/*!
+	 *	Schedule the polling of a device with a rate adapting to its activity
+	 *
+	 *	The scheduler calls the poll function from its own thread. Polling
+	 *	starts at the maximum rate when the scheduler is woken up. The poll
+	 *	function reports the activity of the device, from which the rate is
+	 *	derived. A decreasing activity lowers the rate gradually, while no
+	 *	activity stops the polling until the scheduler is woken up again.
+	 *	An idle scheduler does not wake up the process.
+	 */
+	class PollScheduler
+	{
+	public:
+		//! Highest supported polling rate (Hz)
+		static constexpr float MaxRate = 1000.0f;
+
+		//! \param poll Function polling the device
+		explicit PollScheduler(std::function<void()> poll);
+		PollScheduler(const PollScheduler&) = delete;
+		~PollScheduler();
+
+		PollScheduler& operator=(const PollScheduler&) = delete;
+
+		//! Change the configuration
+		void configure(const PollSchedulerSettings& settings);
+
+		//! \returns The current configuration
+		PollSchedulerSettings settings() const;
+
+		//! Start polling at the maximum rate, if the scheduler is idle
+		void wake();
+
+		//! Update the polling rate according to the activity of the device
+		//! \param activity Normalized activity in [0, 1]. Zero stops the polling.
+		void reportActivity(float activity);
+
+		//! \returns True, if the scheduler is polling
+		bool isActive() const;
+
+		//! \returns The current polling rate, zero if idle (Hz)
+		float rate() const;
+
+		//! Access the counters of the scheduler
+		PollStatistics statistics() const;
+
+	private:
+		//! Body of the polling thread
+		void run();
+
+		//! Wait until a point in time or until the thread is signalled
+		//! \note Requires '_lock' to be held
+		void waitUntil(std::unique_lock<std::mutex>& lock, uint64_t deadline);
+
+		//! Wait until the thread is signalled
+		//! \note Requires '_lock' to be held
+		void waitForSignal(std::unique_lock<std::mutex>& lock);
+
+		//! Wake up the polling thread
+		//! \note Requires '_lock' to be held
+		void signal();
+
+		//! Stop the polling
+		//! \note Requires '_lock' to be held
+		void deactivate(uint64_t now);
+
+		//! \returns The current time (steady clock, microseconds)
+		static uint64_t now();
+
+		//! Function polling the device
+		std::function<void()> _poll;
+
+		//! Protect the state of the scheduler
+		mutable std::mutex _lock;
+
+		//! Signal changes of the state on platforms without high resolution timer
+		std::condition_variable _signal;
+
+		//! Configuration
+		PollSchedulerSettings _settings;
+
+		//! Request the polling thread to exit
+		bool _stop{ false };
+
+		//! Indicate whether the scheduler is polling
+		bool _active{ false };
+
+		//! Current polling rate (Hz)
+		float _rate{ 0.0f };
+
+		//! Time of the next poll
+		uint64_t _deadline{ 0 };
+
+		//! Time the rate was last updated
+		uint64_t _rateTime{ 0 };
+
+		//! Time the scheduler started polling
+		uint64_t _activeSince{ 0 };
+
+		//! Time the scheduler was created
+		uint64_t _created{ 0 };
+
+		//! Counters
+		PollStatistics _stats;
+
+		//! Platform specific high resolution timer
+		void* _timer{ nullptr };
+
+		//! Platform specific event signalling changes of the state
+		void* _event{ nullptr };
+
+		//! Polling thread
+		std::thread _thread;
+	};
+}}
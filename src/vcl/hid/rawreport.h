@@ -0,0 +1,60 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <cstdint>
+
+// GSL
+#include <gsl/gsl>
+
+namespace Vcl { namespace HID
+{
+	//! Single input report of a device
+	struct RawReport
+	{
+		//! Backend specific handle of the device, which sent the report
+		void* device{ nullptr };
+
+		//! Report data, starting with the report ID
+		const uint8_t* data{ nullptr };
+
+		//! Size of the report in bytes
+		uint32_t size{ 0 };
+
+		//! Indicate whether the report was received while the application
+		//! was in the background
+		bool isBackground{ false };
+
+		//! Time the report was received (steady clock, microseconds)
+		uint64_t timestamp{ 0 };
+
+		//! Access the report data
+		gsl::span<const uint8_t> bytes() const { return { data, static_cast<std::ptrdiff_t>(size) }; }
+	};
+}}
@@ -0,0 +1,94 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "reportcoalescer.h"
+
+// C++ Standard library
+#include <cstring>
+
+namespace Vcl { namespace HID
+{
+	gsl::span<const ReportAction> ReportCoalescer::select(gsl::span<const RawReport> reports, InputStatistics& stats)
+	{
+		const size_t nr_reports = static_cast<size_t>(reports.size());
+		if (!isEnabled())
+		{
+			_actions.assign(nr_reports, ReportAction::Decode);
+			return _actions;
+		}
+
+		_actions.resize(nr_reports);
+
+		// Skip the reports, which repeat their predecessor
+		for (size_t i = 0; i < nr_reports; i++)
+		{
+			const bool duplicate = _suppressDuplicates && isDuplicate(reports[i].bytes());
+			_actions[i] = duplicate ? ReportAction::Skip : ReportAction::Decode;
+			if (duplicate)
+				stats.nrDuplicateReports++;
+		}
+
+		// Only the newest remaining report of each report ID is decoded completely
+		uint64_t seen[4] = {};
+		for (size_t i = nr_reports; i-- > 0;)
+		{
+			if (_actions[i] == ReportAction::Skip || reports[i].size == 0)
+				continue;
+
+			const uint8_t id = reports[i].data[0];
+			const uint64_t bit = uint64_t{ 1 } << (id % 64);
+			if (seen[id / 64] & bit)
+			{
+				_actions[i] = ReportAction::Accumulate;
+				stats.nrCoalescedReports++;
+			}
+			seen[id / 64] |= bit;
+		}
+
+		return _actions;
+	}
+
+	bool ReportCoalescer::isDuplicate(gsl::span<const uint8_t> report)
+	{
+		if (report.empty())
+			return false;
+
+		const uint8_t id = report[0];
+		const size_t size = static_cast<size_t>(report.size());
+		for (auto& previous : _previous)
+		{
+			if (previous.reportId != id)
+				continue;
+
+			if (previous.data.size() == size && std::memcmp(previous.data.data(), report.data(), size) == 0)
+				return true;
+
+			previous.data.assign(report.begin(), report.end());
+			return false;
+		}
+
+		_previous.push_back({ id, { report.begin(), report.end() } });
+		return false;
+	}
+}}
@@ -0,0 +1,117 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// GSL
+#include <gsl/gsl>
+
+// VCL
+#include <vcl/hid/inputstatistics.h>
+#include <vcl/hid/rawreport.h>
+
+namespace Vcl { namespace HID
+{
+	//! Processing required for a single report
+	enum class ReportAction : uint8_t
+	{
+		//! Report is identical to the previous one and does not need to be decoded
+		Skip,
+
+		//! Newer report with the same ID is pending. Only button edges
+		//! and relative values need to be decoded.
+		Accumulate,
+
+		//! Report needs to be decoded completely
+		Decode
+	};
+
+	/*!
+	 *	Select the reports of a device, which need to be decoded
+	 *
+	 *	Reports identical to the previous report with the same ID are
+	 *	skipped. Of several pending reports with the same ID, only the
+	 *	newest is decoded completely.
+	 *	The selection is used by the thread processing the input of the
+	 *	device; only enabling and disabling is allowed from other threads.
+	 */
+	class ReportCoalescer
+	{
+	public:
+		//! Enable the coalescing. If disabled, all reports are decoded.
+		void setEnabled(bool enable) { _isEnabled.store(enable, std::memory_order_relaxed); }
+
+		//! \returns True, if the coalescing is enabled
+		bool isEnabled() const { return _isEnabled.load(std::memory_order_relaxed); }
+
+		//! Allow skipping identical reports. Must be disabled for devices
+		//! reporting relative values, as identical reports carry movement.
+		void setSuppressDuplicates(bool suppress) { _suppressDuplicates = suppress; }
+
+		//! Decide how each report of a batch is processed
+		//! \param reports Reports of a single device in the order they were received
+		//! \param stats Counters of the skipped work
+		//! \returns One action per report, valid until the next call
+		gsl::span<const ReportAction> select(gsl::span<const RawReport> reports, InputStatistics& stats);
+
+		//! Forget the previously seen reports
+		void reset() { _previous.clear(); }
+
+	private:
+		//! Most recently decoded report of a report ID
+		struct PreviousReport
+		{
+			//! Report ID
+			uint8_t reportId;
+
+			//! Report data
+			std::vector<uint8_t> data;
+		};
+
+		//! Check whether a report is identical to its predecessor and
+		//! remember the report otherwise
+		bool isDuplicate(gsl::span<const uint8_t> report);
+
+	private:
+		//! Indicate whether coalescing is enabled
+		std::atomic<bool> _isEnabled{ false };
+
+		//! Indicate whether identical reports are skipped
+		bool _suppressDuplicates{ true };
+
+		//! Previous report of each report ID
+		std::vector<PreviousReport> _previous;
+
+		//! Actions of the current batch
+		std::vector<ReportAction> _actions;
+	};
+}}
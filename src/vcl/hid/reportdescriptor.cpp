@@ -0,0 +1,291 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "reportdescriptor.h"
+
+// C++ Standard library
+#include <array>
+
+namespace Vcl { namespace HID
+{
+	namespace
+	{
+		//! Item types of the short items
+		enum class ItemType
+		{
+			Main = 0,
+			Global = 1,
+			Local = 2
+		};
+
+		//! Main item tags
+		enum MainTag
+		{
+			Input = 0x8,
+			Output = 0x9,
+			Collection = 0xa,
+			Feature = 0xb,
+			EndCollection = 0xc
+		};
+
+		//! Global item tags
+		enum GlobalTag
+		{
+			UsagePage = 0x0,
+			LogicalMinimum = 0x1,
+			LogicalMaximum = 0x2,
+			PhysicalMinimum = 0x3,
+			PhysicalMaximum = 0x4,
+			UnitExponent = 0x5,
+			Unit = 0x6,
+			ReportSize = 0x7,
+			ReportId = 0x8,
+			ReportCount = 0x9,
+			Push = 0xa,
+			Pop = 0xb
+		};
+
+		//! Local item tags
+		enum LocalTag
+		{
+			Usage = 0x0,
+			UsageMinimum = 0x1,
+			UsageMaximum = 0x2
+		};
+
+		//! State shared by all following main items
+		struct GlobalState
+		{
+			uint16_t usagePage{ 0 };
+			int32_t logicalMinimum{ 0 };
+			int32_t logicalMaximum{ 0 };
+			uint32_t logicalMaximumSize{ 0 };
+			int32_t physicalMinimum{ 0 };
+			int32_t physicalMaximum{ 0 };
+			uint32_t units{ 0 };
+			uint32_t unitExponent{ 0 };
+			uint32_t reportSize{ 0 };
+			uint32_t reportCount{ 0 };
+			uint8_t reportId{ 0 };
+		};
+
+		//! Usage given by a local item. Extended usages carry their page.
+		struct LocalUsage
+		{
+			uint32_t usage;
+			bool isExtended;
+		};
+	}
+
+	bool ReportDescriptor::parse(gsl::span<const uint8_t> descriptor)
+	{
+		_error.clear();
+		_buttons.clear();
+		_values.clear();
+
+		std::vector<GlobalState> stack;
+		GlobalState global;
+
+		std::vector<LocalUsage> usages;
+		LocalUsage usage_minimum = {};
+		bool has_usage_minimum = false;
+
+		// Next free bit of each input report, behind the report ID byte
+		std::array<uint32_t, 256> input_bits;
+		input_bits.fill(8);
+
+		const size_t size = static_cast<size_t>(descriptor.size());
+		size_t pos = 0;
+		while (pos < size)
+		{
+			const uint8_t prefix = descriptor[pos++];
+
+			// Long items are not used by any known device
+			if (prefix == 0xfe)
+			{
+				if (pos + 2 > size)
+					break;
+				pos += 2 + descriptor[pos];
+				continue;
+			}
+
+			const uint32_t data_size = (prefix & 0x3) == 3 ? 4 : (prefix & 0x3);
+			const auto type = static_cast<ItemType>((prefix >> 2) & 0x3);
+			const uint32_t tag = prefix >> 4;
+			if (pos + data_size > size)
+			{
+				_error = "Truncated item";
+				return false;
+			}
+
+			uint32_t data = 0;
+			for (uint32_t i = 0; i < data_size; i++)
+				data |= uint32_t{ descriptor[pos + i] } << (8 * i);
+			pos += data_size;
+
+			// Sign extend the data for signed items
+			int32_t signed_data = static_cast<int32_t>(data);
+			if (data_size > 0 && data_size < 4 && (data >> (8 * data_size - 1)) & 1)
+				signed_data = static_cast<int32_t>(data | (~uint32_t{ 0 } << (8 * data_size)));
+
+			if (type == ItemType::Main)
+			{
+				if (tag == Input)
+				{
+					const bool is_constant = (data & 0x1) != 0;
+					const bool is_variable = (data & 0x2) != 0;
+					const bool is_absolute = (data & 0x4) == 0;
+
+					uint32_t& bit = input_bits[global.reportId];
+					if (!is_constant && !is_variable)
+					{
+						_error = "Array fields are not supported";
+						return false;
+					}
+
+					if (!is_constant)
+					{
+						// The logical maximum is unsigned, if the minimum is not negative
+						int32_t logical_maximum = global.logicalMaximum;
+						if (global.logicalMinimum >= 0 && logical_maximum < 0 && global.logicalMaximumSize < 4)
+							logical_maximum = static_cast<int32_t>(logical_maximum & ((1u << (8 * global.logicalMaximumSize)) - 1));
+
+						for (uint32_t i = 0; i < global.reportCount; i++)
+						{
+							LocalUsage local = {};
+							if (i < usages.size())
+								local = usages[i];
+							else if (has_usage_minimum)
+								local = { usage_minimum.usage + i - static_cast<uint32_t>(usages.size()), usage_minimum.isExtended };
+							else if (!usages.empty())
+								local = usages.back();
+
+							ReportField field;
+							field.reportId = global.reportId;
+							field.usagePage = local.isExtended ? static_cast<uint16_t>(local.usage >> 16) : global.usagePage;
+							field.usage = static_cast<uint16_t>(local.usage);
+							field.bit = bit + i * global.reportSize;
+							field.bitSize = global.reportSize;
+							field.logicalMinimum = global.logicalMinimum;
+							field.logicalMaximum = logical_maximum;
+							field.physicalMinimum = global.physicalMinimum;
+							field.physicalMaximum = global.physicalMaximum;
+							field.units = global.units;
+							field.unitExponent = global.unitExponent;
+							field.isAbsolute = is_absolute;
+
+							if (field.bitSize == 1)
+								_buttons.push_back(field);
+							else if (field.bitSize <= 32)
+								_values.push_back(field);
+							else
+							{
+								_error = "Fields wider than 32 bits are not supported";
+								return false;
+							}
+						}
+					}
+
+					bit += global.reportSize * global.reportCount;
+				}
+
+				// Local items only apply to the next main item
+				usages.clear();
+				has_usage_minimum = false;
+			}
+			else if (type == ItemType::Global)
+			{
+				switch (tag)
+				{
+				case UsagePage:      global.usagePage = static_cast<uint16_t>(data); break;
+				case LogicalMinimum: global.logicalMinimum = signed_data; break;
+				case LogicalMaximum: global.logicalMaximum = signed_data; global.logicalMaximumSize = data_size; break;
+				case PhysicalMinimum: global.physicalMinimum = signed_data; break;
+				case PhysicalMaximum: global.physicalMaximum = signed_data; break;
+				case UnitExponent:   global.unitExponent = data; break;
+				case Unit:           global.units = data; break;
+				case ReportSize:     global.reportSize = data; break;
+				case ReportCount:    global.reportCount = data; break;
+				case ReportId:
+					if (data == 0 || data > 0xff)
+					{
+						_error = "Invalid report ID";
+						return false;
+					}
+					global.reportId = static_cast<uint8_t>(data);
+					break;
+				case Push:
+					stack.push_back(global);
+					break;
+				case Pop:
+					if (stack.empty())
+					{
+						_error = "Unbalanced pop";
+						return false;
+					}
+					global = stack.back();
+					stack.pop_back();
+					break;
+				}
+			}
+			else if (type == ItemType::Local)
+			{
+				switch (tag)
+				{
+				case Usage:
+					usages.push_back({ data, data_size == 4 });
+					break;
+				case UsageMinimum:
+					usage_minimum = { data, data_size == 4 };
+					has_usage_minimum = true;
+					break;
+				case UsageMaximum:
+					break;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	std::vector<ButtonLocation> ReportDescriptor::buttonLocations() const
+	{
+		std::vector<ButtonLocation> locations;
+		locations.reserve(_buttons.size());
+		for (const auto& button : _buttons)
+			locations.push_back({ button.reportId, button.bit });
+
+		return locations;
+	}
+
+	std::vector<ValueLocation> ReportDescriptor::valueLocations() const
+	{
+		std::vector<ValueLocation> locations;
+		locations.reserve(_values.size());
+		for (const auto& value : _values)
+			locations.push_back({ value.reportId, value.bit, static_cast<uint8_t>(value.bitSize), value.logicalMinimum < 0 });
+
+		return locations;
+	}
+}}
@@ -0,0 +1,123 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// GSL
+#include <gsl/gsl>
+
+// VCL
+#include <vcl/hid/decodeplan.h>
+
+namespace Vcl { namespace HID
+{
+	//! Input field described by a report descriptor
+	struct ReportField
+	{
+		//! ID of the report containing the field
+		uint8_t reportId;
+
+		//! Usage page of the field
+		uint16_t usagePage;
+
+		//! Usage of the field
+		uint16_t usage;
+
+		//! Position of the field. Counted from the start of the report,
+		//! including the report ID byte.
+		uint32_t bit;
+
+		//! Number of bits of the field
+		uint32_t bitSize;
+
+		//! Minimum logical value
+		int32_t logicalMinimum;
+
+		//! Maximum logical value
+		int32_t logicalMaximum;
+
+		//! Minimum physical value
+		int32_t physicalMinimum;
+
+		//! Maximum physical value
+		int32_t physicalMaximum;
+
+		//! Unit of the physical values
+		uint32_t units;
+
+		//! Exponent of the physical unit
+		uint32_t unitExponent;
+
+		//! Indicate whether the field reports absolute values
+		bool isAbsolute;
+	};
+
+	/*!
+	 *	Parser for HID report descriptors
+	 *
+	 *	Extracts the variable fields of the input reports. Single bit
+	 *	fields are treated as buttons, wider fields as values, matching
+	 *	the classification of the Windows HID parser.
+	 */
+	class ReportDescriptor
+	{
+	public:
+		//! Parse a report descriptor
+		//! \returns True, if the descriptor was valid and supported
+		bool parse(gsl::span<const uint8_t> descriptor);
+
+		//! \returns The reason why the last descriptor could not be parsed
+		const std::string& error() const { return _error; }
+
+		//! Access the buttons in the order of the descriptor
+		const std::vector<ReportField>& buttons() const { return _buttons; }
+
+		//! Access the values in the order of the descriptor
+		const std::vector<ReportField>& values() const { return _values; }
+
+		//! \returns The location of the buttons as used by a decode plan
+		std::vector<ButtonLocation> buttonLocations() const;
+
+		//! \returns The location of the values as used by a decode plan
+		std::vector<ValueLocation> valueLocations() const;
+
+	private:
+		//! Reason why the last descriptor could not be parsed
+		std::string _error;
+
+		//! Input buttons
+		std::vector<ReportField> _buttons;
+
+		//! Input values
+		std::vector<ReportField> _values;
+	};
+}}
@@ -0,0 +1,206 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// VCL
+#include <vcl/core/contract.h>
+
+namespace Vcl { namespace HID
+{
+	template<typename Signature, size_t Capacity = 32>
+	class SmallFunction;
+
+	/*!
+	 *	Type-erased callable with inline storage
+	 *
+	 *	Callables fitting into 'Capacity' bytes are stored inline, thus
+	 *	typical lambdas capturing a few pointers do not allocate. Larger
+	 *	callables are stored on the heap. The function can be moved, but
+	 *	not copied.
+	 */
+	template<typename R, typename... Args, size_t Capacity>
+	class SmallFunction<R(Args...), Capacity>
+	{
+	public:
+		SmallFunction() noexcept = default;
+		SmallFunction(std::nullptr_t) noexcept {}
+
+		template<typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, SmallFunction>::value>>
+		SmallFunction(F&& func)
+		{
+			using Callable = std::decay_t<F>;
+			if constexpr (isStoredInline<Callable>())
+			{
+				new (_storage) Callable(std::forward<F>(func));
+				_ops = inlineOperations<Callable>();
+			}
+			else
+			{
+				*reinterpret_cast<Callable**>(_storage) = new Callable(std::forward<F>(func));
+				_ops = heapOperations<Callable>();
+			}
+		}
+
+		SmallFunction(SmallFunction&& other) noexcept
+		{
+			moveFrom(other);
+		}
+
+		SmallFunction(const SmallFunction&) = delete;
+
+		~SmallFunction()
+		{
+			reset();
+		}
+
+		SmallFunction& operator=(SmallFunction&& other) noexcept
+		{
+			if (this != &other)
+			{
+				reset();
+				moveFrom(other);
+			}
+			return *this;
+		}
+
+		SmallFunction& operator=(const SmallFunction&) = delete;
+
+		//! \returns True, if a callable is stored
+		explicit operator bool() const noexcept { return _ops != nullptr; }
+
+		//! \returns True, if the callable is stored without allocation
+		bool isInline() const noexcept { return _ops && _ops->isInline; }
+
+		//! Invoke the stored callable
+		//! \note The function must not be empty.
+		R operator()(Args... args) const
+		{
+			VclRequire(_ops, "Function is not empty.");
+
+			return _ops->invoke(const_cast<unsigned char*>(_storage), std::forward<Args>(args)...);
+		}
+
+		//! Destroy the stored callable
+		void reset() noexcept
+		{
+			if (_ops)
+				_ops->destroy(_storage);
+			_ops = nullptr;
+		}
+
+	private:
+		//! Type specific operations on the storage
+		struct Operations
+		{
+			R (*invoke)(void* storage, Args&&... args);
+			void (*move)(void* dst, void* src) noexcept;
+			void (*destroy)(void* storage) noexcept;
+			bool isInline;
+		};
+
+		//! \returns True, if a callable of type 'F' is stored inline
+		template<typename F>
+		static constexpr bool isStoredInline()
+		{
+			return
+				sizeof(F) <= Capacity &&
+				alignof(F) <= alignof(std::max_align_t) &&
+				std::is_nothrow_move_constructible<F>::value;
+		}
+
+		template<typename F>
+		static const Operations* inlineOperations()
+		{
+			static constexpr Operations ops =
+			{
+				[](void* storage, Args&&... args) -> R
+				{
+					return (*static_cast<F*>(storage))(std::forward<Args>(args)...);
+				},
+				[](void* dst, void* src) noexcept
+				{
+					new (dst) F(std::move(*static_cast<F*>(src)));
+					static_cast<F*>(src)->~F();
+				},
+				[](void* storage) noexcept
+				{
+					static_cast<F*>(storage)->~F();
+				},
+				true
+			};
+			return &ops;
+		}
+
+		template<typename F>
+		static const Operations* heapOperations()
+		{
+			static constexpr Operations ops =
+			{
+				[](void* storage, Args&&... args) -> R
+				{
+					return (**static_cast<F**>(storage))(std::forward<Args>(args)...);
+				},
+				[](void* dst, void* src) noexcept
+				{
+					*static_cast<F**>(dst) = *static_cast<F**>(src);
+				},
+				[](void* storage) noexcept
+				{
+					delete *static_cast<F**>(storage);
+				},
+				false
+			};
+			return &ops;
+		}
+
+		//! Take the callable of another function
+		void moveFrom(SmallFunction& other) noexcept
+		{
+			if (other._ops)
+			{
+				other._ops->move(_storage, other._storage);
+				_ops = other._ops;
+				other._ops = nullptr;
+			}
+		}
+
+		static_assert(Capacity >= sizeof(void*), "Storage can hold a pointer");
+
+		//! Storage of the callable, or of the pointer to the callable
+		alignas(std::max_align_t) unsigned char _storage[Capacity];
+
+		//! Operations of the stored callable, null if empty
+		const Operations* _ops{ nullptr };
+	};
+}}
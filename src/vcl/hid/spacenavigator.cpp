@@ -26,24 +26,153 @@
 
 // C++ standard library
 #include <algorithm>
+#include <chrono>
+#include <utility>
 
 namespace Vcl { namespace HID
 {
 	const unsigned int SpaceNavigator::LogitechVendorID = 0x46d;
 	const float SpaceNavigator::AngularVelocity = 8.0e-6f;
 	
-	std::vector<SpaceNavigatorHandler*> SpaceNavigator::_handlers;
+	namespace
+	{
+		//! Handlers receiving the events of all devices
+		struct GlobalHandlers
+		{
+			//! Serialize the registration of the handlers
+			std::mutex lock;
+
+			//! Subscriptions of the registered handlers
+			std::vector<std::pair<SpaceNavigatorHandler*, HandlerRegistry<SpaceNavigatorEvent>::Id>> handlers;
+
+			//! Subscriptions passing the events to the handlers
+			HandlerRegistry<SpaceNavigatorEvent> registry;
+		};
+
+		GlobalHandlers& globalHandlers()
+		{
+			static GlobalHandlers handlers;
+			return handlers;
+		}
+	}
 
 	void SpaceNavigator::registerHandler(SpaceNavigatorHandler* handler)
-	{		
-		if (std::find(_handlers.begin(), _handlers.end(), handler) == _handlers.end())
-			_handlers.push_back(handler);
+	{
+		auto& global = globalHandlers();
+		std::lock_guard<std::mutex> guard{ global.lock };
+
+		auto it = std::find_if(global.handlers.begin(), global.handlers.end(), [handler](const auto& entry)
+		{
+			return entry.first == handler;
+		});
+		if (it != global.handlers.end())
+			return;
+
+		const auto id = global.registry.subscribe(SpaceNavigatorEvent::AllEvents, [handler](const SpaceNavigatorEvent& event)
+		{
+			switch (event.type)
+			{
+			case SpaceNavigatorEvent::Move:
+				handler->onSpaceMouseMove(event.device, event.motion);
+				break;
+			case SpaceNavigatorEvent::KeyDown:
+				handler->onSpaceMouseKeyDown(event.device, event.virtualKey);
+				break;
+			case SpaceNavigatorEvent::KeyUp:
+				handler->onSpaceMouseKeyUp(event.device, event.virtualKey);
+				break;
+			}
+		});
+		global.handlers.emplace_back(handler, id);
 	}
 
 	void SpaceNavigator::unregisterHandler(SpaceNavigatorHandler* handler)
 	{
-		auto it = std::find(_handlers.begin(), _handlers.end(), handler);
-		if (it != _handlers.end())
-			_handlers.erase(it);
+		auto& global = globalHandlers();
+		std::lock_guard<std::mutex> guard{ global.lock };
+
+		auto it = std::find_if(global.handlers.begin(), global.handlers.end(), [handler](const auto& entry)
+		{
+			return entry.first == handler;
+		});
+		if (it == global.handlers.end())
+			return;
+
+		global.registry.unsubscribe(it->second);
+		global.handlers.erase(it);
+	}
+
+	void SpaceNavigator::dispatchEvent(const SpaceNavigatorEvent& event) const
+	{
+		_subscriptions.dispatch(event.type, event);
+		globalHandlers().registry.dispatch(event.type, event);
+	}
+
+	std::array<float, 6> SpaceNavigator::scaleMotion(const std::array<float, 6>& axes) const
+	{
+		// See "Programming for the 3D Mouse", Section 5.1.3
+		const float speed = (_speed == Speed::Low ? 0.25f : _speed == Speed::High ? 4.0f : 1.0f);
+
+		// v = w * r,  we don't know r yet so lets assume r=1.
+		const float scale = AngularVelocity * speed;
+
+		std::array<float, 6> motion = _filter.apply(axes);
+		for (auto& axis : motion)
+			axis *= scale;
+
+		return motion;
+	}
+
+	void SpaceNavigator::accumulateMotion(const std::array<float, 6>& velocity, uint64_t timestamp)
+	{
+		std::lock_guard<std::mutex> guard{ _motionLock };
+
+		// Reports delivered in a single batch share their arrival time,
+		// although the device sent them one report period apart
+		const uint64_t sample_time = (_sampleTime != 0 && timestamp <= _sampleTime) ? _sampleTime + ReportPeriod : timestamp;
+
+		// The previous sample holds until the new one was received
+		integrateMotion(sample_time);
+
+		_velocity = velocity;
+		_sampleTime = sample_time;
+		if (_integratedTime < sample_time)
+			_integratedTime = sample_time;
+	}
+
+	SpaceNavigatorMotion SpaceNavigator::consumeMotion()
+	{
+		const auto now = std::chrono::steady_clock::now().time_since_epoch();
+		const auto timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+
+		std::lock_guard<std::mutex> guard{ _motionLock };
+
+		integrateMotion(timestamp);
+
+		SpaceNavigatorMotion motion = _motion;
+		_motion = {};
+		return motion;
+	}
+
+	void SpaceNavigator::integrateMotion(uint64_t timestamp)
+	{
+		if (_sampleTime == 0)
+			return;
+
+		// Devices send samples continuously while they are moved. Samples
+		// are not extrapolated beyond the point the next one was due.
+		const uint64_t end = std::min(timestamp, _sampleTime + MaxSampleInterval);
+		if (end <= _integratedTime)
+			return;
+
+		const uint64_t duration = end - _integratedTime;
+		const float ms = static_cast<float>(duration) * 1.0e-3f;
+		for (size_t axis = 0; axis < 3; axis++)
+		{
+			_motion.translation[axis] += _velocity[axis] * ms;
+			_motion.rotation[axis] += _velocity[axis + 3] * ms;
+		}
+		_motion.duration += duration;
+		_integratedTime = end;
 	}
 }}
@@ -29,16 +29,34 @@
 
 // C++ standard libary
 #include <array>
+#include <atomic>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <vector>
 
 // VCL
+#include <vcl/hid/handlerregistry.h>
 #include <vcl/hid/multiaxiscontroller.h>
+#include <vcl/hid/spacenavigatorfilter.h>
 #include <vcl/hid/spacenavigatorhandler.h>
 
 namespace Vcl { namespace HID
 {
+	//! Motion of a 3D mouse over a period of time, in the units passed
+	//! to 'SpaceNavigatorHandler::onSpaceMouseMove'
+	struct SpaceNavigatorMotion
+	{
+		//! Pan zoom displacement (x, y, z)
+		std::array<float, 3> translation{};
+
+		//! Rotation vector (x, y, z)
+		std::array<float, 3> rotation{};
+
+		//! Time covered by the motion (microseconds)
+		uint64_t duration{ 0 };
+	};
+
 	/*!
 	 *	Managing class for the 3Dconnexion SpaceNavigator.
 	 *	\note The code is an adapted version of the SDK code stripped free of the 
@@ -62,15 +80,97 @@ namespace Vcl { namespace HID
 		static const float AngularVelocity;
 
 	public: // Handler management
+		//! Callback receiving the events of a single device
+		using Callback = HandlerRegistry<SpaceNavigatorEvent>::Callback;
+
+		//! Identification of a subscription
+		using SubscriptionId = HandlerRegistry<SpaceNavigatorEvent>::Id;
+
+		//! Register a handler receiving the events of all devices
 		static void registerHandler(SpaceNavigatorHandler* handler);
 		static void unregisterHandler(SpaceNavigatorHandler* handler);
 
+		//! Subscribe to the events of this device
+		//! \param mask Types of the events passed to the callback (see 'SpaceNavigatorEvent')
+		//! \param callback Callback receiving the events
+		//! \returns The identification of the subscription
+		//! \note Subscriptions may be changed from any thread, even from within a callback.
+		SubscriptionId subscribe(uint32_t mask, Callback callback) { return _subscriptions.subscribe(mask, std::move(callback)); }
+
+		//! Remove a subscription
+		//! \returns True, if the subscription existed
+		bool unsubscribe(SubscriptionId id) { return _subscriptions.unsubscribe(id); }
+
 	public: // Configuration
 		//! Set the speed configuration
 		void setSpeed(Speed speed) { _speed = speed; }
 
+	public: // Motion accumulation
+		//! Integrate the motion of the device instead of passing every
+		//! sample to the handlers. The key handlers are still called.
+		//! Every sample is integrated, even if the reports are coalesced.
+		void setMotionAccumulation(bool enable) { _accumulateMotion.store(enable, std::memory_order_relaxed); }
+
+		//! \returns True, if the motion is integrated
+		bool motionAccumulation() const { return _accumulateMotion.load(std::memory_order_relaxed); }
+
+		//! Take the motion integrated since the last call
+		//! \note May be called from any thread, usually once per frame.
+		SpaceNavigatorMotion consumeMotion();
+
+		//! Access the filter applied to the motion
+		//! \note The filter may be configured from any thread.
+		SpaceNavigatorFilter& filter() { return _filter; }
+		const SpaceNavigatorFilter& filter() const { return _filter; }
+
+	protected: // Motion accumulation
+		//! Apply the filters and the speed to the logical axis values
+		//! \returns The motion per millisecond
+		std::array<float, 6> scaleMotion(const std::array<float, 6>& axes) const;
+
+		//! Integrate a new sample
+		//! \param velocity Motion per millisecond as returned by 'scaleMotion'
+		//! \param timestamp Time the sample was received (steady clock, microseconds)
+		void accumulateMotion(const std::array<float, 6>& velocity, uint64_t timestamp);
+
+		//! Longest time a sample is assumed to persist without receiving
+		//! a new one (microseconds)
+		static const uint64_t MaxSampleInterval = 100000;
+
+		//! Nominal interval between two reports of the device (microseconds).
+		//! Samples received at the same time are spread by this interval.
+		static const uint64_t ReportPeriod = 8000;
+
+	private:
+		//! Integrate the last sample up to a point in time
+		//! \note Requires '_motionLock' to be held
+		void integrateMotion(uint64_t timestamp);
+
+		//! Indicate whether the motion is integrated
+		std::atomic<bool> _accumulateMotion{ false };
+
+		//! Protect the integrated motion
+		std::mutex _motionLock;
+
+		//! Last sample
+		std::array<float, 6> _velocity{};
+
+		//! Time of the last sample, zero if there is none
+		uint64_t _sampleTime{ 0 };
+
+		//! Time up to which the motion is integrated
+		uint64_t _integratedTime{ 0 };
+
+		//! Motion integrated since the last drain
+		SpaceNavigatorMotion _motion;
+
 	protected: // Handlers
-		static std::vector<SpaceNavigatorHandler*> _handlers;
+		//! Pass an event to the subscriptions of this device and to the registered handlers
+		void dispatchEvent(const SpaceNavigatorEvent& event) const;
+
+	private:
+		//! Subscriptions to the events of this device
+		HandlerRegistry<SpaceNavigatorEvent> _subscriptions;
 
 	protected: // Configuration
 		//! Only process values when application is in foreground
@@ -79,10 +179,7 @@ namespace Vcl { namespace HID
 		//! Speed of the mouse motion
 		Speed _speed{ Speed::Mid };
 
-		//! Enable pan/zoom
-		bool _isPanZoom{ true };
-
-		//! Enable rotation
-		bool _isRotate{ true };
+		//! Filter applied to the motion
+		SpaceNavigatorFilter _filter;
 	};
 }}
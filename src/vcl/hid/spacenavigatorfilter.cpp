@@ -0,0 +1,161 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "spacenavigatorfilter.h"
+
+// C++ Standard library
+#include <memory>
+
+// VCL
+#include <vcl/hid/epoch.h>
+#include <vcl/hid/spacenavigatorvirtualkeys.h>
+
+namespace Vcl { namespace HID
+{
+	namespace
+	{
+		//! Axes padded to a multiple of the SIMD width
+		using Lanes = Eigen::Array<float, 8, 1>;
+
+		//! Reclamation of the replaced configurations of all filters
+		EpochDomain& filterEpochs()
+		{
+			static EpochDomain epochs;
+			return epochs;
+		}
+	}
+
+	struct SpaceNavigatorFilter::State
+	{
+		//! Configuration the state was prepared from
+		SpaceNavigatorFilterSettings settings;
+
+		//! Sensitivity of the axes, zero for disabled axes and padding
+		Lanes gain;
+
+		//! Weight of the linear part of the response
+		Lanes linear;
+
+		//! Weight of the cubic part of the response
+		Lanes cubic;
+	};
+
+	SpaceNavigatorFilter::SpaceNavigatorFilter()
+	{
+		std::lock_guard<std::mutex> guard{ _writeLock };
+		publish({});
+	}
+
+	SpaceNavigatorFilter::~SpaceNavigatorFilter()
+	{
+		// No reader can access the filter anymore
+		delete _state.load();
+	}
+
+	void SpaceNavigatorFilter::configure(const SpaceNavigatorFilterSettings& settings)
+	{
+		std::lock_guard<std::mutex> guard{ _writeLock };
+		publish(settings);
+	}
+
+	SpaceNavigatorFilterSettings SpaceNavigatorFilter::settings() const
+	{
+		const auto guard = filterEpochs().pin();
+		return _state.load(std::memory_order_seq_cst)->settings;
+	}
+
+	bool SpaceNavigatorFilter::handleKey(unsigned int virtual_key)
+	{
+		std::lock_guard<std::mutex> guard{ _writeLock };
+
+		// Only writers replace the state, thus it stays valid while the lock is held
+		auto settings = _state.load(std::memory_order_seq_cst)->settings;
+		switch (virtual_key)
+		{
+		case V3DK_DOMINANT:
+			settings.dominantAxis = !settings.dominantAxis;
+			break;
+		case V3DK_PANZOOM:
+			settings.axisMask ^= 0x07;
+			break;
+		case V3DK_ROTATE:
+			settings.axisMask ^= 0x38;
+			break;
+		default:
+			return false;
+		}
+
+		publish(settings);
+		return true;
+	}
+
+	void SpaceNavigatorFilter::publish(const SpaceNavigatorFilterSettings& settings)
+	{
+		auto state = std::make_unique<State>();
+		state->settings = settings;
+		state->gain.setZero();
+		state->linear.setOnes();
+		state->cubic.setZero();
+		for (int axis = 0; axis < 6; axis++)
+		{
+			const float curve = settings.curve[axis] < 0.0f ? 0.0f : (settings.curve[axis] > 1.0f ? 1.0f : settings.curve[axis]);
+			if (settings.axisMask & (1u << axis))
+				state->gain[axis] = settings.sensitivity[axis];
+			state->linear[axis] = 1.0f - curve;
+			state->cubic[axis] = curve;
+		}
+
+		auto old_state = _state.exchange(state.release(), std::memory_order_seq_cst);
+		if (old_state)
+		{
+			filterEpochs().retire(const_cast<State*>(old_state));
+			filterEpochs().collect();
+		}
+	}
+
+	std::array<float, 6> SpaceNavigatorFilter::apply(const std::array<float, 6>& axes) const
+	{
+		const auto guard = filterEpochs().pin();
+		const State& state = *_state.load(std::memory_order_seq_cst);
+
+		Lanes x;
+		x << axes[0], axes[1], axes[2], axes[3], axes[4], axes[5], 0.0f, 0.0f;
+
+		// Response curve and sensitivity
+		Lanes y = state.gain * x * (state.linear + state.cubic * x.square());
+
+		// Keep only the strongest axis
+		if (state.settings.dominantAxis)
+		{
+			Lanes::Index dominant = 0;
+			y.abs().maxCoeff(&dominant);
+
+			Lanes selected = Lanes::Zero();
+			selected[dominant] = y[dominant];
+			y = selected;
+		}
+
+		return { y[0], y[1], y[2], y[3], y[4], y[5] };
+	}
+}}
@@ -0,0 +1,102 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+#include <vcl/config/eigen.h>
+
+// C++ Standard library
+#include <array>
+#include <atomic>
+#include <mutex>
+
+namespace Vcl { namespace HID
+{
+	//! Configuration of the filter applied to the motion of a 3D mouse.
+	//! Axes are ordered translation (x, y, z), rotation (x, y, z).
+	struct SpaceNavigatorFilterSettings
+	{
+		//! Only pass the axis with the largest deflection
+		bool dominantAxis{ false };
+
+		//! Axes passing the filter, bit 'i' enables axis 'i'
+		uint32_t axisMask{ 0x3f };
+
+		//! Sensitivity of each axis
+		std::array<float, 6> sensitivity{ { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f } };
+
+		//! Response curve of each axis, blending between a linear (0)
+		//! and a cubic (1) response to the deflection
+		std::array<float, 6> curve{};
+	};
+
+	/*!
+	 *	Filter applied to the normalized deflection of a 3D mouse
+	 *
+	 *	The filter processes all axes at once. Its configuration is replaced
+	 *	atomically, thus it can be changed from any thread without blocking
+	 *	the thread processing the input.
+	 */
+	class SpaceNavigatorFilter
+	{
+	public:
+		SpaceNavigatorFilter();
+		SpaceNavigatorFilter(const SpaceNavigatorFilter&) = delete;
+		~SpaceNavigatorFilter();
+
+		SpaceNavigatorFilter& operator=(const SpaceNavigatorFilter&) = delete;
+
+		//! Replace the configuration
+		void configure(const SpaceNavigatorFilterSettings& settings);
+
+		//! \returns The current configuration
+		SpaceNavigatorFilterSettings settings() const;
+
+		//! Change the configuration according to a key of the device
+		//! \param virtual_key Pressed key ('V3DK_DOMINANT', 'V3DK_ROTATE' or 'V3DK_PANZOOM')
+		//! \returns True, if the key changed the configuration
+		bool handleKey(unsigned int virtual_key);
+
+		//! Filter the deflection of the axes
+		//! \param axes Normalized deflection of the axes
+		//! \returns The filtered deflection
+		std::array<float, 6> apply(const std::array<float, 6>& axes) const;
+
+	private:
+		//! Configuration prepared for processing all axes at once
+		struct State;
+
+		//! Publish a new configuration
+		//! \note Requires '_writeLock' to be held
+		void publish(const SpaceNavigatorFilterSettings& settings);
+
+		//! Current configuration
+		std::atomic<const State*> _state{ nullptr };
+
+		//! Serialize changes of the configuration
+		std::mutex _writeLock;
+	};
+}}
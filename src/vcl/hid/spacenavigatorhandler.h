@@ -29,6 +29,7 @@
 
 // C++ standard library
 #include <array>
+#include <cstdint>
 
 // VCL
 #include <vcl/hid/spacenavigatorvirtualkeys.h>
@@ -38,6 +39,29 @@ namespace Vcl { namespace HID
 	//! Forward declaration
 	class SpaceNavigator;
 
+	//! Event of a 3D mouse
+	struct SpaceNavigatorEvent
+	{
+		//! Event types, usable as subscription mask
+		static const uint32_t Move = 0x1;
+		static const uint32_t KeyDown = 0x2;
+		static const uint32_t KeyUp = 0x4;
+		static const uint32_t AllEvents = Move | KeyDown | KeyUp;
+
+		//! Type of the event
+		uint32_t type{ 0 };
+
+		//! Device that triggered the event
+		const SpaceNavigator* device{ nullptr };
+
+		//! Displacement data of a 'Move' event.
+		//! See 'SpaceNavigatorHandler::onSpaceMouseMove'
+		std::array<float, 6> motion{};
+
+		//! 3d mouse key code of a 'KeyDown' or 'KeyUp' event
+		unsigned int virtualKey{ 0 };
+	};
+
 	//! Callback interface 
 	class SpaceNavigatorHandler
 	{
@@ -0,0 +1,151 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <array>
+#include <cstdint>
+
+// VCL
+#include <vcl/hid/bitfield.h>
+#include <vcl/hid/spacenavigatorvirtualkeys.h>
+
+namespace Vcl { namespace HID
+{
+	/*!
+	 *	Translation of the key state of a 3Dconnexion device to virtual keys
+	 *
+	 *	Bit 'i' of the key state reports the HID key code 'i + 1'. Devices
+	 *	released before 2009 use device specific key codes, the key codes of
+	 *	later devices are the virtual keys.
+	 */
+	struct SpaceMouseKeymap
+	{
+		//! Virtual key of each bit of the key state
+		std::array<uint8_t, 32> keys{};
+
+		//! Bits of the key state associated with a virtual key
+		uint32_t mask{ 0 };
+
+		//! Report the keys changed between two key states
+		//! \param previous Previous key state
+		//! \param current Current key state
+		//! \param func Called with the virtual key and the new state (true if pressed)
+		//!             of each changed key, in the order of the bits
+		template<typename Func>
+		void translate(uint32_t previous, uint32_t current, Func&& func) const
+		{
+			for (uint32_t changed = (previous ^ current) & mask; changed != 0; changed &= changed - 1)
+			{
+				const uint32_t bit = findFirstSet(changed);
+				func(static_cast<unsigned int>(keys[bit]), ((current >> bit) & 1) != 0);
+			}
+		}
+	};
+
+	//! Create a keymap from a table of virtual keys indexed by HID key code
+	template<size_t N>
+	constexpr SpaceMouseKeymap makeSpaceMouseKeymap(const e3dmouse_virtual_key (&table)[N])
+	{
+		SpaceMouseKeymap keymap;
+		for (size_t code = 1; code < N && code <= keymap.keys.size(); code++)
+		{
+			if (table[code] == V3DK_INVALID)
+				continue;
+
+			keymap.keys[code - 1] = static_cast<uint8_t>(table[code]);
+			keymap.mask |= 1u << (code - 1);
+		}
+		return keymap;
+	}
+
+	//! Create a keymap for devices, which report the virtual keys as HID key codes
+	//! \param nr_keys Number of keys of the device, at most 32
+	constexpr SpaceMouseKeymap makeSpaceMouseKeymap(uint32_t nr_keys)
+	{
+		SpaceMouseKeymap keymap;
+		for (uint32_t code = 1; code <= nr_keys && code <= keymap.keys.size(); code++)
+		{
+			keymap.keys[code - 1] = static_cast<uint8_t>(code);
+			keymap.mask |= 1u << (code - 1);
+		}
+		return keymap;
+	}
+
+	//! Description of a device model of the 3Dconnexion product line
+	struct SpaceMouseModel
+	{
+		//! Vendor ID
+		uint16_t vendorId;
+
+		//! Product ID
+		uint16_t productId;
+
+		//! Keys of the device
+		SpaceMouseKeymap keymap;
+	};
+
+	//! Vendor ID of the devices released by 3Dconnexion under their own ID
+	const uint16_t ThreeDconnexionVendorID = 0x256f;
+
+	//! Vendor ID of the devices released by 3Dconnexion under the ID of Logitech
+	const uint16_t LogitechVendorID = 0x046d;
+
+	//! Supported devices. Receivers serve devices with different numbers of keys.
+	constexpr std::array<SpaceMouseModel, 15> SpaceMouseModels =
+	{{
+		{ LogitechVendorID,        eSpaceTraveler,                 makeSpaceMouseKeymap(8) },
+		{ LogitechVendorID,        eSpacePilot,                    makeSpaceMouseKeymap(SpacePilotKeys) },
+		{ LogitechVendorID,        eSpaceNavigator,                makeSpaceMouseKeymap(2) },
+		{ LogitechVendorID,        eSpaceExplorer,                 makeSpaceMouseKeymap(SpaceExplorerKeys) },
+		{ LogitechVendorID,        eSpaceNavigatorForNotebooks,    makeSpaceMouseKeymap(2) },
+		{ LogitechVendorID,        eSpacePilotPRO,                 makeSpaceMouseKeymap(32) },
+		{ LogitechVendorID,        eSpaceMousePro,                 makeSpaceMouseKeymap(32) },
+		{ ThreeDconnexionVendorID, eSpaceMousePro,                 makeSpaceMouseKeymap(32) },
+		{ ThreeDconnexionVendorID, eSpaceMouseWireless,            makeSpaceMouseKeymap(2) },
+		{ ThreeDconnexionVendorID, eSpaceMouseWirelessReceiver,    makeSpaceMouseKeymap(2) },
+		{ ThreeDconnexionVendorID, eSpaceMouseProWireless,         makeSpaceMouseKeymap(32) },
+		{ ThreeDconnexionVendorID, eSpaceMouseProWirelessReceiver, makeSpaceMouseKeymap(32) },
+		{ ThreeDconnexionVendorID, eSpaceMouseEnterprise,          makeSpaceMouseKeymap(32) },
+		{ ThreeDconnexionVendorID, eSpaceMouseCompact,             makeSpaceMouseKeymap(2) },
+		{ ThreeDconnexionVendorID, eUniversalReceiver,             makeSpaceMouseKeymap(32) },
+	}};
+
+	//! Find the description of a device
+	//! \returns The model, or null if the device is not part of the 3Dconnexion product line
+	//! \note Intended to be called once when the device is added.
+	inline const SpaceMouseModel* findSpaceMouseModel(uint32_t vendor_id, uint32_t product_id)
+	{
+		for (const auto& model : SpaceMouseModels)
+		{
+			if (model.vendorId == vendor_id && model.productId == product_id)
+				return &model;
+		}
+		return nullptr;
+	}
+}}
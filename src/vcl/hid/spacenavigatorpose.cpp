@@ -0,0 +1,128 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "spacenavigatorpose.h"
+
+// C++ Standard library
+#include <cmath>
+
+namespace Vcl { namespace HID
+{
+	SpaceNavigatorPose::SpaceNavigatorPose(Frame frame, Reference reference)
+	: _frame(frame)
+	, _reference(reference)
+	{
+		updateTransform();
+	}
+
+	void SpaceNavigatorPose::setFrame(Frame frame)
+	{
+		_frame = frame;
+		updateTransform();
+	}
+
+	void SpaceNavigatorPose::setSensitivity(float translation, float rotation)
+	{
+		_translationScale = translation;
+		_rotationScale = rotation;
+		updateTransform();
+	}
+
+	void SpaceNavigatorPose::reset(const Eigen::Quaternionf& orientation, const Eigen::Vector3f& position)
+	{
+		_orientation = orientation.normalized();
+		_position = position;
+	}
+
+	void SpaceNavigatorPose::updateTransform()
+	{
+		// Rotation from the device frame to the user frame. Rotation vectors
+		// transform like the translation, as the rotation is proper.
+		Eigen::Matrix3f rotation = Eigen::Matrix3f::Identity();
+		switch (_frame)
+		{
+		case Frame::Device:
+			break;
+		case Frame::YUp:
+			rotation << 1, 0,  0,
+			            0, 0, -1,
+			            0, 1,  0;
+			break;
+		case Frame::ZUp:
+			rotation << 1,  0,  0,
+			            0, -1,  0,
+			            0,  0, -1;
+			break;
+		}
+
+		_transform.setZero();
+		_transform.topLeftCorner<3, 3>() = _translationScale * rotation;
+		_transform.bottomRightCorner<3, 3>() = _rotationScale * rotation;
+	}
+
+	void SpaceNavigatorPose::integrate(const std::array<float, 6>& motion)
+	{
+		const Eigen::Matrix<float, 6, 1> user = _transform * Eigen::Map<const Eigen::Matrix<float, 6, 1>>(motion.data());
+		const Eigen::Vector3f translation = user.head<3>();
+		const Eigen::Vector3f rotation = user.tail<3>();
+
+		// Exponential map of the rotation vector
+		const float angle = rotation.norm();
+		Eigen::Quaternionf delta = Eigen::Quaternionf::Identity();
+		if (angle > 0.0f)
+			delta = Eigen::Quaternionf{ Eigen::AngleAxisf{ angle, rotation / angle } };
+
+		if (_reference == Reference::World)
+		{
+			// Rotate about the pivot given in the user frame
+			_position = delta * (_position - _pivot) + _pivot + translation;
+			_orientation = delta * _orientation;
+		}
+		else
+		{
+			// Rotate about the pivot given in the object frame
+			const Eigen::Vector3f pivot = _orientation * _pivot;
+			_position += _orientation * translation + pivot - (_orientation * delta) * _pivot;
+			_orientation = _orientation * delta;
+		}
+		_orientation.normalize();
+	}
+
+	void SpaceNavigatorPose::integrate(const SpaceNavigatorMotion& motion)
+	{
+		integrate(std::array<float, 6>
+		{
+			motion.translation[0], motion.translation[1], motion.translation[2],
+			motion.rotation[0], motion.rotation[1], motion.rotation[2]
+		});
+	}
+
+	Eigen::Matrix4f SpaceNavigatorPose::matrix() const
+	{
+		Eigen::Matrix4f transform = Eigen::Matrix4f::Identity();
+		transform.topLeftCorner<3, 3>() = _orientation.toRotationMatrix();
+		transform.topRightCorner<3, 1>() = _position;
+		return transform;
+	}
+}}
@@ -0,0 +1,148 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+#include <vcl/config/eigen.h>
+
+// C++ Standard library
+#include <array>
+
+// VCL
+#include <vcl/hid/spacenavigator.h>
+
+namespace Vcl { namespace HID
+{
+	/*!
+	 *	Integration of the motion of a 3D mouse into the pose of an object
+	 *
+	 *	The device reports its motion in a right-handed coordinate system
+	 *	with z pointing down. The motion is converted to the user frame with
+	 *	a single 6x6 transform, which is computed when the configuration
+	 *	changes. Rotation vectors are integrated into a quaternion, which
+	 *	is normalized after every step to avoid drift.
+	 */
+	class SpaceNavigatorPose
+	{
+	public:
+		//! Coordinate system of the pose
+		enum class Frame
+		{
+			//! Frame of the device: x right, y towards the user, z down
+			Device,
+
+			//! x right, y up, z towards the user
+			YUp,
+
+			//! x right, y away from the user, z up
+			ZUp
+		};
+
+		//! Frame in which the motion is applied
+		enum class Reference
+		{
+			//! Move the object relative to the user frame
+			World,
+
+			//! Move the object relative to its own axes
+			Local
+		};
+
+	public:
+		//! \param frame Coordinate system of the pose
+		//! \param reference Frame in which the motion is applied
+		SpaceNavigatorPose(Frame frame = Frame::YUp, Reference reference = Reference::World);
+
+		//! Set the coordinate system of the pose
+		void setFrame(Frame frame);
+
+		//! \returns The coordinate system of the pose
+		Frame frame() const { return _frame; }
+
+		//! Set the frame in which the motion is applied
+		void setReference(Reference reference) { _reference = reference; }
+
+		//! \returns The frame in which the motion is applied
+		Reference reference() const { return _reference; }
+
+		//! Set the point the object rotates about
+		//! \param pivot Pivot point in the user frame (World) or in the object frame (Local)
+		void setPivot(const Eigen::Vector3f& pivot) { _pivot = pivot; }
+
+		//! \returns The point the object rotates about
+		const Eigen::Vector3f& pivot() const { return _pivot; }
+
+		//! Scale the translation and the rotation
+		void setSensitivity(float translation, float rotation);
+
+		//! Reset the pose
+		void reset(const Eigen::Quaternionf& orientation = Eigen::Quaternionf::Identity(), const Eigen::Vector3f& position = Eigen::Vector3f::Zero());
+
+		//! Integrate an incremental motion
+		//! \param motion Motion as passed to 'SpaceNavigatorHandler::onSpaceMouseMove'
+		void integrate(const std::array<float, 6>& motion);
+
+		//! Integrate the motion drained from a device
+		void integrate(const SpaceNavigatorMotion& motion);
+
+		//! \returns The orientation of the object
+		const Eigen::Quaternionf& orientation() const { return _orientation; }
+
+		//! \returns The position of the object
+		const Eigen::Vector3f& position() const { return _position; }
+
+		//! \returns The transform from the object to the user frame
+		Eigen::Matrix4f matrix() const;
+
+	private:
+		//! Recompute the transform from the device to the user frame
+		void updateTransform();
+
+		//! Coordinate system of the pose
+		Frame _frame;
+
+		//! Frame in which the motion is applied
+		Reference _reference;
+
+		//! Scale of the translation
+		float _translationScale{ 1.0f };
+
+		//! Scale of the rotation
+		float _rotationScale{ 1.0f };
+
+		//! Transform of the motion from the device to the user frame
+		Eigen::Matrix<float, 6, 6> _transform;
+
+		//! Orientation of the object
+		Eigen::Quaternionf _orientation{ Eigen::Quaternionf::Identity() };
+
+		//! Position of the object
+		Eigen::Vector3f _position{ Eigen::Vector3f::Zero() };
+
+		//! Point the object rotates about
+		Eigen::Vector3f _pivot{ Eigen::Vector3f::Zero() };
+	};
+}}
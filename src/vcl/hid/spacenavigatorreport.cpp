@@ -0,0 +1,90 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "spacenavigatorreport.h"
+
+namespace Vcl { namespace HID
+{
+	namespace
+	{
+		//! Load a little-endian, signed 16 bit value
+		inline int16_t load16le(const uint8_t* data)
+		{
+			return static_cast<int16_t>(static_cast<uint16_t>(data[0] | (data[1] << 8)));
+		}
+
+		//! Load the three 16 bit values of a vector
+		inline void loadVector(const uint8_t* data, int16_t* values)
+		{
+			values[0] = load16le(data + 0);
+			values[1] = load16le(data + 2);
+			values[2] = load16le(data + 4);
+		}
+	}
+
+	uint32_t decodeSpaceNavigatorReport(gsl::span<const uint8_t> report, SpaceNavigatorSample& sample)
+	{
+		const size_t size = static_cast<size_t>(report.size());
+		if (size == 0)
+			return 0;
+
+		const uint8_t* data = report.data();
+		switch (data[0])
+		{
+		case 0x01:
+		{
+			if (size < 7)
+				return 0;
+
+			loadVector(data + 1, sample.axes.data());
+			if (size < 13)
+				return SpaceNavigatorSample::Translation;
+
+			// High-speed report containing the rotation as well
+			loadVector(data + 7, sample.axes.data() + 3);
+			return SpaceNavigatorSample::Translation | SpaceNavigatorSample::Rotation;
+		}
+		case 0x02:
+		{
+			if (size < 7)
+				return 0;
+
+			loadVector(data + 1, sample.axes.data() + 3);
+			return SpaceNavigatorSample::Rotation;
+		}
+		case 0x03:
+		{
+			// Devices send between one and four bytes of key state
+			uint32_t keystate = 0;
+			for (size_t i = 1; i < size && i <= 4; i++)
+				keystate |= uint32_t{ data[i] } << (8 * (i - 1));
+
+			sample.keystate = keystate;
+			return SpaceNavigatorSample::Keystate;
+		}
+		default:
+			return 0;
+		}
+	}
+}}
@@ -0,0 +1,72 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <array>
+#include <cstdint>
+
+// GSL
+#include <gsl/gsl>
+
+namespace Vcl { namespace HID
+{
+	/*!
+	 *	Content of the reports of a 3Dconnexion SpaceNavigator
+	 *
+	 *	Older devices send the translation (ID 0x01) and the rotation (ID 0x02)
+	 *	in separate reports, newer devices send both in a single 13 byte
+	 *	report with ID 0x01. The key state is sent in reports with ID 0x03.
+	 */
+	struct SpaceNavigatorSample
+	{
+		//! The report contained the translation
+		static const uint32_t Translation = 0x1;
+
+		//! The report contained the rotation
+		static const uint32_t Rotation = 0x2;
+
+		//! The report contained the key state
+		static const uint32_t Keystate = 0x4;
+
+		//! Logical values of the translation (x, y, z) and the rotation (x, y, z)
+		std::array<int16_t, 6> axes{};
+
+		//! State of the keys, bit 0 is the first key
+		uint32_t keystate{ 0 };
+	};
+
+	//! Decode a single report of a SpaceNavigator
+	//! \param report Report data, starting with the report ID
+	//! \param sample Sample receiving the decoded values. Values not contained
+	//!               in the report are not changed.
+	//! \returns The parts of the sample contained in the report, zero if the
+	//!          report is not known
+	//! \note Does not depend on the platform or the alignment of the report.
+	uint32_t decodeSpaceNavigatorReport(gsl::span<const uint8_t> report, SpaceNavigatorSample& sample);
+}}
@@ -37,7 +37,16 @@ namespace Vcl { namespace HID
       eSpaceNavigator = 0xc626,
       eSpaceExplorer = 0xc627,
       eSpaceNavigatorForNotebooks = 0xc628,
-      eSpacePilotPRO = 0xc629
+      eSpacePilotPRO = 0xc629,
+      eSpaceTraveler = 0xc623,
+      eSpaceMousePro = 0xc62b,
+      eSpaceMouseWireless = 0xc62e,
+      eSpaceMouseWirelessReceiver = 0xc62f,
+      eSpaceMouseProWireless = 0xc631,
+      eSpaceMouseProWirelessReceiver = 0xc632,
+      eSpaceMouseEnterprise = 0xc633,
+      eSpaceMouseCompact = 0xc635,
+      eUniversalReceiver = 0xc652
    };
 
    enum e3dmouse_virtual_key 
@@ -68,14 +77,7 @@ namespace Vcl { namespace HID
    };
 #endif // VCL_DEVICE_SPACENAVIGATOR_TRACE_VIRTUAL_KEYS
 
-   struct tag_VirtualKeys
-   {
-      e3dconnexion_pid pid;
-      size_t nKeys;
-      e3dmouse_virtual_key *vkeys;
-   };
-
-   static const e3dmouse_virtual_key SpaceExplorerKeys [] = 
+   constexpr e3dmouse_virtual_key SpaceExplorerKeys [] = 
    {
       V3DK_INVALID     // there is no button 0
       , V3DK_1, V3DK_2
@@ -86,7 +88,7 @@ namespace Vcl { namespace HID
       , V3DK_ROTATE
    };
 
-   static const e3dmouse_virtual_key SpacePilotKeys [] = 
+   constexpr e3dmouse_virtual_key SpacePilotKeys [] = 
    {
       V3DK_INVALID 
       , V3DK_1, V3DK_2, V3DK_3, V3DK_4, V3DK_5, V3DK_6
@@ -96,52 +98,5 @@ namespace Vcl { namespace HID
       , V3DK_PLUS, V3DK_MINUS
       , V3DK_DOMINANT, V3DK_ROTATE
    };
-
-   static const struct tag_VirtualKeys _3dmouseVirtualKeys[]= 
-   {
-      eSpacePilot
-      , sizeof(SpacePilotKeys)/sizeof(SpacePilotKeys[0])
-      , const_cast<e3dmouse_virtual_key *>(SpacePilotKeys),
-      eSpaceExplorer
-      , sizeof(SpaceExplorerKeys)/sizeof(SpaceExplorerKeys[0])
-      , const_cast<e3dmouse_virtual_key *>(SpaceExplorerKeys)
-   };
-
-   /*-----------------------------------------------------------------------------
-    *
-    * unsigned short HidToVirtualKey(unsigned short pid, unsigned short hidKeyCode)
-    *
-    * Args:
-    *    pid - USB Product ID (PID) of 3D mouse device 
-    *    hidKeyCode - Hid keycode as retrieved from a Raw Input packet
-    *
-    * Return Value:
-    *    Returns the standard 3d mouse virtual key (button identifier) or zero if an error occurs.
-    *
-    * Description:
-    *    Converts a hid device keycode (button identifier) of a pre-2009 3Dconnexion USB device
-    *    to the standard 3d mouse virtual key definition.
-    *
-    *---------------------------------------------------------------------------*/
-   inline unsigned short HidToVirtualKey(unsigned long pid, unsigned short hidKeyCode)
-   {
-      unsigned short virtualkey=hidKeyCode;
-      for (size_t i=0; i<sizeof(_3dmouseVirtualKeys)/sizeof(_3dmouseVirtualKeys[0]); ++i)
-      {
-         if (pid == _3dmouseVirtualKeys[i].pid)
-         {
-            if (hidKeyCode < _3dmouseVirtualKeys[i].nKeys)
-               virtualkey = _3dmouseVirtualKeys[i].vkeys[hidKeyCode];
-            else
-               virtualkey = V3DK_INVALID;
-            break;
-         }
-      }
-
-#if VCL_DEVICE_SPACENAVIGATOR_TRACE_VIRTUAL_KEYS
-      TRACE("Converted %d to %s for pid 0x%x\n", hidKeyCode, _3dmouse_virtual_key[virtualkey], pid);
-#endif // VCL_DEVICE_SPACENAVIGATOR_TRACE_VIRTUAL_KEYS
-      return virtualkey;
-   }
 }}
 VCL_END_EXTERNAL_HEADERS
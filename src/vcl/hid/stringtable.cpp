@@ -0,0 +1,68 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "stringtable.h"
+
+// C++ Standard library
+#include <algorithm>
+#include <cstring>
+
+namespace Vcl { namespace HID
+{
+	std::string_view StringTable::intern(std::string_view str)
+	{
+		if (str.empty())
+			return {};
+
+		std::lock_guard<std::mutex> guard{ _lock };
+
+		const auto entry = _strings.find(str);
+		if (entry != _strings.end())
+			return *entry;
+
+		// Strings larger than a block get their own block
+		if (str.size() > _blockFree)
+		{
+			const auto block_size = std::max(BlockSize, str.size());
+			_blocks.emplace_back(std::make_unique<char[]>(block_size));
+			_blockCursor = _blocks.back().get();
+			_blockFree = block_size;
+		}
+
+		char* data = _blockCursor;
+		std::memcpy(data, str.data(), str.size());
+		_blockCursor += str.size();
+		_blockFree -= str.size();
+
+		std::string_view stored{ data, str.size() };
+		_strings.emplace(stored);
+		return stored;
+	}
+
+	size_t StringTable::size() const
+	{
+		std::lock_guard<std::mutex> guard{ _lock };
+		return _strings.size();
+	}
+}}
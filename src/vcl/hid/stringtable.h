@@ -0,0 +1,79 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace Vcl { namespace HID
+{
+	/*!
+	 *	Table of interned UTF-8 strings
+	 *
+	 *	Strings are copied once into large memory blocks owned by the table.
+	 *	The returned views stay valid for the lifetime of the table.
+	 */
+	class StringTable
+	{
+	public:
+		StringTable() = default;
+		StringTable(const StringTable&) = delete;
+		StringTable& operator=(const StringTable&) = delete;
+
+		//! Add a string to the table
+		//! \param str String to intern
+		//! \returns A view on the unique copy of the string
+		std::string_view intern(std::string_view str);
+
+		//! \returns The number of unique strings in the table
+		size_t size() const;
+
+	private:
+		//! Default size of a memory block
+		static const size_t BlockSize = 4096;
+
+		//! Protect concurrent access to the table
+		mutable std::mutex _lock;
+
+		//! Lookup of the stored strings
+		std::unordered_set<std::string_view> _strings;
+
+		//! Memory blocks holding the string data
+		std::vector<std::unique_ptr<char[]>> _blocks;
+
+		//! Next free character in the current block
+		char* _blockCursor{ nullptr };
+
+		//! Remaining space in the current block
+		size_t _blockFree{ 0 };
+	};
+}}
@@ -0,0 +1,214 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "timerwheel.h"
+
+// C++ Standard library
+#include <algorithm>
+
+namespace Vcl { namespace HID
+{
+	namespace
+	{
+		//! Number of bits addressing the slots of a level
+		const uint32_t SlotBits = 6;
+
+		//! \returns The index of the lowest set bit
+		uint32_t lowestBit(uint64_t value)
+		{
+			uint32_t idx = 0;
+			while ((value & 1) == 0)
+			{
+				value >>= 1;
+				idx++;
+			}
+			return idx;
+		}
+
+		//! \returns 'value' rotated right by 'shift' bits
+		uint64_t rotateRight(uint64_t value, uint32_t shift)
+		{
+			shift &= 63;
+			return shift == 0 ? value : (value >> shift) | (value << (64 - shift));
+		}
+	}
+
+	TimerWheel::TimerWheel(uint64_t now, uint64_t tick)
+	: _tick(std::max<uint64_t>(tick, 1))
+	, _current(now / _tick)
+	{
+		_slots.fill(InvalidNode);
+	}
+
+	TimerWheel::Handle TimerWheel::schedule(uint64_t deadline, const TimerEvent& event)
+	{
+		uint32_t node = _free;
+		if (node != InvalidNode)
+		{
+			_free = _nodes[node].next;
+		}
+		else
+		{
+			node = static_cast<uint32_t>(_nodes.size());
+			_nodes.push_back({ 0, {}, InvalidNode, InvalidNode, 0, InvalidNode });
+		}
+
+		// Round up in order to never expire early. Timers in the past
+		// expire with the next tick.
+		const uint64_t expires = (deadline + _tick - 1) / _tick;
+		_nodes[node].expires = std::max(expires, _current + 1);
+		_nodes[node].event = event;
+		insert(node);
+		_size++;
+
+		return { node, _nodes[node].generation };
+	}
+
+	bool TimerWheel::cancel(Handle& handle)
+	{
+		const uint32_t node = handle.node;
+		const bool is_pending =
+			node < _nodes.size() &&
+			_nodes[node].generation == handle.generation &&
+			_nodes[node].slot != InvalidNode;
+		handle = {};
+		if (!is_pending)
+			return false;
+
+		unlink(node);
+		release(node);
+		return true;
+	}
+
+	size_t TimerWheel::cancelAll(const void* target)
+	{
+		size_t nr_cancelled = 0;
+		for (uint32_t node = 0; node < static_cast<uint32_t>(_nodes.size()); node++)
+		{
+			if (_nodes[node].slot != InvalidNode && _nodes[node].event.target == target)
+			{
+				unlink(node);
+				release(node);
+				nr_cancelled++;
+			}
+		}
+
+		return nr_cancelled;
+	}
+
+	uint64_t TimerWheel::nextDeadline() const
+	{
+		if (_size == 0)
+			return std::numeric_limits<uint64_t>::max();
+
+		return nextTick() * _tick;
+	}
+
+	void TimerWheel::insert(uint32_t node)
+	{
+		const uint64_t expires = _nodes[node].expires;
+		const uint64_t delta = expires > _current ? expires - _current : 0;
+
+		// Timers beyond the range of the wheel wait in the last slot
+		// reachable on the highest level and are sorted again from there
+		uint32_t level = 0;
+		while (level < NrLevels - 1 && delta >= (uint64_t{ 1 } << (SlotBits * (level + 1))))
+			level++;
+
+		uint64_t position = expires >> (SlotBits * level);
+		const uint64_t max_position = (_current >> (SlotBits * level)) + NrSlots - 1;
+		if (position > max_position)
+			position = max_position;
+
+		const uint32_t slot = level * NrSlots + static_cast<uint32_t>(position % NrSlots);
+		_nodes[node].slot = slot;
+		_nodes[node].prev = InvalidNode;
+		_nodes[node].next = _slots[slot];
+		if (_slots[slot] != InvalidNode)
+			_nodes[_slots[slot]].prev = node;
+		_slots[slot] = node;
+		_occupied[level] |= uint64_t{ 1 } << (slot % NrSlots);
+	}
+
+	void TimerWheel::unlink(uint32_t node)
+	{
+		auto& entry = _nodes[node];
+		if (entry.prev != InvalidNode)
+			_nodes[entry.prev].next = entry.next;
+		else
+			_slots[entry.slot] = entry.next;
+		if (entry.next != InvalidNode)
+			_nodes[entry.next].prev = entry.prev;
+
+		if (_slots[entry.slot] == InvalidNode)
+			_occupied[entry.slot / NrSlots] &= ~(uint64_t{ 1 } << (entry.slot % NrSlots));
+
+		entry.slot = InvalidNode;
+	}
+
+	void TimerWheel::release(uint32_t node)
+	{
+		auto& entry = _nodes[node];
+		entry.generation++;
+		entry.event = {};
+		entry.next = _free;
+		_free = node;
+		_size--;
+	}
+
+	void TimerWheel::cascade(uint32_t level)
+	{
+		const uint32_t slot = level * NrSlots + static_cast<uint32_t>((_current >> (SlotBits * level)) % NrSlots);
+
+		uint32_t node = _slots[slot];
+		_slots[slot] = InvalidNode;
+		_occupied[level] &= ~(uint64_t{ 1 } << (slot % NrSlots));
+		while (node != InvalidNode)
+		{
+			const uint32_t next = _nodes[node].next;
+			insert(node);
+			node = next;
+		}
+	}
+
+	uint64_t TimerWheel::nextTick() const
+	{
+		uint64_t next = std::numeric_limits<uint64_t>::max();
+		for (uint32_t level = 0; level < NrLevels; level++)
+		{
+			if (_occupied[level] == 0)
+				continue;
+
+			// Distance to the next occupied slot after the current one
+			const uint32_t shift = SlotBits * level;
+			const uint64_t position = _current >> shift;
+			const uint64_t pending = rotateRight(_occupied[level], static_cast<uint32_t>((position + 1) % NrSlots));
+			const uint64_t distance = lowestBit(pending) + 1;
+
+			next = std::min(next, (position + distance) << shift);
+		}
+
+		return next;
+	}
+}}
@@ -0,0 +1,239 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Vcl { namespace HID
+{
+	//! Payload of a timer
+	struct TimerEvent
+	{
+		//! Object owning the timer
+		const void* target{ nullptr };
+
+		//! Owner defined type of the timer
+		uint32_t type{ 0 };
+
+		//! Owner defined data
+		uint32_t data{ 0 };
+	};
+
+	/*!
+	 *	Hierarchical timer wheel
+	 *
+	 *	Timers are sorted into slots of four levels, each covering 64 times
+	 *	the range of the level below. Scheduling and cancelling a timer is
+	 *	constant time, timers are moved to a lower level once they get close
+	 *	to their deadline. Timers never expire early, but may expire up to
+	 *	one tick late.
+	 *	The wheel is not synchronized.
+	 */
+	class TimerWheel
+	{
+	public:
+		//! Number of slots per level
+		static constexpr uint32_t NrSlots = 64;
+
+		//! Number of levels
+		static constexpr uint32_t NrLevels = 4;
+
+		//! Marker of an invalid node
+		static constexpr uint32_t InvalidNode = std::numeric_limits<uint32_t>::max();
+
+		//! Identification of a scheduled timer
+		struct Handle
+		{
+			//! Node of the timer
+			uint32_t node{ InvalidNode };
+
+			//! Generation of the node when the timer was scheduled
+			uint32_t generation{ 0 };
+
+			//! \returns True, if the handle refers to a timer
+			bool isValid() const { return node != InvalidNode; }
+		};
+
+	public:
+		//! \param now Current time (microseconds)
+		//! \param tick Resolution of the wheel (microseconds)
+		explicit TimerWheel(uint64_t now = 0, uint64_t tick = 1000);
+
+		//! Schedule a new timer
+		//! \param deadline Time at which the timer expires (microseconds)
+		//! \param event Payload passed back once the timer expired
+		//! \returns The handle of the timer
+		Handle schedule(uint64_t deadline, const TimerEvent& event);
+
+		//! Cancel a pending timer and invalidate its handle
+		//! \returns True, if the timer was pending
+		bool cancel(Handle& handle);
+
+		//! Cancel all the timers of an owner
+		//! \returns The number of cancelled timers
+		//! \note Visits all the pending timers
+		size_t cancelAll(const void* target);
+
+		//! \returns The number of pending timers
+		size_t size() const { return _size; }
+
+		//! \returns The earliest time at which the wheel needs to be advanced,
+		//!          the maximum value if no timer is pending. The time may be
+		//!          earlier than the next expiry, if timers need to be moved
+		//!          to a lower level.
+		uint64_t nextDeadline() const;
+
+		//! Advance the wheel and expire the timers
+		//! \param now Current time (microseconds)
+		//! \param func Function called with the 'TimerEvent' of each expired timer.
+		//!             It may schedule and cancel timers.
+		//! \returns The number of expired timers
+		template<typename Func>
+		size_t advance(uint64_t now, Func&& func);
+
+	private:
+		//! Timer stored in the wheel
+		struct Node
+		{
+			//! Tick at which the timer expires
+			uint64_t expires;
+
+			//! Payload
+			TimerEvent event;
+
+			//! Previous node in the slot
+			uint32_t prev;
+
+			//! Next node in the slot, or next free node
+			uint32_t next;
+
+			//! Incremented whenever the node is released
+			uint32_t generation;
+
+			//! Slot containing the node, 'InvalidNode' if the node is free
+			uint32_t slot;
+		};
+
+		//! Sort a node into the slot matching its expiry
+		void insert(uint32_t node);
+
+		//! Remove a node from its slot
+		void unlink(uint32_t node);
+
+		//! Return a node to the free list
+		void release(uint32_t node);
+
+		//! Move the timers of a slot to the levels matching their expiry
+		void cascade(uint32_t level);
+
+		//! \returns The next tick at which the wheel has to do work
+		uint64_t nextTick() const;
+
+		//! Expire the timers of the current tick
+		//! \param func Function called for each expired timer
+		//! \returns The number of expired timers
+		template<typename Func>
+		size_t step(Func& func);
+
+		//! Resolution of the wheel (microseconds)
+		uint64_t _tick;
+
+		//! Current tick
+		uint64_t _current;
+
+		//! Number of pending timers
+		size_t _size{ 0 };
+
+		//! Storage of the timers
+		std::vector<Node> _nodes;
+
+		//! First free node
+		uint32_t _free{ InvalidNode };
+
+		//! First node of each slot
+		std::array<uint32_t, NrLevels * NrSlots> _slots;
+
+		//! Non-empty slots of each level
+		std::array<uint64_t, NrLevels> _occupied{};
+	};
+
+	template<typename Func>
+	size_t TimerWheel::advance(uint64_t now, Func&& func)
+	{
+		const uint64_t target = now / _tick;
+
+		size_t nr_expired = 0;
+		while (_current < target)
+		{
+			// Skip the ticks without any work
+			const uint64_t next = _size > 0 ? nextTick() : target;
+			if (next > target)
+			{
+				_current = target;
+				break;
+			}
+
+			_current = next;
+			nr_expired += step(func);
+		}
+
+		return nr_expired;
+	}
+
+	template<typename Func>
+	size_t TimerWheel::step(Func& func)
+	{
+		// Higher levels move their timers down once the lower levels wrapped around
+		for (uint32_t level = NrLevels - 1; level > 0; level--)
+		{
+			const uint64_t mask = (uint64_t{ 1 } << (6 * level)) - 1;
+			if ((_current & mask) == 0)
+				cascade(level);
+		}
+
+		// Expire the timers one by one, as the function may change the slot
+		const uint32_t slot = static_cast<uint32_t>(_current % NrSlots);
+		size_t nr_expired = 0;
+		while (_slots[slot] != InvalidNode)
+		{
+			const uint32_t node = _slots[slot];
+			const TimerEvent event = _nodes[node].event;
+			unlink(node);
+			release(node);
+
+			func(event);
+			nr_expired++;
+		}
+
+		return nr_expired;
+	}
+}}
@@ -0,0 +1,149 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "units.h"
+
+namespace Vcl { namespace HID
+{
+	namespace
+	{
+		//! Unit systems of the unit item
+		enum UnitSystem
+		{
+			SiLinear = 1,
+			SiRotation = 2,
+			EnglishLinear = 3,
+			EnglishRotation = 4
+		};
+
+		//! Read a 4-bit two's complement number
+		int nibble(uint32_t value, int idx)
+		{
+			const int n = static_cast<int>((value >> (4 * idx)) & 0xf);
+			return n >= 8 ? n - 16 : n;
+		}
+
+		double power10(int exponent)
+		{
+			double result = 1;
+			for (int i = 0; i < exponent; i++)
+				result *= 10;
+			for (int i = 0; i > exponent; i--)
+				result /= 10;
+			return result;
+		}
+
+		//! Determine the canonical unit and the factor converting to it
+		PhysicalUnit convert(uint32_t units, double& factor)
+		{
+			factor = 1;
+			if (units == 0)
+				return PhysicalUnit::None;
+
+			const int system = static_cast<int>(units & 0xf);
+			const int length = nibble(units, 1);
+			const int mass = nibble(units, 2);
+			const int time = nibble(units, 3);
+			const int others = static_cast<int>(units >> 16);
+			if (others != 0)
+				return PhysicalUnit::Unknown;
+
+			const bool is_rotation = system == SiRotation || system == EnglishRotation;
+			const bool is_english = system == EnglishLinear || system == EnglishRotation;
+
+			// Length unit in millimetres (linear) or degrees (rotation)
+			double length_factor = 1;
+			if (system == SiLinear)
+				length_factor = 10;
+			else if (system == SiRotation)
+				length_factor = 57.29577951308232;
+			else if (system == EnglishLinear)
+				length_factor = 25.4;
+			else if (system == EnglishRotation)
+				length_factor = 1;
+			else
+				return PhysicalUnit::Unknown;
+
+			// Mass unit in grams
+			const double mass_factor = is_english ? 14593.90294 : 1;
+
+			if (length == 1 && mass == 0 && time == 0)
+			{
+				factor = length_factor;
+				return is_rotation ? PhysicalUnit::Degree : PhysicalUnit::Millimeter;
+			}
+			if (length == 1 && mass == 0 && time == -1)
+			{
+				factor = length_factor;
+				return is_rotation ? PhysicalUnit::DegreePerSecond : PhysicalUnit::MillimeterPerSecond;
+			}
+			if (length == 0 && mass == 1 && time == 0)
+			{
+				factor = mass_factor;
+				return PhysicalUnit::Gram;
+			}
+			if (length == 0 && mass == 0 && time == 1)
+			{
+				return PhysicalUnit::Second;
+			}
+			if (length == 1 && mass == 1 && time == -2 && !is_rotation)
+			{
+				// g mm / s^2 to kg m / s^2
+				factor = length_factor * mass_factor * 1e-6;
+				return PhysicalUnit::Newton;
+			}
+
+			return PhysicalUnit::Unknown;
+		}
+	}
+
+	PhysicalScale physicalScale
+	(
+		int32_t logical_minimum, int32_t logical_maximum,
+		int32_t physical_minimum, int32_t physical_maximum,
+		uint32_t units, uint32_t unit_exponent
+	)
+	{
+		// Without a physical range, physical values equal the logical values
+		if (physical_minimum == 0 && physical_maximum == 0)
+		{
+			physical_minimum = logical_minimum;
+			physical_maximum = logical_maximum;
+		}
+
+		double factor = 1;
+		PhysicalScale result;
+		result.unit = convert(units, factor);
+		factor *= power10(nibble(unit_exponent, 0));
+
+		const double logical_range = static_cast<double>(logical_maximum) - logical_minimum;
+		const double physical_range = static_cast<double>(physical_maximum) - physical_minimum;
+		const double scale = logical_range != 0 ? physical_range / logical_range : 1;
+
+		result.scale = static_cast<float>(scale * factor);
+		result.offset = static_cast<float>((physical_minimum - logical_minimum * scale) * factor);
+
+		return result;
+	}
+}}
@@ -0,0 +1,95 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <cstdint>
+
+namespace Vcl { namespace HID
+{
+	//! Units physical values are converted to
+	enum class PhysicalUnit
+	{
+		//! No unit given, the physical value is the scaled logical value
+		None,
+
+		//! Length in millimetres
+		Millimeter,
+
+		//! Angle in degrees
+		Degree,
+
+		//! Mass in grams
+		Gram,
+
+		//! Time in seconds
+		Second,
+
+		//! Force in newtons
+		Newton,
+
+		//! Linear velocity in millimetres per second
+		MillimeterPerSecond,
+
+		//! Angular velocity in degrees per second
+		DegreePerSecond,
+
+		//! Unit not supported, the value is in the unit of the device
+		Unknown
+	};
+
+	//! Linear mapping of logical values to a physical unit
+	struct PhysicalScale
+	{
+		//! Physical value of a logical value
+		float operator()(int32_t value) const { return static_cast<float>(value) * scale + offset; }
+
+		//! Scale of the logical value
+		float scale{ 1 };
+
+		//! Offset of the scaled value
+		float offset{ 0 };
+
+		//! Unit of the physical value
+		PhysicalUnit unit{ PhysicalUnit::None };
+	};
+
+	//! Compute the mapping of logical values to physical units
+	//! \param logical_minimum Minimum logical value
+	//! \param logical_maximum Maximum logical value
+	//! \param physical_minimum Minimum physical value
+	//! \param physical_maximum Maximum physical value
+	//! \param units Unit as encoded in the report descriptor
+	//! \param unit_exponent Unit exponent as encoded in the report descriptor (4-bit two's complement)
+	PhysicalScale physicalScale
+	(
+		int32_t logical_minimum, int32_t logical_maximum,
+		int32_t physical_minimum, int32_t physical_maximum,
+		uint32_t units, uint32_t unit_exponent
+	);
+}}
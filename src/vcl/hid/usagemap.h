@@ -0,0 +1,170 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <array>
+#include <cstdint>
+
+namespace Vcl { namespace HID
+{
+	//! HID usage pages with mapped usages
+	namespace UsagePage
+	{
+		const uint16_t GenericDesktop     = 0x01;
+		const uint16_t SimulationControls = 0x02;
+		const uint16_t GameControls       = 0x05;
+		const uint16_t Consumer           = 0x0c;
+	}
+
+	//! State slots shared by joysticks and gamepads. The first entries
+	//! correspond to 'JoystickAxis' and 'GamepadAxis'.
+	namespace UsageSlot
+	{
+		const uint8_t X           = 0;
+		const uint8_t Y           = 1;
+		const uint8_t Z           = 2;
+		const uint8_t RX          = 3;
+		const uint8_t RY          = 4;
+		const uint8_t RZ          = 5;
+		const uint8_t Slider      = 6;
+		const uint8_t Slider2     = 7;
+		const uint8_t Dial        = 8;
+		const uint8_t Wheel       = 9;
+		const uint8_t Throttle    = 10;
+		const uint8_t Rudder      = 11;
+		const uint8_t Accelerator = 12;
+		const uint8_t Brake       = 13;
+		const uint8_t Steering    = 14;
+
+		//! Number of axis slots
+		const uint8_t NrAxes      = 15;
+
+		//! Hat switch
+		const uint8_t Hat         = 0xfe;
+
+		//! Usage without associated state
+		const uint8_t None        = 0xff;
+	}
+
+	//! Association of a usage with a state slot
+	struct UsageMapping
+	{
+		uint16_t usagePage;
+		uint16_t usage;
+		uint8_t slot;
+	};
+
+	//! Usages mapped to the state of joysticks and gamepads, ordered by page and usage
+	constexpr std::array<UsageMapping, 29> UsageMap =
+	{{
+		{ UsagePage::GenericDesktop,     0x30, UsageSlot::X },
+		{ UsagePage::GenericDesktop,     0x31, UsageSlot::Y },
+		{ UsagePage::GenericDesktop,     0x32, UsageSlot::Z },
+		{ UsagePage::GenericDesktop,     0x33, UsageSlot::RX },
+		{ UsagePage::GenericDesktop,     0x34, UsageSlot::RY },
+		{ UsagePage::GenericDesktop,     0x35, UsageSlot::RZ },
+		{ UsagePage::GenericDesktop,     0x36, UsageSlot::Slider },
+		{ UsagePage::GenericDesktop,     0x37, UsageSlot::Dial },
+		{ UsagePage::GenericDesktop,     0x38, UsageSlot::Wheel },
+		{ UsagePage::GenericDesktop,     0x39, UsageSlot::Hat },
+		{ UsagePage::SimulationControls, 0xb0, UsageSlot::X },           // Aileron
+		{ UsagePage::SimulationControls, 0xb8, UsageSlot::Y },           // Elevator
+		{ UsagePage::SimulationControls, 0xba, UsageSlot::Rudder },
+		{ UsagePage::SimulationControls, 0xbb, UsageSlot::Throttle },
+		{ UsagePage::SimulationControls, 0xc4, UsageSlot::Accelerator },
+		{ UsagePage::SimulationControls, 0xc5, UsageSlot::Brake },
+		{ UsagePage::SimulationControls, 0xc6, UsageSlot::Slider },      // Clutch
+		{ UsagePage::SimulationControls, 0xc8, UsageSlot::Steering },
+		{ UsagePage::GameControls,       0x21, UsageSlot::Hat },         // Point of view
+		{ UsagePage::GameControls,       0x24, UsageSlot::RZ },          // Turn right/left
+		{ UsagePage::GameControls,       0x25, UsageSlot::RX },          // Pitch forward/backward
+		{ UsagePage::GameControls,       0x26, UsageSlot::RY },          // Roll right/left
+		{ UsagePage::GameControls,       0x27, UsageSlot::X },           // Move right/left
+		{ UsagePage::GameControls,       0x28, UsageSlot::Y },           // Move forward/backward
+		{ UsagePage::GameControls,       0x29, UsageSlot::Z },           // Move up/down
+		{ UsagePage::GameControls,       0x2a, UsageSlot::Slider },      // Lean right/left
+		{ UsagePage::GameControls,       0x2b, UsageSlot::Dial },        // Lean forward/backward
+		{ UsagePage::Consumer,           0xe0, UsageSlot::Dial },        // Volume
+		{ UsagePage::Consumer,           0x238, UsageSlot::Wheel },      // AC pan
+	}};
+
+	//! Find the state slot of a usage
+	//! \param usage_page Usage page of the device object
+	//! \param usage Usage of the device object
+	//! \returns The slot, or 'UsageSlot::None' if the usage is not mapped
+	//! \note Intended to be called once per object when the device is added.
+	inline uint8_t findUsageSlot(uint16_t usage_page, uint16_t usage)
+	{
+		const uint32_t key = (uint32_t{ usage_page } << 16) | usage;
+
+		size_t first = 0;
+		size_t last = UsageMap.size();
+		while (first < last)
+		{
+			const size_t mid = (first + last) / 2;
+			const uint32_t mid_key = (uint32_t{ UsageMap[mid].usagePage } << 16) | UsageMap[mid].usage;
+			if (mid_key == key)
+				return UsageMap[mid].slot;
+			if (mid_key < key)
+				first = mid + 1;
+			else
+				last = mid;
+		}
+
+		return UsageSlot::None;
+	}
+
+	//! Assign the state slot of the next axis of a device
+	//! \param usage_page Usage page of the axis
+	//! \param usage Usage of the axis
+	//! \param used_slots Mask of the slots assigned to the previous axes, updated
+	//! \returns The slot, or 'UsageSlot::None' if the usage is not mapped
+	//! \note Devices commonly report two sliders, the second one is stored in 'UsageSlot::Slider2'.
+	inline uint8_t assignUsageSlot(uint16_t usage_page, uint16_t usage, uint32_t& used_slots)
+	{
+		uint8_t slot = findUsageSlot(usage_page, usage);
+		if (slot == UsageSlot::Slider && (used_slots & (1u << UsageSlot::Slider)))
+			slot = UsageSlot::Slider2;
+
+		if (slot < UsageSlot::NrAxes)
+			used_slots |= 1u << slot;
+
+		return slot;
+	}
+
+	//! \returns The number of axis slots required to store the given slots
+	inline uint32_t nrUsedAxisSlots(uint32_t used_slots)
+	{
+		uint32_t nr_slots = 0;
+		for (; used_slots != 0; used_slots >>= 1)
+			nr_slots++;
+
+		return nr_slots;
+	}
+}}
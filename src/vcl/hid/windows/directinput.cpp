@@ -0,0 +1,280 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "directinput.h"
+
+// C++ Standard library
+#include <cwchar>
+#include <vector>
+
+// Windows API
+extern "C" {
+#    include <hidsdi.h>
+}
+
+namespace
+{
+	//! Direct-input calibration structure
+	struct DirectInputObjectCalibration
+	{
+		LONG min;
+		LONG center;
+		LONG max;
+	};
+	
+	//! Direct-input object attributes
+	struct DirectInputObjectAttributes
+	{
+		DWORD   dwFlags;
+		WORD    wUsagePage;
+		WORD    wUsage;
+	};
+
+	//! Direct-input button mapping
+	struct DirectInputButtonMapping
+	{
+		WORD    usagePage;
+		WORD    usage;
+		wchar_t name[32];
+	};
+
+	//! Direct-input axis mapping and calibration
+	struct DirectInputAxisMapping
+	{
+		WORD usagePage;
+		WORD usage;
+		bool isCalibrated;
+		DirectInputObjectCalibration calibration;
+		wchar_t name[32];
+	};
+
+	//! Read the name and the usage remapping of a DirectInput object
+	template<typename Mapping>
+	void readObjectMapping(HKEY key, Mapping& mapping)
+	{
+		{
+			DWORD valueType = REG_NONE;
+			DWORD valueSize = 0;
+			RegQueryValueExW(key, L"", nullptr, &valueType, nullptr, &valueSize);
+			if (REG_SZ == valueType && sizeof(mapping.name) > valueSize)
+			{
+				RegQueryValueExW(key, L"", nullptr, &valueType, LPBYTE(mapping.name), &valueSize);
+			}
+		}
+
+		DirectInputObjectAttributes attributes;
+		DWORD valueType = REG_NONE;
+		DWORD valueSize = 0;
+		RegQueryValueExW(key, L"Attributes", nullptr, &valueType, nullptr, &valueSize);
+		if (REG_BINARY == valueType && sizeof(attributes) == valueSize)
+		{
+			RegQueryValueExW(key, L"Attributes", nullptr, &valueType, LPBYTE(&attributes), &valueSize);
+			if (0x15 > attributes.wUsagePage)
+			{
+				mapping.usagePage = attributes.wUsagePage;
+				mapping.usage = attributes.wUsage;
+			}
+		}
+	}
+
+	//! Convert a DirectInput object name to UTF-8
+	std::string toUtf8(const wchar_t* str)
+	{
+		char buffer[128];
+		const int length = WideCharToMultiByte(CP_UTF8, 0, str, -1, buffer, static_cast<int>(sizeof(buffer)), nullptr, nullptr);
+		if (length <= 1)
+			return {};
+
+		return { buffer, static_cast<size_t>(length - 1) };
+	}
+
+	//! Read the generic desktop axes of the device
+	std::vector<HIDP_VALUE_CAPS> readAxisCaps(HANDLE raw_handle)
+	{
+		UINT data_size = 0;
+		if (GetRawInputDeviceInfoW(raw_handle, RIDI_PREPARSEDDATA, nullptr, &data_size) != 0 || data_size == 0)
+			return {};
+
+		std::vector<uint8_t> data(data_size);
+		if (GetRawInputDeviceInfoW(raw_handle, RIDI_PREPARSEDDATA, data.data(), &data_size) == UINT(-1))
+			return {};
+
+		const auto preparsed_data = reinterpret_cast<PHIDP_PREPARSED_DATA>(data.data());
+		HIDP_CAPS capabilities;
+		if (HidP_GetCaps(preparsed_data, &capabilities) != HIDP_STATUS_SUCCESS)
+			return {};
+
+		std::vector<HIDP_VALUE_CAPS> axis_classes(capabilities.NumberInputValueCaps);
+		if (capabilities.NumberInputValueCaps > 0 &&
+			HidP_GetValueCaps(
+			HidP_Input, axis_classes.data(), &capabilities.NumberInputValueCaps, preparsed_data
+		) != HIDP_STATUS_SUCCESS)
+		{
+			return {};
+		}
+
+		return axis_classes;
+	}
+}
+
+namespace Vcl { namespace HID { namespace Windows
+{
+	bool importDirectInputCalibration(HANDLE raw_handle, CalibrationDatabaseBuilder& builder)
+	{
+		RID_DEVICE_INFO dev_info = {};
+		dev_info.cbSize = sizeof(RID_DEVICE_INFO);
+
+		UINT dev_info_size = sizeof(RID_DEVICE_INFO);
+		if (GetRawInputDeviceInfoW(raw_handle, RIDI_DEVICEINFO, &dev_info, &dev_info_size) != sizeof(RID_DEVICE_INFO) ||
+			dev_info.dwType != RIM_TYPEHID)
+		{
+			return false;
+		}
+
+		const auto vendor_id = static_cast<uint16_t>(dev_info.hid.dwVendorId);
+		const auto product_id = static_cast<uint16_t>(dev_info.hid.dwProductId);
+
+		// DirectInput assigns the axes X, Y, Z, RX, RY, RZ and the slider
+		// to the object indices 0 to 6
+		DirectInputButtonMapping di_button_mapping[128] = {};
+		DirectInputAxisMapping di_axis_mapping[7] = {};
+		for (const auto& axis : readAxisCaps(raw_handle))
+		{
+			if (axis.UsagePage != HID_USAGE_PAGE_GENERIC)
+			{
+				continue;
+			}
+
+			const auto first_usage = axis.IsRange ? axis.Range.UsageMin : axis.NotRange.Usage;
+			const auto last_usage  = axis.IsRange ? axis.Range.UsageMax : axis.NotRange.Usage;
+			for (WORD current_usage = first_usage; current_usage <= last_usage; ++current_usage)
+			{
+				const auto index = unsigned(current_usage - HID_USAGE_GENERIC_X);
+				if (index < 7)
+				{
+					di_axis_mapping[index].usagePage = HID_USAGE_PAGE_GENERIC;
+					di_axis_mapping[index].usage = current_usage;
+				}
+			}
+		}
+
+		// In case there is no Z-Axis, the slider ist mapped to the empty position
+		if (di_axis_mapping[2].usagePage == 0)
+		{
+			di_axis_mapping[2] = di_axis_mapping[6];
+			di_axis_mapping[6].usagePage = 0;
+			di_axis_mapping[6].usage = 0;
+		}
+
+		const size_t nr_axes = sizeof(di_axis_mapping) / sizeof(di_axis_mapping[0]);
+		const size_t nr_buttons = sizeof(di_button_mapping) / sizeof(di_button_mapping[0]);
+
+		wchar_t path[160];
+		for (size_t i = 0; i < nr_axes; ++i)
+		{
+			swprintf_s(path, L"System\\CurrentControlSet\\Control\\MediaProperties\\PrivateProperties\\Joystick\\OEM\\VID_%04X&PID_%04X\\Axes\\%u",
+				vendor_id, product_id, unsigned(i));
+
+			HKEY key = nullptr;
+			if (RegOpenKeyExW(HKEY_CURRENT_USER, path, 0, KEY_READ, &key) != 0)
+			{
+				// No mapping data was found
+				continue;
+			}
+			readObjectMapping(key, di_axis_mapping[i]);
+			RegCloseKey(key);
+		}
+
+		for (size_t i = 0; i < nr_axes; ++i)
+		{
+			swprintf_s(path, L"System\\CurrentControlSet\\Control\\MediaProperties\\PrivateProperties\\DirectInput\\VID_%04X&PID_%04X\\Calibration\\0\\Type\\Axes\\%u",
+				vendor_id, product_id, unsigned(i));
+
+			HKEY key = nullptr;
+			if (0 == RegOpenKeyExW(HKEY_CURRENT_USER, path, 0u, KEY_READ, &key))
+			{
+				auto & calibration = di_axis_mapping[i].calibration;
+				DWORD  valueType = REG_NONE;
+				DWORD  valueSize = 0;
+				RegQueryValueExW(key, L"Calibration", nullptr, &valueType, nullptr, &valueSize);
+				if (REG_BINARY == valueType && sizeof(calibration) == valueSize)
+				{
+					if (0 == RegQueryValueExW(key, L"Calibration", nullptr, &valueType, LPBYTE(&calibration), &valueSize))
+					{
+						di_axis_mapping[i].isCalibrated = true;
+					}
+				}
+
+				RegCloseKey(key);
+			}
+		}
+
+		for (size_t i = 0; i < nr_buttons; ++i)
+		{
+			swprintf_s(path, L"System\\CurrentControlSet\\Control\\MediaProperties\\PrivateProperties\\Joystick\\OEM\\VID_%04X&PID_%04X\\Buttons\\%u",
+				vendor_id, product_id, unsigned(i));
+
+			HKEY key = nullptr;
+			if (0 != RegOpenKeyExW(HKEY_CURRENT_USER, path, 0u, KEY_READ, &key))
+			{
+				continue;
+			}
+			readObjectMapping(key, di_button_mapping[i]);
+			RegCloseKey(key);
+		}
+
+		// Store the collected data
+		builder.addDevice(vendor_id, product_id);
+		for (const auto& mapping : di_axis_mapping)
+		{
+			if (mapping.usage == 0)
+				continue;
+
+			const auto name = toUtf8(mapping.name);
+
+			CalibrationRecord record;
+			record.key = { vendor_id, product_id, mapping.usagePage, mapping.usage };
+			record.isCalibrated = mapping.isCalibrated;
+			record.minimum = mapping.calibration.min;
+			record.center = mapping.calibration.center;
+			record.maximum = mapping.calibration.max;
+			record.name = name;
+			builder.add(record);
+		}
+		for (const auto& mapping : di_button_mapping)
+		{
+			if (mapping.usage == 0)
+				continue;
+
+			const auto name = toUtf8(mapping.name);
+
+			CalibrationRecord record;
+			record.key = { vendor_id, product_id, mapping.usagePage, mapping.usage };
+			record.name = name;
+			builder.add(record);
+		}
+
+		return true;
+	}
+}}}
@@ -0,0 +1,51 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// Windows API
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+// VCL
+#include <vcl/hid/calibrationdatabase.h>
+
+namespace Vcl { namespace HID { namespace Windows
+{
+	/*!
+	 *	Import the DirectInput calibration and naming data of a device
+	 *
+	 *	The data is read from the registry settings of the current user
+	 *	and added to the builder. The device is marked as known, even if
+	 *	no DirectInput data is available.
+	 *
+	 *	\param raw_handle Raw input API handle of the device
+	 *	\param builder Builder receiving the calibration records
+	 *	\returns True, if the device could be identified
+	 */
+	bool importDirectInputCalibration(HANDLE raw_handle, CalibrationDatabaseBuilder& builder);
+}}}
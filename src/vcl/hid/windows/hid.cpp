@@ -24,20 +24,96 @@
  */
 #include "hid.h"
 
+// C++ Standard library
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <utility>
+
 // VCL
 #include <vcl/core/contract.h>
-#include <vcl/math/ceil.h>
+#include <vcl/hid/windows/directinput.h>
 #include <vcl/hid/windows/spacenavigator.h>
 #include <vcl/hid/gamepad.h>
 #include <vcl/hid/joystick.h>
 #include <vcl/hid/multiaxiscontroller.h>
-#include <vcl/util/scopeguard.h>
 
 // Missing typedef from Windows API
 typedef unsigned __int64 QWORD;
 
 namespace
 {
+	//! Convert a wide string to UTF-8 and add it to the string table
+	std::string_view internUtf8(Vcl::HID::StringTable& strings, const wchar_t* str)
+	{
+		if (!str || str[0] == L'\0')
+			return {};
+
+		char buffer[1024];
+		const int length = WideCharToMultiByte(CP_UTF8, 0, str, -1, buffer, static_cast<int>(sizeof(buffer)), nullptr, nullptr);
+		if (length <= 1)
+			return {};
+
+		// Length contains the terminating null character
+		return strings.intern({ buffer, static_cast<size_t>(length - 1) });
+	}
+
+	//! Determine how a raw input device is handled
+	//! Simulation and game controls are handled like joysticks.
+	//! \returns The generic desktop usage of the device implementation (joystick,
+	//!          gamepad or multi-axis controller), zero if the device is not supported
+	USAGE deviceUsage(const RID_DEVICE_INFO& dev_info)
+	{
+		using namespace Vcl::HID;
+
+		if (dev_info.dwType != RIM_TYPEHID)
+			return 0;
+
+		const USAGE usage_page = dev_info.hid.usUsagePage;
+		if (usage_page == UsagePage::SimulationControls || usage_page == UsagePage::GameControls)
+			return 0x04;
+		if (usage_page != UsagePage::GenericDesktop)
+			return 0;
+
+		switch (dev_info.hid.usUsage)
+		{
+		case 0x04:
+		case 0x05:
+		case 0x08:
+			return dev_info.hid.usUsage;
+		default:
+			return 0;
+		}
+	}
+
+	//! Current time of the steady clock in microseconds
+	uint64_t timestamp()
+	{
+		const auto now = std::chrono::steady_clock::now().time_since_epoch();
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+	}
+
+	//! Split a raw input message into its reports
+	//! A single message may contain several reports of the same size.
+	void appendReports(const RAWINPUT* raw_input, uint64_t time, std::vector<Vcl::HID::RawReport>& reports)
+	{
+		if (raw_input->header.dwType != RIM_TYPEHID)
+			return;
+
+		const auto& hid = raw_input->data.hid;
+		for (DWORD i = 0; i < hid.dwCount; i++)
+		{
+			Vcl::HID::RawReport report;
+			report.device = raw_input->header.hDevice;
+			report.data = hid.bRawData + i * hid.dwSizeHid;
+			report.size = hid.dwSizeHid;
+			report.isBackground = GET_RAWINPUT_CODE_WPARAM(raw_input->header.wParam) == RIM_INPUTSINK;
+			report.timestamp = time;
+			reports.push_back(report);
+		}
+	}
+
 	//! Workaround for incorrect alignment of the RAWINPUT structure on x64 os
 	//! when running as Wow64.
 	UINT getRawInputBuffer(HWND, PRAWINPUT pData, PUINT pcbSize, UINT cbSizeHeader)
@@ -88,42 +164,238 @@ namespace
 
 namespace Vcl { namespace HID { namespace Windows
 {
-	//! Direct-input calibration structure
-	struct DirectInputObjectCalibration
+	static_assert(UsageSlot::NrAxes <= AxisSet::MaxAxes, "All axis slots can be stored.");
+
+	bool AbstractHID::processInput(HWND window_handle, UINT, PRAWINPUT raw_input)
 	{
-		LONG min;
-		LONG center;
-		LONG max;
-	};
-	
-	//! Direct-input object attributes
-	struct DirectInputObjectAttributes
+		_reports.clear();
+		appendReports(raw_input, timestamp(), _reports);
+
+		InputStatistics stats;
+		return processReports(window_handle, _reports, stats) > 0;
+	}
+
+	void AbstractHID::attachTimers(TimerWheel* timers, std::mutex* lock, const InputTimerSettings* settings)
+	{
+		_timers = timers;
+
+		// The input thread may still use the handles of a detached device
+		if (!timers)
+			return;
+
+		_timerLock = lock;
+		_timerSettings = settings;
+		_staleTimer = {};
+		_repeatTimers.clear();
+		_longPressTimers.clear();
+	}
+
+	void AbstractHID::processTimer(const TimerEvent& event, uint64_t now)
+	{
+		// The handles are shared with the input thread
+		{
+			std::lock_guard<std::mutex> guard{ *_timerLock };
+			switch (static_cast<InputTimer>(event.type))
+			{
+			case InputTimer::Stale:
+				_staleTimer = {};
+
+				// Buttons held before the timeout change again with the next report
+				_edgeReports.clear();
+				_edgeButtons.clear();
+				break;
+			case InputTimer::Repeat:
+				_repeatTimers[event.data] = {};
+				if (_timers && _timerSettings->repeatInterval > 0)
+					_repeatTimers[event.data] = _timers->schedule(now + _timerSettings->repeatInterval, event);
+				break;
+			case InputTimer::LongPress:
+				_longPressTimers[event.data] = {};
+				break;
+			}
+		}
+
+		// Resetting the state restarts the button timers
+		if (static_cast<InputTimer>(event.type) == InputTimer::Stale)
+			resetStaleState(now);
+	}
+
+	bool AbstractHID::hasButtonEdge(const RawReport& report)
+	{
+		const auto bytes = report.bytes();
+		const auto nr_buttons = static_cast<uint32_t>(_device->buttons().size());
+		if (bytes.empty() || nr_buttons == 0)
+			return false;
+
+		// Without a decode plan the buttons are decoded
+		const auto& plan = _device->layout()->plan;
+		if (!plan.hasButtons())
+		{
+			if (_edgeButtons.size() != nr_buttons)
+				_edgeButtons.resize(nr_buttons);
+
+			// Buttons of other reports keep their state
+			_edgeScratch = _edgeButtons;
+			if (!_device->readButtons(bytes, _edgeScratch))
+				return false;
+
+			const bool has_edge = !(_edgeScratch == _edgeButtons);
+			std::swap(_edgeButtons, _edgeScratch);
+			return has_edge;
+		}
+
+		// Find the previous report with the same ID. Before the first
+		// report all the buttons are released.
+		auto previous = std::find_if(_edgeReports.begin(), _edgeReports.end(), [id = bytes[0]](const std::vector<uint8_t>& data)
+		{
+			return data[0] == id;
+		});
+		if (previous == _edgeReports.end())
+		{
+			_edgeReports.emplace_back(bytes.size(), uint8_t{ 0 });
+			_edgeReports.back()[0] = bytes[0];
+			previous = _edgeReports.end() - 1;
+		}
+
+		// Compare the button bits only, decoding the buttons is left to
+		// the processing of the report
+		const bool has_edge = plan.buttonsDiffer(bytes, *previous);
+		previous->assign(bytes.begin(), bytes.end());
+		return has_edge;
+	}
+
+	void AbstractHID::setEventCollection(bool enable)
+	{
+		_collectEvents = enable;
+		if (!enable)
+			_events.clear();
+	}
+
+	void AbstractHID::addButtonEvents(const ButtonSet& states, const ButtonSet& pressed, const ButtonSet& released, uint64_t timestamp)
+	{
+		// Buttons changing twice within a batch report both edges,
+		// ending with their current state
+		for (const uint32_t button : released)
+		{
+			if (states.test(button))
+				addEvent(timestamp, InputEventType::Button, button, 0.0f);
+		}
+		for (const uint32_t button : pressed)
+			addEvent(timestamp, InputEventType::Button, button, 1.0f);
+		for (const uint32_t button : released)
+		{
+			if (!states.test(button))
+				addEvent(timestamp, InputEventType::Button, button, 0.0f);
+		}
+	}
+
+	void AbstractHID::restartStaleTimer(uint64_t timestamp)
+	{
+		if (!_timerLock)
+			return;
+
+		std::lock_guard<std::mutex> guard{ *_timerLock };
+		if (!_timers)
+			return;
+
+		const uint64_t timeout = _staleTimeout > 0 ? _staleTimeout : _timerSettings->staleTimeout;
+		if (timeout == 0)
+			return;
+
+		_timers->cancel(_staleTimer);
+		_staleTimer = _timers->schedule(timestamp + timeout, { this, static_cast<uint32_t>(InputTimer::Stale), 0 });
+	}
+
+	void AbstractHID::updateButtonTimers(const ButtonSet& states, const ButtonSet& pressed, const ButtonSet& released, uint64_t timestamp)
+	{
+		if (!_timerLock)
+			return;
+
+		std::lock_guard<std::mutex> guard{ *_timerLock };
+		if (!_timers)
+			return;
+
+		if (_repeatTimers.size() < states.size())
+		{
+			_repeatTimers.resize(states.size());
+			_longPressTimers.resize(states.size());
+		}
+
+		for (const uint32_t button : released)
+		{
+			_timers->cancel(_repeatTimers[button]);
+			_timers->cancel(_longPressTimers[button]);
+		}
+
+		// Buttons pressed and released within a batch do not start any timer
+		for (const uint32_t button : pressed)
+		{
+			if (!states.test(button))
+				continue;
+
+			if (_timerSettings->repeatDelay > 0)
+			{
+				_timers->cancel(_repeatTimers[button]);
+				_repeatTimers[button] = _timers->schedule(timestamp + _timerSettings->repeatDelay, { this, static_cast<uint32_t>(InputTimer::Repeat), button });
+			}
+			if (_timerSettings->longPressTime > 0)
+			{
+				_timers->cancel(_longPressTimers[button]);
+				_longPressTimers[button] = _timers->schedule(timestamp + _timerSettings->longPressTime, { this, static_cast<uint32_t>(InputTimer::LongPress), button });
+			}
+		}
+	}
+
+	std::shared_ptr<const DeviceLayout> DeviceLayoutCache::find(DWORD vendor_id, DWORD product_id, gsl::span<const uint8_t> preparsed_data) const
 	{
-		DWORD   dwFlags;
-		WORD    wUsagePage;
-		WORD    wUsage;
-	};
+		const auto range = _layouts.equal_range(hash(preparsed_data));
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			auto layout = it->second.lock();
+			if (!layout || layout->vendorId != vendor_id || layout->productId != product_id)
+				continue;
+
+			// Guard against hash collisions
+			if (std::equal(layout->preparsedData.begin(), layout->preparsedData.end(), preparsed_data.begin(), preparsed_data.end()))
+				return layout;
+		}
+
+		return nullptr;
+	}
 
-	//! Direct-input button mapping
-	struct DirectInputButtonMapping
+	void DeviceLayoutCache::insert(const std::shared_ptr<const DeviceLayout>& layout)
 	{
-		WORD    usagePage;
-		WORD    usage;
-		wchar_t name[32];
-	};
+		VclRequire(layout, "Layout is valid.");
+
+		// Drop the layouts of devices which are gone
+		for (auto it = _layouts.begin(); it != _layouts.end();)
+		{
+			if (it->second.expired())
+				it = _layouts.erase(it);
+			else
+				++it;
+		}
+
+		_layouts.emplace(layout->descriptorHash, layout);
+	}
 
-	//! Direct-input axis mapping and calibration
-	struct DirectInputAxisMapping
+	uint64_t DeviceLayoutCache::hash(gsl::span<const uint8_t> preparsed_data)
 	{
-		WORD usagePage;
-		WORD usage;
-		bool isCalibrated;
-		DirectInputObjectCalibration calibration;
-		wchar_t name[32];
-	};
+		// FNV-1a
+		uint64_t hash = 0xcbf29ce484222325ull;
+		for (const uint8_t byte : preparsed_data)
+		{
+			hash ^= byte;
+			hash *= 0x100000001b3ull;
+		}
+
+		return hash;
+	}
 
-	GenericHID::GenericHID(HANDLE raw_handle)
-	: _rawInputHandle(raw_handle)
+	GenericHID::GenericHID(HANDLE raw_handle, StringTable& strings, const CalibrationDatabase& calibration, DeviceLayoutCache& layouts)
+	: _strings(&strings)
+	, _rawInputHandle(raw_handle)
+	, _layout(std::make_shared<const DeviceLayout>())
 	{
 		// Access the object path of the device name
 		wchar_t path_buffer[260 + 4];
@@ -153,55 +425,116 @@ namespace Vcl { namespace HID { namespace Windows
 		RID_DEVICE_INFO dev_info = {};
 		dev_info.cbSize = sizeof(RID_DEVICE_INFO);
 
+		auto layout = std::make_shared<DeviceLayout>();
+
 		UINT dev_info_size = sizeof(RID_DEVICE_INFO);
 		bytes_copied = GetRawInputDeviceInfoW(_rawInputHandle, RIDI_DEVICEINFO, &dev_info, &dev_info_size);
 		if (bytes_copied == sizeof(RID_DEVICE_INFO))
 		{
-			_vendorId = dev_info.hid.dwVendorId;
-			_productId = dev_info.hid.dwProductId;
+			layout->vendorId = dev_info.hid.dwVendorId;
+			layout->productId = dev_info.hid.dwProductId;
+		}
+
+		// Keep the preparsed data for decoding the reports
+		UINT data_size = 0;
+		if (GetRawInputDeviceInfoW(_rawInputHandle, RIDI_PREPARSEDDATA, nullptr, &data_size) == 0 && data_size > 0)
+		{
+			layout->preparsedData.resize(data_size);
+			if (GetRawInputDeviceInfoW(_rawInputHandle, RIDI_PREPARSEDDATA, layout->preparsedData.data(), &data_size) == UINT(-1))
+				layout->preparsedData.clear();
+		}
+
+		// Identical devices share the layout compiled for the first one
+		_layout = layouts.find(layout->vendorId, layout->productId, layout->preparsedData);
+		if (!_layout)
+		{
+			createLayout(*layout, calibration);
+			layouts.insert(layout);
+			_layout = std::move(layout);
 		}
 
-		auto caps = readDeviceCaps();
+		initializeState();
+	}
+
+	void GenericHID::createLayout(DeviceLayout& layout, const CalibrationDatabase& calibration) const
+	{
+		layout.descriptorHash = DeviceLayoutCache::hash(layout.preparsedData);
+
+		auto caps = readDeviceCaps(layout);
+
+		storeButtons(layout, std::move(std::get<0>(caps)), calibration);
+		storeAxes(   layout, std::move(std::get<1>(caps)), calibration);
+
+		// Resolve the state of each axis once, instead of for every report
+		uint32_t used_slots = 0;
+		layout.axisSlots.reserve(layout.axes.size());
+		for (const auto& axis : layout.axes)
+			layout.axisSlots.push_back(assignUsageSlot(axis.usagePage, axis.usage, used_slots));
+		layout.nrAxisSlots = nrUsedAxisSlots(used_slots);
 
-		DirectInputButtonMapping di_button_mapping[128] = {};
-		DirectInputAxisMapping di_axis_mapping[7] = {};
+		compileDecodePlan(layout);
+	}
+
+	void GenericHID::initializeState()
+	{
+		const auto& axes = _layout->axes;
+
+		_usages.resize(_layout->buttons.empty() ? 1 : _layout->buttons.size());
 
-		readButtonCalibration(di_button_mapping);
-		readAxisCalibration(std::get<1>(caps), di_axis_mapping);
+		// Identical reports of relative axes still carry movement
+		const bool has_relative_axes = std::any_of(axes.begin(), axes.end(), [](const Axis& axis)
+		{
+			return !axis.isAbsolute;
+		});
+		_coalescer.setSuppressDuplicates(!has_relative_axes);
+
+		// Start the online calibration from the stored data
+		_calibrators = std::make_unique<AxisCalibrator[]>(axes.size());
+		for (size_t i = 0; i < axes.size(); i++)
+		{
+			const auto& axis = axes[i];
+
+			AxisCalibration initial;
+			initial.minimum = axis.logicalCalibratedMinimum;
+			initial.center = axis.logicalCalibratedCenter;
+			initial.maximum = axis.logicalCalibratedMaximum;
+			initial.noise = axis.logicalCalibratedNoise;
+			_calibrators[i].reset(axis.logicalMinimum, axis.logicalMaximum, initial, axis.isCalibrated);
+		}
+	}
 
-		storeButtons(std::move(std::get<0>(caps)), di_button_mapping);
-		storeAxes(   std::move(std::get<1>(caps)), di_axis_mapping);
+	GenericHID::~GenericHID()
+	{
+		if (_fileHandle && _fileHandle != INVALID_HANDLE_VALUE)
+			CloseHandle(_fileHandle);
 	}
 
-	auto GenericHID::readDeviceName() const -> std::pair<std::wstring, std::wstring>
+	auto GenericHID::readDeviceName() const -> std::pair<std::string_view, std::string_view>
 	{
 		wchar_t vendor_buffer[255];
 		wchar_t device_buffer[255];
-		if (HidD_GetManufacturerString(_fileHandle, vendor_buffer, 255) == FALSE)
+		if (HidD_GetManufacturerString(_fileHandle, vendor_buffer, sizeof(vendor_buffer)) == FALSE)
 		{
 			wcscpy_s(vendor_buffer, L"(unknown)");
 		}
 		
-		if (HidD_GetProductString(_fileHandle, device_buffer, 255) == FALSE)
+		if (HidD_GetProductString(_fileHandle, device_buffer, sizeof(device_buffer)) == FALSE)
 		{
 			wcscpy_s(device_buffer, L"(unknown)");
 		}
 
-		return std::make_pair(vendor_buffer, device_buffer);
+		return std::make_pair(internUtf8(*_strings, vendor_buffer), internUtf8(*_strings, device_buffer));
 	}
 
-	auto GenericHID::readDeviceCaps() const
+	auto GenericHID::readDeviceCaps(const DeviceLayout& layout)
 		-> std::tuple<std::vector<HIDP_BUTTON_CAPS>, std::vector<HIDP_VALUE_CAPS>>
 	{
-		PHIDP_PREPARSED_DATA preparsed_data;
-		if (HidD_GetPreparsedData(_fileHandle, &preparsed_data) == FALSE)
+		const auto preparsed_data = layout.preparsed();
+		if (!preparsed_data)
 		{
 			return{};
 		}
 
-		// Free the allocated data structure at the end of the method
-		VCL_SCOPE_EXIT { HidD_FreePreparsedData(preparsed_data); };
-
 		HIDP_CAPS capabilities;
 		if (HidP_GetCaps(preparsed_data, &capabilities) != HIDP_STATUS_SUCCESS)
 		{
@@ -280,189 +613,7 @@ namespace Vcl { namespace HID { namespace Windows
 		return std::make_tuple(std::move(button_classes), std::move(axis_classes));
 	}
 
-	void GenericHID::readAxisCalibration(const std::vector<HIDP_VALUE_CAPS>& axes_caps, gsl::span<struct DirectInputAxisMapping> di_axis_mapping) const
-	{
-		for (const auto& axis : axes_caps)
-		{
-			if (axis.UsagePage != HID_USAGE_PAGE_GENERIC)
-			{
-				continue;
-			}
-
-			const auto first_usage = axis.Range.UsageMin;
-			const auto last_usage  = axis.Range.UsageMax;
-			for (WORD current_usage = first_usage; current_usage <= last_usage; ++current_usage) {
-
-				const auto index = unsigned(current_usage - HID_USAGE_GENERIC_X);
-				if (index < 7)
-				{
-					di_axis_mapping[index].usagePage = HID_USAGE_PAGE_GENERIC;
-					di_axis_mapping[index].usagePage = current_usage;
-				}
-			}
-		}
-
-		// In case there is no Z-Axis, the slider ist mapped to the empty position
-		if (di_axis_mapping[2].usagePage == 0)
-		{
-			di_axis_mapping[2] = di_axis_mapping[6];
-			di_axis_mapping[6].usagePage = 0;
-			di_axis_mapping[6].usage = 0;
-		}
-		
-		HIDD_ATTRIBUTES vendor_and_product_id;
-		if (FALSE != HidD_GetAttributes(fileHandle(), &vendor_and_product_id))
-		{
-			wchar_t path[128] = L"System\\CurrentControlSet\\Control\\MediaProperties\\PrivateProperties\\Joystick\\OEM\\VID_????&PID_????\\Axes\\?";
-			path[84] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.VendorID >> 12) & 0xF]);
-			path[85] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.VendorID >> 8) & 0xF]);
-			path[86] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.VendorID >> 4) & 0xF]);
-			path[87] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.VendorID >> 0) & 0xF]);
-			path[93] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.ProductID >> 12) & 0xF]);
-			path[94] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.ProductID >> 8) & 0xF]);
-			path[95] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.ProductID >> 4) & 0xF]);
-			path[96] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.ProductID >> 0) & 0xF]);
-
-			for (size_t i = 0; i < sizeof di_axis_mapping / sizeof(di_axis_mapping[0]); ++i)
-			{
-				path[103] = wchar_t('0' + i);
-
-				HKEY key = nullptr;
-				if (RegOpenKeyExW(HKEY_CURRENT_USER, path, 0, KEY_READ, &key) != 0)
-				{
-					// No calibration data was found
-					continue;
-				}
-				{
-					DWORD valueType = REG_NONE;
-					DWORD valueSize = 0;
-					RegQueryValueExW(key, L"", nullptr, &valueType, nullptr, &valueSize);
-					if (REG_SZ == valueType && sizeof(di_axis_mapping[i].name) > valueSize)
-					{
-						RegQueryValueExW(key, L"", nullptr, &valueType, LPBYTE(di_axis_mapping[i].name), &valueSize);
-					}
-				}
-
-				DirectInputObjectAttributes mapping;
-				DWORD valueType = REG_NONE;
-				DWORD valueSize = 0;
-				RegQueryValueExW(key, L"Attributes", nullptr, &valueType, nullptr, &valueSize);
-				if (REG_BINARY == valueType && sizeof(mapping) == valueSize)
-				{
-					RegQueryValueExW(key, L"Attributes", nullptr, &valueType, LPBYTE(&mapping), &valueSize);
-					if (0x15 > mapping.wUsagePage)
-					{
-						di_axis_mapping[i].usagePage = mapping.wUsagePage;
-						di_axis_mapping[i].usage = mapping.wUsage;
-					}
-				}
-
-				RegCloseKey(key);
-			}
-
-			wcscpy_s(path, L"System\\CurrentControlSet\\Control\\MediaProperties\\PrivateProperties\\DirectInput\\VID_????&PID_????\\Calibration\\0\\Type\\Axes\\?");
-			path[83] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.VendorID >> 12) & 0xF]);
-			path[84] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.VendorID >>  8) & 0xF]);
-			path[85] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.VendorID >>  4) & 0xF]);
-			path[86] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.VendorID >>  0) & 0xF]);
-			path[92] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.ProductID >> 12) & 0xF]);
-			path[93] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.ProductID >>  8) & 0xF]);
-			path[94] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.ProductID >>  4) & 0xF]);
-			path[95] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.ProductID >>  0) & 0xF]);
-
-			for (size_t i = 0; i < sizeof(di_axis_mapping) / sizeof(di_axis_mapping[0]); ++i)
-			{
-				path[121] = wchar_t('0' + i);
-
-				HKEY key = nullptr;
-				if (0 == RegOpenKeyExW(HKEY_CURRENT_USER, path, 0u, KEY_READ, &key))
-				{
-					auto & calibration = di_axis_mapping[i].calibration;
-					DWORD  valueType = REG_NONE;
-					DWORD  valueSize = 0;
-					RegQueryValueExW(key, L"Calibration", nullptr, &valueType, nullptr, &valueSize);
-					if (REG_BINARY == valueType && sizeof(calibration) == valueSize)
-					{
-						if (0 == RegQueryValueExW(key, L"Calibration", nullptr, &valueType, LPBYTE(&calibration), &valueSize))
-						{
-							di_axis_mapping[i].isCalibrated = true;
-						}
-					}
-
-					RegCloseKey(key);
-				}
-
-			}
-		}
-	}
-
-	void GenericHID::readButtonCalibration(gsl::span<struct DirectInputButtonMapping> di_button_mapping) const
-	{
-		HIDD_ATTRIBUTES vendor_and_product_id;
-		if (FALSE != HidD_GetAttributes(fileHandle(), &vendor_and_product_id))
-		{
-			wchar_t path[128] = L"System\\CurrentControlSet\\Control\\MediaProperties\\PrivateProperties\\Joystick\\OEM\\VID_????&PID_????\\Axes\\?";
-			path[84] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.VendorID >> 12) & 0xF]);
-			path[85] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.VendorID >> 8) & 0xF]);
-			path[86] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.VendorID >> 4) & 0xF]);
-			path[87] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.VendorID >> 0) & 0xF]);
-			path[93] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.ProductID >> 12) & 0xF]);
-			path[94] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.ProductID >> 8) & 0xF]);
-			path[95] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.ProductID >> 4) & 0xF]);
-			path[96] = wchar_t("0123456789ABCDEF"[(vendor_and_product_id.ProductID >> 0) & 0xF]);
-
-			wcscpy_s(path + 98, sizeof(path) / sizeof(path[0]) - 98, L"Buttons\\???");
-			for (size_t i = 0u; i < sizeof di_button_mapping / sizeof(di_button_mapping[0]); ++i) {
-				if (i >= 100) {
-					path[106] = wchar_t('0' + i / 100u);
-					path[107] = wchar_t('0' + i % 100u / 10u);
-					path[108] = wchar_t('0' + i % 10u);
-					path[109] = wchar_t('\0');
-				}
-				else if (i >= 10u) {
-					path[106] = wchar_t('0' + i / 10u);
-					path[107] = wchar_t('0' + i % 10u);
-					path[108] = wchar_t('\0');
-				}
-				else {
-					path[106] = wchar_t('0' + i);
-					path[107] = wchar_t('\0');
-				}
-
-				HKEY key = nullptr;
-				if (0 != RegOpenKeyExW(HKEY_CURRENT_USER, path, 0u, KEY_READ, &key)) {
-					continue;
-				}
-
-				{
-					DWORD valueType = REG_NONE;
-					DWORD valueSize = 0;
-					RegQueryValueExW(key, L"", nullptr, &valueType, nullptr, &valueSize);
-					if (REG_SZ == valueType && sizeof(di_button_mapping[i].name) > valueSize)
-					{
-						RegQueryValueExW(key, L"", nullptr, &valueType, LPBYTE(di_button_mapping[i].name), &valueSize);
-					}
-				}
-
-				DirectInputObjectAttributes mapping;
-				DWORD valueType = REG_NONE;
-				DWORD valueSize = 0;
-				RegQueryValueExW(key, L"Attributes", nullptr, &valueType, nullptr, &valueSize);
-				if (REG_BINARY == valueType && sizeof(mapping) == valueSize) {
-
-					RegQueryValueExW(key, L"Attributes", nullptr, &valueType, LPBYTE(&mapping), &valueSize);
-					if (0x15 > mapping.wUsagePage) {
-						di_button_mapping[i].usagePage = mapping.wUsagePage;
-						di_button_mapping[i].usage = mapping.wUsage;
-					}
-				}
-
-				RegCloseKey(key);
-			}
-		}
-	}
-
-	void GenericHID::storeButtons(std::vector<HIDP_BUTTON_CAPS>&& button_caps, gsl::span<struct DirectInputButtonMapping> di_button_mapping)
+	void GenericHID::storeButtons(DeviceLayout& layout, std::vector<HIDP_BUTTON_CAPS>&& button_caps, const CalibrationDatabase& calibration) const
 	{
 		for (const auto& button_cap : button_caps)
 		{
@@ -473,32 +624,25 @@ namespace Vcl { namespace HID { namespace Windows
 				++current_usage, ++current_index
 			)
 			{
-				// Check if the button name was overriden by direct input
-				wchar_t const * di_name = L"";
-				for (auto & mapping : di_button_mapping) {
-					if (button_cap.UsagePage == mapping.usagePage && current_usage == mapping.usage) {
-						di_name = mapping.name;
-				
-						// Skip this mapping in following runs
-						mapping.usage = 0;
-						break;
-					}
-				}
+				// Check if the button name was overriden by the user
+				CalibrationRecord record;
+				const CalibrationKey key{ uint16_t(layout.vendorId), uint16_t(layout.productId), button_cap.UsagePage, current_usage };
+				calibration.find(key, record);
 
 				Button button;
 				button.usagePage = button_cap.UsagePage;
 				button.usage = current_usage;
 				button.index = current_index;
-				button.name = di_name;
+				button.name = _strings->intern(record.name);
 
-				_buttons.emplace_back(button);
+				layout.buttons.emplace_back(button);
 			}
 		}
 
-		_buttonCaps = std::move(button_caps);
+		layout.buttonCaps = std::move(button_caps);
 	}
 
-	void GenericHID::storeAxes(std::vector<HIDP_VALUE_CAPS>&& axes_caps, gsl::span<struct DirectInputAxisMapping> di_axis_mapping)
+	void GenericHID::storeAxes(DeviceLayout& layout, std::vector<HIDP_VALUE_CAPS>&& axes_caps, const CalibrationDatabase& calibration) const
 	{
 		for (const auto& axis_cap : axes_caps)
 		{
@@ -509,235 +653,593 @@ namespace Vcl { namespace HID { namespace Windows
 				++current_usage, ++current_index
 				)
 			{
-				bool    is_calibrated = true;
-				int32_t calibrated_minimum = axis_cap.LogicalMin;
-				int32_t calibrated_maximum = axis_cap.LogicalMax;
-				int32_t calibrated_center  = (axis_cap.LogicalMin + axis_cap.LogicalMax) / 2;
-				wchar_t const * di_name = L"";
-				
-				for (auto & mapping : di_axis_mapping) {
-					if (axis_cap.UsagePage == mapping.usagePage && current_usage == mapping.usage) {
-						di_name = mapping.name;
-						is_calibrated = mapping.isCalibrated;
-						if (mapping.isCalibrated) {
-							calibrated_minimum = mapping.calibration.min;
-							calibrated_center = mapping.calibration.center;
-							calibrated_maximum = mapping.calibration.max;
-						}
-				
-						// Skip this mapping in following runs
-						mapping.usage = 0;
-						break;
-					}
-				}
+				CalibrationRecord record;
+				const CalibrationKey key{ uint16_t(layout.vendorId), uint16_t(layout.productId), axis_cap.UsagePage, current_usage };
+				calibration.find(key, record);
 
 				Axis axis;
 				axis.usagePage = axis_cap.UsagePage;
 				axis.usage = current_usage;
 				axis.index = current_index;
+				axis.reportId = axis_cap.ReportID;
 				axis.logicalMinimum = axis_cap.LogicalMin;
 				axis.logicalMaximum = axis_cap.LogicalMax;
-				axis.isCalibrated = is_calibrated;
-				if (is_calibrated) {
-					axis.logicalCalibratedMinimum = calibrated_minimum;
-					axis.logicalCalibratedMaximum = calibrated_maximum;
-					axis.logicalCalibratedCenter  = calibrated_center;
+				axis.bitSize = axis_cap.BitSize;
+				axis.isAbsolute = axis_cap.IsAbsolute != FALSE;
+				axis.isCalibrated = record.isCalibrated;
+				if (record.isCalibrated)
+				{
+					axis.logicalCalibratedMinimum = record.minimum;
+					axis.logicalCalibratedMaximum = record.maximum;
+					axis.logicalCalibratedCenter  = record.center;
+					axis.logicalCalibratedNoise   = record.noise;
+				}
+				else
+				{
+					axis.logicalCalibratedMinimum = axis_cap.LogicalMin;
+					axis.logicalCalibratedMaximum = axis_cap.LogicalMax;
+					axis.logicalCalibratedCenter  = (axis_cap.LogicalMin + axis_cap.LogicalMax) / 2;
+					axis.logicalCalibratedNoise   = 0;
 				}
 				axis.physicalMinimum = axis_cap.PhysicalMin;
 				axis.physicalMaximum = axis_cap.PhysicalMax;
-				axis.name = di_name;
-
-				_axes.push_back(axis);
+				axis.units = axis_cap.Units;
+				axis.unitExponent = axis_cap.UnitsExp;
+
+				// Changes of relative axes are scaled without offset
+				axis.physical = physicalScale(
+					axis.logicalMinimum, axis.logicalMaximum,
+					axis.physicalMinimum, axis.physicalMaximum,
+					axis.units, axis.unitExponent);
+				if (!axis.isAbsolute)
+					axis.physical.offset = 0;
+				axis.name = _strings->intern(record.name);
+
+				layout.axes.push_back(axis);
 			}
 		}
 
-		_axesCaps = std::move(axes_caps);
+		layout.axesCaps = std::move(axes_caps);
 	}
 
-	template<typename JoystickType>
-	JoystickHID<JoystickType>::JoystickHID(std::unique_ptr<GenericHID> dev)
-	: AbstractHID{std::move(dev)}
-	, JoystickType()
+	float GenericHID::normalizeAxis(size_t idx, LONG value)
 	{
-		static_assert(std::is_base_of<Joystick, JoystickType>::value, "JoystickType must be a joystick");
-		
-		const auto names = device()->readDeviceName();
-		setVendorName(names.first);
-		setDeviceName(names.second);
+		VclRequire(idx < _layout->axes.size(), "Axis index is valid.");
 
-		setNrAxes(static_cast<uint32_t>(device()->axes().size()));
-		setNrButtons(static_cast<uint32_t>(device()->buttons().size()));
+		if (_autoCalibration.load(std::memory_order_relaxed))
+			return _calibrators[idx].update(value);
+		else
+			return Windows::normalizeAxis(static_cast<ULONG>(value), _layout->axes[idx]);
 	}
 
-	template<typename JoystickType>
-	bool JoystickHID<JoystickType>::processInput(HWND, UINT, PRAWINPUT raw_input)
+	void GenericHID::learnAxis(size_t idx, LONG value)
 	{
-		PHIDP_PREPARSED_DATA preparsed_data;
-		if (HidD_GetPreparsedData(device()->fileHandle(), &preparsed_data) == FALSE)
-			return false;
+		VclRequire(idx < _layout->axes.size(), "Axis index is valid.");
 
-		// Free the allocated data structure at the end of the method
-		VCL_SCOPE_EXIT{ HidD_FreePreparsedData(preparsed_data); };
+		if (_autoCalibration.load(std::memory_order_relaxed))
+			_calibrators[idx].learn(value);
+	}
 
-		for (const auto& axis : device()->axes())
-		{
-			// Read the value of the axis
-			ULONG value = 0;
+	float GenericHID::normalizeDelta(size_t idx, int64_t delta) const
+	{
+		VclRequire(idx < _layout->axes.size(), "Axis index is valid.");
 
-			if (HidP_GetUsageValue(
-				HidP_Input, axis.usagePage, 0,
-				axis.usage, &value, preparsed_data,
-				(PCHAR)raw_input->data.hid.bRawData, raw_input->data.hid.dwSizeHid
-			) == HIDP_STATUS_SUCCESS)
-			{
-				switch (axis.usage)
-				{
-				case HID_USAGE_GENERIC_X:
-					setAxisState(static_cast<uint32_t>(JoystickAxis::X), normalizeAxis(value, axis));
-					break;
+		const auto& axis = _layout->axes[idx];
+		const int64_t extent = axis.logicalMaximum > -axis.logicalMinimum ? axis.logicalMaximum : -static_cast<int64_t>(axis.logicalMinimum);
+		if (extent <= 0)
+			return 0.0f;
 
-				case HID_USAGE_GENERIC_Y:
-					setAxisState(static_cast<uint32_t>(JoystickAxis::Y), normalizeAxis(value, axis));
-					break;
+		return static_cast<float>(delta) / static_cast<float>(extent);
+	}
 
-				case HID_USAGE_GENERIC_Z:
-					setAxisState(static_cast<uint32_t>(JoystickAxis::Z), normalizeAxis(value, axis));
-					break;
+	LONG GenericHID::logicalValue(size_t idx, ULONG value) const
+	{
+		VclRequire(idx < _layout->axes.size(), "Axis index is valid.");
 
-				case HID_USAGE_GENERIC_RX:
-					setAxisState(static_cast<uint32_t>(JoystickAxis::RX), normalizeAxis(value, axis));
-					break;
+		const auto& axis = _layout->axes[idx];
+		if (axis.logicalMinimum >= 0 || axis.bitSize == 0 || axis.bitSize >= 32)
+			return static_cast<LONG>(value);
 
-				case HID_USAGE_GENERIC_RY:
-					setAxisState(static_cast<uint32_t>(JoystickAxis::RY), normalizeAxis(value, axis));
-					break;
+		// Sign extend the value
+		const ULONG sign = ULONG{ 1 } << (axis.bitSize - 1);
+		value &= (sign << 1) - 1;
+		return static_cast<LONG>(value ^ sign) - static_cast<LONG>(sign);
+	}
 
-				case HID_USAGE_GENERIC_RZ:
-					setAxisState(static_cast<uint32_t>(JoystickAxis::RZ), normalizeAxis(value, axis));
-					break;
+	void GenericHID::compileDecodePlan(DeviceLayout& layout)
+	{
+		const auto preparsed_data = layout.preparsed();
+		if (!preparsed_data)
+			return;
+
+		HIDP_CAPS capabilities;
+		if (HidP_GetCaps(preparsed_data, &capabilities) != HIDP_STATUS_SUCCESS)
+			return;
+
+		// Locate each field by setting it in an empty report
+		const ULONG report_length = capabilities.InputReportByteLength;
+		std::vector<char> empty(report_length);
+		std::vector<char> report(report_length);
+
+		// Find the bits differing between two reports
+		// \returns The first changed bit and the number of changed bits
+		const auto diff = [report_length](const std::vector<char>& a, const std::vector<char>& b)
+		{
+			uint32_t first = 0;
+			uint32_t nr_changed = 0;
+			for (ULONG i = 0; i < report_length; i++)
+			{
+				const auto changed = static_cast<uint8_t>(a[i] ^ b[i]);
+				if (changed != 0)
+				{
+					if (nr_changed == 0)
+						first = i * 8 + findFirstSet(changed);
+					nr_changed += countSet(changed);
 				}
 			}
-		}
-
-		// Output set
-		std::bitset<32> button_states;
+			return std::make_pair(first, nr_changed);
+		};
 
-		USAGE usages[128];
-		ULONG nr_usages = 128;
-		for (const auto& button_caps : device()->buttonCaps())
+		std::vector<ButtonLocation> buttons;
+		buttons.reserve(layout.buttons.size());
+		for (const auto& button_cap : layout.buttonCaps)
 		{
-			if (HidP_GetUsages(
-				HidP_Input, button_caps.UsagePage, 0,
-				usages, &nr_usages, preparsed_data,
-				(PCHAR)raw_input->data.hid.bRawData, raw_input->data.hid.dwSizeHid
-			) == HIDP_STATUS_SUCCESS)
+			if (HidP_InitializeReportForID(HidP_Input, button_cap.ReportID, preparsed_data, empty.data(), report_length) != HIDP_STATUS_SUCCESS)
+				break;
+
+			// Count in a wider type, as the range may end at the last usage
+			uint32_t usage = button_cap.Range.UsageMin;
+			for (; usage <= button_cap.Range.UsageMax; ++usage)
 			{
-				for (ULONG i = 0; i < std::min(nr_usages, 32ul); i++)
+				report = empty;
+
+				USAGE usages[] = { static_cast<USAGE>(usage) };
+				ULONG nr_usages = 1;
+				if (HidP_SetUsages(
+					HidP_Input, button_cap.UsagePage, button_cap.LinkCollection,
+					usages, &nr_usages, preparsed_data, report.data(), report_length
+				) != HIDP_STATUS_SUCCESS)
 				{
-					button_states[usages[i] - button_caps.Range.UsageMin] = true;
+					break;
 				}
+
+				// Buttons not stored as a single bit are decoded by the HID API
+				const auto changed = diff(report, empty);
+				if (changed.second != 1)
+					break;
+
+				buttons.push_back({ button_cap.ReportID, changed.first });
 			}
+			if (usage <= button_cap.Range.UsageMax)
+				break;
 		}
-		setButtonStates(std::move(button_states));
+		if (buttons.size() != layout.buttons.size())
+			buttons.clear();
 
-		return true;
-	}
+		// Locate each value by setting all its bits
+		std::vector<ValueLocation> values;
+		values.reserve(layout.axes.size());
+		for (const auto& axis : layout.axes)
+		{
+			if (axis.bitSize == 0 || axis.bitSize > 32)
+				break;
 
-	template<typename GamepadType>
+			if (HidP_InitializeReportForID(HidP_Input, axis.reportId, preparsed_data, empty.data(), report_length) != HIDP_STATUS_SUCCESS ||
+				HidP_SetUsageValue(HidP_Input, axis.usagePage, 0, axis.usage, 0, preparsed_data, empty.data(), report_length) != HIDP_STATUS_SUCCESS)
+			{
+				break;
+			}
+
+			report = empty;
+			const ULONG all_set = static_cast<ULONG>((uint64_t{ 1 } << axis.bitSize) - 1);
+			if (HidP_SetUsageValue(HidP_Input, axis.usagePage, 0, axis.usage, all_set, preparsed_data, report.data(), report_length) != HIDP_STATUS_SUCCESS)
+				break;
+
+			// Values are expected to be stored in consecutive bits
+			const auto changed = diff(report, empty);
+			if (changed.second != axis.bitSize || readBits({ reinterpret_cast<const uint8_t*>(report.data()), static_cast<std::ptrdiff_t>(report_length) }, changed.first, axis.bitSize) != all_set)
+				break;
+
+			values.push_back({ axis.reportId, changed.first, static_cast<uint8_t>(axis.bitSize), axis.logicalMinimum < 0 });
+		}
+		if (values.size() != layout.axes.size())
+			values.clear();
+
+		// Generated decoders are only available for completely known layouts
+		if (buttons.size() == layout.buttons.size() && values.size() == layout.axes.size())
+		{
+			layout.layoutHash = Vcl::HID::layoutHash(buttons, values);
+			layout.valueOrder = reportOrder<ValueLocation>(values);
+			layout.buttonsInReportOrder = std::is_sorted(buttons.begin(), buttons.end(), isStoredBefore<ButtonLocation>);
+		}
+
+		layout.plan = DecodePlan{ buttons, values };
+	}
+
+	void GenericHID::setGeneratedDecoder(const GeneratedDecoder* decoder)
+	{
+		const auto& layout = *_layout;
+		if (decoder && (decoder->nrButtons != layout.buttons.size() || decoder->nrValues != layout.axes.size() || decoder->layoutHash != layout.layoutHash))
+		{
+			VclDebugError("Generated decoder matches the device.");
+			decoder = nullptr;
+		}
+
+		// The button states are written without reordering them
+		if (!layout.buttonsInReportOrder)
+			decoder = nullptr;
+
+		_generated = decoder;
+		_values.assign(layout.axes.size(), 0);
+	}
+
+	bool GenericHID::readButtons(gsl::span<const uint8_t> report, ButtonSet& buttons)
+	{
+		VclRequire(buttons.size() >= _layout->buttons.size(), "Button set can store all buttons.");
+
+		if (_generated)
+			return _generated->decodeButtons(report, buttons);
+		if (_layout->plan.hasButtons())
+			return _layout->plan.decodeButtons(report, buttons);
+
+		const auto preparsed_data = preparsedData();
+		if (!preparsed_data || report.empty())
+			return false;
+
+		// Buttons are numbered consecutively across all button caps
+		bool found = false;
+		uint32_t offset = 0;
+		for (const auto& button_caps : _layout->buttonCaps)
+		{
+			const auto usage_min = button_caps.Range.UsageMin;
+			const auto usage_max = button_caps.Range.UsageMax;
+			const uint32_t nr_buttons = usage_max >= usage_min ? usage_max - usage_min + 1 : 0;
+
+			// Only the caps of the received report are decoded
+			if (button_caps.ReportID != report[0])
+			{
+				offset += nr_buttons;
+				continue;
+			}
+
+			for (uint32_t i = 0; i < nr_buttons; i += 64)
+				buttons.setBits(offset + i, nr_buttons - i < 64 ? nr_buttons - i : 64, 0);
+
+			ULONG nr_usages = static_cast<ULONG>(_usages.size());
+			if (HidP_GetUsages(
+				HidP_Input, button_caps.UsagePage, 0,
+				_usages.data(), &nr_usages, preparsed_data,
+				(PCHAR)report.data(), static_cast<ULONG>(report.size())
+			) == HIDP_STATUS_SUCCESS)
+			{
+				for (ULONG i = 0; i < nr_usages; i++)
+				{
+					// Usages of the same page may belong to other caps
+					if (_usages[i] >= usage_min && _usages[i] <= usage_max)
+						buttons.set(offset + _usages[i] - usage_min);
+				}
+			}
+
+			offset += nr_buttons;
+			found = true;
+		}
+
+		return found;
+	}
+
+	std::vector<CalibrationRecord> GenericHID::learnedCalibration() const
+	{
+		const auto& layout = *_layout;
+
+		std::vector<CalibrationRecord> records;
+		for (size_t i = 0; i < layout.axes.size(); i++)
+		{
+			if (!_calibrators[i].hasLearned())
+				continue;
+
+			const auto& axis = layout.axes[i];
+			const auto calibration = _calibrators[i].calibration();
+
+			CalibrationRecord record;
+			record.key = { uint16_t(layout.vendorId), uint16_t(layout.productId), axis.usagePage, axis.usage };
+			record.isCalibrated = true;
+			record.minimum = calibration.minimum;
+			record.center = calibration.center;
+			record.maximum = calibration.maximum;
+			record.noise = calibration.noise;
+			record.name = axis.name;
+			records.push_back(record);
+		}
+
+		return records;
+	}
+
+	template<typename JoystickType>
+	JoystickHID<JoystickType>::JoystickHID(std::unique_ptr<GenericHID> dev)
+	: AbstractHID{std::move(dev)}
+	, JoystickType()
+	{
+		static_assert(std::is_base_of<Joystick, JoystickType>::value, "JoystickType must be a joystick");
+
+		setNrAxes(device()->layout()->nrAxisSlots);
+		setNrButtons(static_cast<uint32_t>(device()->buttons().size()));
+		_decodedButtons.resize(nrButtons());
+
+		// Physical values are computed from the raw values with a single scale
+		const auto& layout = *device()->layout();
+		for (size_t i = 0; i < layout.axes.size(); i++)
+		{
+			const uint8_t slot = layout.axisSlots[i];
+			if (slot < UsageSlot::NrAxes)
+				setAxisPhysicalScale(slot, layout.axes[i].physical);
+		}
+	}
+
+	template<typename JoystickType>
+	size_t JoystickHID<JoystickType>::processReports(HWND, gsl::span<const RawReport> reports, InputStatistics& stats)
+	{
+		if (!device()->preparsedData() || reports.empty())
+			return 0;
+
+		const auto actions = device()->selectReports(reports, stats);
+
+		// Edges of all the reports of the batch are reported together
+		bool accumulate_edges = false;
+
+		const auto& layout = *device()->layout();
+		_deltas.assign(layout.axes.size(), 0);
+		for (size_t r = 0; r < static_cast<size_t>(reports.size()); r++)
+		{
+			const auto& report = reports[r];
+			const auto action = actions[r];
+			if (action == ReportAction::Skip || report.size == 0)
+				continue;
+
+			// Absolute values of superseded reports are not needed
+			device()->readAxes(report, action == ReportAction::Decode, [this, &report](size_t idx, LONG value)
+			{
+				updateAxis(idx, value, report.timestamp);
+			});
+
+			// Output set
+			if (device()->readButtons(report.bytes(), _decodedButtons))
+			{
+				setButtonStates(_decodedButtons, accumulate_edges);
+				accumulate_edges = true;
+			}
+		}
+
+		// Relative axes report the change over the whole batch
+		const uint64_t last_timestamp = reports[reports.size() - 1].timestamp;
+		for (size_t i = 0; i < layout.axes.size(); i++)
+		{
+			const uint8_t slot = layout.axisSlots[i];
+			if (layout.axes[i].isAbsolute || slot >= UsageSlot::NrAxes)
+				continue;
+
+			const float delta = device()->normalizeDelta(i, _deltas[i]);
+			setAxisState(slot, static_cast<int32_t>(_deltas[i]), delta);
+			if (collectsEvents() && _deltas[i] != 0)
+				addEvent(last_timestamp, InputEventType::Axis, slot, delta);
+		}
+
+		// Any report shows that the device is still alive
+		restartStaleTimer(last_timestamp);
+
+		// Held buttons repeat and detect long presses
+		if (accumulate_edges)
+		{
+			updateButtonTimers(this->buttonStates(), this->pressedButtons(), this->releasedButtons(), last_timestamp);
+			if (collectsEvents())
+				addButtonEvents(this->buttonStates(), this->pressedButtons(), this->releasedButtons(), last_timestamp);
+		}
+
+		return static_cast<size_t>(reports.size());
+	}
+
+	template<typename JoystickType>
+	void JoystickHID<JoystickType>::updateAxis(size_t idx, LONG value, uint64_t timestamp)
+	{
+		const auto& layout = *device()->layout();
+		const uint8_t slot = layout.axisSlots[idx];
+		if (slot >= UsageSlot::NrAxes)
+			return;
+
+		if (!layout.axes[idx].isAbsolute)
+		{
+			_deltas[idx] += value;
+		}
+		else if (device()->deferredNormalization())
+		{
+			device()->learnAxis(idx, value);
+			setAxisRaw(slot, value, device()->calibrator(idx));
+			if (collectsEvents())
+				addEvent(timestamp, InputEventType::Axis, slot, device()->calibrator(idx)->normalize(value));
+		}
+		else
+		{
+			const float normalized = device()->normalizeAxis(idx, value);
+			setAxisState(slot, value, normalized);
+			if (collectsEvents())
+				addEvent(timestamp, InputEventType::Axis, slot, normalized);
+		}
+	}
+
+	template<typename JoystickType>
+	void JoystickHID<JoystickType>::resetStaleState(uint64_t now)
+	{
+		const auto& layout = *device()->layout();
+		for (size_t i = 0; i < layout.axes.size(); i++)
+		{
+			const uint8_t slot = layout.axisSlots[i];
+			if (slot >= UsageSlot::NrAxes)
+				continue;
+
+			const int32_t rest = layout.axes[i].isAbsolute ? layout.axes[i].logicalCalibratedCenter : 0;
+			setAxisState(slot, rest, 0.0f);
+			if (collectsEvents())
+				addEvent(now, InputEventType::Axis, slot, 0.0f);
+		}
+
+		_decodedButtons.clear();
+		setButtonStates(_decodedButtons);
+		updateButtonTimers(this->buttonStates(), this->pressedButtons(), this->releasedButtons(), now);
+		if (collectsEvents())
+			addButtonEvents(this->buttonStates(), this->pressedButtons(), this->releasedButtons(), now);
+	}
+
+	template<typename JoystickType>
+	auto JoystickHID<JoystickType>::readNames() const -> std::pair<std::string_view, std::string_view>
+	{
+		return device()->readDeviceName();
+	}
+
+	template<typename GamepadType>
 	GamepadHID<GamepadType>::GamepadHID(std::unique_ptr<GenericHID> dev)
 	: AbstractHID{std::move(dev)}
 	, GamepadType()
 	{
 		static_assert(std::is_base_of<Gamepad, GamepadType>::value, "GamepadType must be a gamepad");
 		
-		const auto names = device()->readDeviceName();
-		setVendorName(names.first);
-		setDeviceName(names.second);
-		
-		setNrAxes(static_cast<uint32_t>(device()->axes().size()));
+		setNrAxes(device()->layout()->nrAxisSlots);
 		setNrButtons(static_cast<uint32_t>(device()->buttons().size()));
+		_decodedButtons.resize(nrButtons());
+
+		// Physical values are computed from the raw values with a single scale
+		const auto& layout = *device()->layout();
+		for (size_t i = 0; i < layout.axes.size(); i++)
+		{
+			const uint8_t slot = layout.axisSlots[i];
+			if (slot < UsageSlot::NrAxes)
+				setAxisPhysicalScale(slot, layout.axes[i].physical);
+		}
 	}
 
 	template<typename GamepadType>
-	bool GamepadHID<GamepadType>::processInput(HWND, UINT, PRAWINPUT raw_input)
+	size_t GamepadHID<GamepadType>::processReports(HWND, gsl::span<const RawReport> reports, InputStatistics& stats)
 	{
-		// We are not interested in keyboard or mouse data received via raw input
-		if (raw_input->header.dwType != RIM_TYPEHID)
-			return false;
+		if (!device()->preparsedData() || reports.empty())
+			return 0;
 
-		PHIDP_PREPARSED_DATA preparsed_data;
-		if (HidD_GetPreparsedData(device()->fileHandle(), &preparsed_data) == FALSE)
-		{
-			return{};
-		}
+		const auto actions = device()->selectReports(reports, stats);
 
-		// Free the allocated data structure at the end of the method
-		VCL_SCOPE_EXIT{ HidD_FreePreparsedData(preparsed_data); };
+		// Edges of all the reports of the batch are reported together
+		bool accumulate_edges = false;
 
-		for (const auto& axis : device()->axes())
+		const auto& layout = *device()->layout();
+		_deltas.assign(layout.axes.size(), 0);
+		for (size_t r = 0; r < static_cast<size_t>(reports.size()); r++)
 		{
-			// Read the value of the axis
-			ULONG value = 0;
+			const auto& report = reports[r];
+			const auto action = actions[r];
+			if (action == ReportAction::Skip || report.size == 0)
+				continue;
 
-			if (HidP_GetUsageValue(
-				HidP_Input, axis.usagePage, 0,
-				axis.usage, &value, preparsed_data,
-				(PCHAR)raw_input->data.hid.bRawData, raw_input->data.hid.dwSizeHid
-			) == HIDP_STATUS_SUCCESS)
+			// Absolute values of superseded reports are not needed
+			device()->readAxes(report, action == ReportAction::Decode, [this, &report](size_t idx, LONG value)
 			{
-				switch (axis.usage)
-				{
-				case HID_USAGE_GENERIC_X:
-					setAxisState(static_cast<uint32_t>(GamepadAxis::X), normalizeAxis(value, axis));
-					break;
+				updateAxis(idx, value, report.timestamp);
+			});
 
-				case HID_USAGE_GENERIC_Y:
-					setAxisState(static_cast<uint32_t>(GamepadAxis::Y), normalizeAxis(value, axis));
-					break;
+			// Output set
+			if (device()->readButtons(report.bytes(), _decodedButtons))
+			{
+				setButtonStates(_decodedButtons, accumulate_edges);
+				accumulate_edges = true;
+			}
+		}
 
-				case HID_USAGE_GENERIC_Z:
-					setAxisState(static_cast<uint32_t>(GamepadAxis::Z), normalizeAxis(value, axis));
-					break;
+		// Relative axes report the change over the whole batch
+		const uint64_t last_timestamp = reports[reports.size() - 1].timestamp;
+		for (size_t i = 0; i < layout.axes.size(); i++)
+		{
+			const uint8_t slot = layout.axisSlots[i];
+			if (layout.axes[i].isAbsolute || slot >= UsageSlot::NrAxes)
+				continue;
 
-				case HID_USAGE_GENERIC_RX:
-					setAxisState(static_cast<uint32_t>(GamepadAxis::RX), normalizeAxis(value, axis));
-					break;
-				case HID_USAGE_GENERIC_RY:
-					setAxisState(static_cast<uint32_t>(GamepadAxis::RY), normalizeAxis(value, axis));
-					break;
-				case HID_USAGE_GENERIC_HATSWITCH:
-					setHatState(value);
-					break;
-				default:
-					VclDebugError("Not implemented");
-				}
-			}
+			const float delta = device()->normalizeDelta(i, _deltas[i]);
+			setAxisState(slot, static_cast<int32_t>(_deltas[i]), delta);
+			if (collectsEvents() && _deltas[i] != 0)
+				addEvent(last_timestamp, InputEventType::Axis, slot, delta);
 		}
 
-		// Output set
-		std::bitset<32> button_states;
+		// Any report shows that the device is still alive
+		restartStaleTimer(last_timestamp);
 
-		USAGE usages[128];
-		ULONG nr_usages = 128;
-		for (const auto& button_caps : device()->buttonCaps())
+		// Held buttons repeat and detect long presses
+		if (accumulate_edges)
 		{
-			if (HidP_GetUsages(
-				HidP_Input, button_caps.UsagePage, 0,
-				usages, &nr_usages, preparsed_data,
-				(PCHAR)raw_input->data.hid.bRawData, raw_input->data.hid.dwSizeHid
-			) == HIDP_STATUS_SUCCESS)
-			{
-				for (ULONG i = 0; i < std::min(nr_usages, 32ul); i++)
-				{
-					button_states[usages[i] - button_caps.Range.UsageMin] = true;
-				}
-			}
+			updateButtonTimers(this->buttonStates(), this->pressedButtons(), this->releasedButtons(), last_timestamp);
+			if (collectsEvents())
+				addButtonEvents(this->buttonStates(), this->pressedButtons(), this->releasedButtons(), last_timestamp);
 		}
-		setButtonStates(std::move(button_states));
 
-		return true;
+		return static_cast<size_t>(reports.size());
 	}
-	
+
+	template<typename GamepadType>
+	void GamepadHID<GamepadType>::updateAxis(size_t idx, LONG value, uint64_t timestamp)
+	{
+		const auto& layout = *device()->layout();
+		const uint8_t slot = layout.axisSlots[idx];
+		if (slot == UsageSlot::Hat)
+		{
+			setHatState(static_cast<uint32_t>(value));
+			return;
+		}
+		if (slot >= UsageSlot::NrAxes)
+			return;
+
+		if (!layout.axes[idx].isAbsolute)
+		{
+			_deltas[idx] += value;
+		}
+		else if (device()->deferredNormalization())
+		{
+			device()->learnAxis(idx, value);
+			setAxisRaw(slot, value, device()->calibrator(idx));
+			if (collectsEvents())
+				addEvent(timestamp, InputEventType::Axis, slot, device()->calibrator(idx)->normalize(value));
+		}
+		else
+		{
+			const float normalized = device()->normalizeAxis(idx, value);
+			setAxisState(slot, value, normalized);
+			if (collectsEvents())
+				addEvent(timestamp, InputEventType::Axis, slot, normalized);
+		}
+	}
+
+	template<typename GamepadType>
+	void GamepadHID<GamepadType>::resetStaleState(uint64_t now)
+	{
+		const auto& layout = *device()->layout();
+		for (size_t i = 0; i < layout.axes.size(); i++)
+		{
+			const uint8_t slot = layout.axisSlots[i];
+			if (slot >= UsageSlot::NrAxes)
+				continue;
+
+			const int32_t rest = layout.axes[i].isAbsolute ? layout.axes[i].logicalCalibratedCenter : 0;
+			setAxisState(slot, rest, 0.0f);
+			if (collectsEvents())
+				addEvent(now, InputEventType::Axis, slot, 0.0f);
+		}
+		setHatState(static_cast<uint32_t>(GamepadHat::None));
+
+		_decodedButtons.clear();
+		setButtonStates(_decodedButtons);
+		updateButtonTimers(this->buttonStates(), this->pressedButtons(), this->releasedButtons(), now);
+		if (collectsEvents())
+			addButtonEvents(this->buttonStates(), this->pressedButtons(), this->releasedButtons(), now);
+	}
+
+	template<typename GamepadType>
+	auto GamepadHID<GamepadType>::readNames() const -> std::pair<std::string_view, std::string_view>
+	{
+		return device()->readDeviceName();
+	}
+
 	template<typename ControllerType>
 	MultiAxisControllerHID<ControllerType>::MultiAxisControllerHID(std::unique_ptr<GenericHID> dev)
 	: AbstractHID{std::move(dev)}
@@ -745,26 +1247,92 @@ namespace Vcl { namespace HID { namespace Windows
 	{
 		static_assert(std::is_base_of<MultiAxisController, ControllerType>::value, "ControllerType must be a multi-axis controller");
 		
-		const auto names = device()->readDeviceName();
-		setVendorName(names.first);
-		setDeviceName(names.second);
-		
 		setNrAxes(static_cast<uint32_t>(device()->axes().size()));
 		setNrButtons(static_cast<uint32_t>(device()->buttons().size()));
+		_decodedButtons.resize(nrButtons());
+		// Axes are numbered in the order of the device caps
+		const auto& axes = device()->axes();
+		for (size_t i = 0; i < axes.size(); i++)
+			setAxisPhysicalScale(static_cast<uint32_t>(i), axes[i].physical);
 	}
 	
 	template<typename ControllerType>
-	bool MultiAxisControllerHID<ControllerType>::processInput(HWND, UINT, PRAWINPUT raw_input)
+	size_t MultiAxisControllerHID<ControllerType>::processReports(HWND, gsl::span<const RawReport> reports, InputStatistics& stats)
 	{
-		// We are not interested in keyboard or mouse data received via raw input
-		if (raw_input->header.dwType != RIM_TYPEHID)
-			return false;
+		if (!device()->preparsedData())
+			return 0;
 
-		return false;
+		const auto actions = device()->selectReports(reports, stats);
+
+		// Edges of all the reports of the batch are reported together
+		bool accumulate_edges = false;
+
+		const auto& axes = device()->axes();
+		_deltas.assign(axes.size(), 0);
+		for (size_t r = 0; r < static_cast<size_t>(reports.size()); r++)
+		{
+			const auto& report = reports[r];
+			const auto action = actions[r];
+			if (action == ReportAction::Skip || report.size == 0)
+				continue;
+
+			// Absolute values of superseded reports are not needed
+			device()->readAxes(report, action == ReportAction::Decode, [this](size_t idx, LONG value)
+			{
+				updateAxis(idx, value);
+			});
+
+			if (device()->readButtons(report.bytes(), _decodedButtons))
+			{
+				setButtonStates(_decodedButtons, accumulate_edges);
+				accumulate_edges = true;
+			}
+		}
+
+		// Relative axes report the change over the whole batch
+		for (size_t i = 0; i < axes.size(); i++)
+		{
+			if (!axes[i].isAbsolute)
+				setAxisState(static_cast<uint32_t>(i), static_cast<int32_t>(_deltas[i]), device()->normalizeDelta(i, _deltas[i]));
+		}
+
+		return static_cast<size_t>(reports.size());
+	}
+
+	template<typename ControllerType>
+	void MultiAxisControllerHID<ControllerType>::updateAxis(size_t idx, LONG value)
+	{
+		// Axes are numbered in the order of the device caps
+		const auto slot = static_cast<uint32_t>(idx);
+		if (!device()->axes()[idx].isAbsolute)
+			_deltas[idx] += value;
+		else if (device()->deferredNormalization())
+		{
+			device()->learnAxis(idx, value);
+			setAxisRaw(slot, value, device()->calibrator(idx));
+		}
+		else
+			setAxisState(slot, value, device()->normalizeAxis(idx, value));
+	}
+
+	template<typename ControllerType>
+	auto MultiAxisControllerHID<ControllerType>::readNames() const -> std::pair<std::string_view, std::string_view>
+	{
+		return device()->readDeviceName();
 	}
 	
-	DeviceManager::DeviceManager()
+	DeviceManager::DeviceManager(const std::string& calibration_path)
+	: _calibrationPath(calibration_path)
+	, _timers(timestamp())
+	, _created(timestamp())
 	{
+		auto calibration = std::make_unique<CalibrationDatabase>();
+		if (!_calibrationPath.empty())
+		{
+			calibration->open(_calibrationPath);
+		}
+		_calibration.store(calibration.release(), std::memory_order_seq_cst);
+
 		// Get a list of all devices provided by the raw input API
 		UINT max_nr_HIDs = 0;
 		if (GetRawInputDeviceList(nullptr, &max_nr_HIDs, sizeof(RAWINPUTDEVICELIST)) != 0)
@@ -780,121 +1348,730 @@ namespace Vcl { namespace HID { namespace Windows
 			return;
 		}
 
+		descriptors.resize(nr_found_HIDs);
+
+		std::vector<HANDLE> handles;
+		handles.reserve(descriptors.size());
 		for (auto const& desc : descriptors)
 		{
-			// Read the device info in order to determine the exact device type
-			RID_DEVICE_INFO dev_info = {};
-			dev_info.cbSize = sizeof(RID_DEVICE_INFO);
+			handles.push_back(desc.hDevice);
+		}
 
-			UINT dev_info_size = sizeof(RID_DEVICE_INFO);
-			auto bytes_copied = GetRawInputDeviceInfoW(desc.hDevice, RIDI_DEVICEINFO, &dev_info, &dev_info_size);
-			if (bytes_copied != sizeof(RID_DEVICE_INFO))
-			{
-				continue;
-			}
+		std::lock_guard<std::mutex> guard{ _writeLock };
+
+		// Scrape the data of all new devices at once
+		importCalibration(handles);
+
+		for (auto const& handle : handles)
+		{
+			insertDevice(handle);
+		}
+		publishDevices();
+	}
+
+	DeviceManager::~DeviceManager()
+	{
+		// Keep the learned data for the next start
+		if (_autoCalibration.load(std::memory_order_relaxed))
+			saveCalibration();
+
+		// No reader may be active anymore. Retired objects are
+		// reclaimed by the epoch domain.
+		delete _table.load();
+		delete _calibration.load();
+	}
+
+	std::unique_ptr<AbstractHID> DeviceManager::createDevice(HANDLE raw_handle)
+	{
+		// Read the device info in order to determine the exact device type
+		RID_DEVICE_INFO dev_info = {};
+		dev_info.cbSize = sizeof(RID_DEVICE_INFO);
+
+		UINT dev_info_size = sizeof(RID_DEVICE_INFO);
+		auto bytes_copied = GetRawInputDeviceInfoW(raw_handle, RIDI_DEVICEINFO, &dev_info, &dev_info_size);
+		if (bytes_copied != sizeof(RID_DEVICE_INFO))
+		{
+			return nullptr;
+		}
 
-			// New device
-			std::unique_ptr<AbstractHID> device;
+		// New device
+		std::unique_ptr<AbstractHID> device;
 
-			/*if (dev_info.dwType == RIM_TYPEMOUSE)
+		/*if (dev_info.dwType == RIM_TYPEMOUSE)
+		{
+			device = std::make_unique<GenericHID>(raw_handle);
+		}
+		else if (dev_info.dwType == RIM_TYPEKEYBOARD)
+		{
+			device = std::make_unique<GenericHID>(raw_handle);
+		}
+		else*/ if (const USAGE usage = deviceUsage(dev_info))
+		{
+			// Instantiate the generic HID and pass it to the actual
+			// implemenation.
+			auto hid = std::make_unique<GenericHID>(raw_handle, _strings, *_calibration.load(), _layouts);
+			hid->setAutoCalibration(_autoCalibration.load(std::memory_order_relaxed));
+			hid->setCoalescing(_coalescing.load(std::memory_order_relaxed));
+			hid->setDeferredNormalization(_deferredNormalization.load(std::memory_order_relaxed));
+
+			// Prefer the decoders generated for known devices
+			hid->setGeneratedDecoder(findGeneratedDecoder(
+				static_cast<uint16_t>(hid->vendorId()), static_cast<uint16_t>(hid->productId()), hid->layoutHash()));
+
+			switch (usage)
+			{
+			case 0x04:
 			{
-				device = std::make_unique<GenericHID>(desc.hDevice);
+				device = std::make_unique<JoystickHID<Joystick>>(std::move(hid));
+				break;
 			}
-			else if (dev_info.dwType == RIM_TYPEKEYBOARD)
+			case 0x05:
 			{
-				device = std::make_unique<GenericHID>(desc.hDevice);
+				device = std::make_unique<GamepadHID<Gamepad>>(std::move(hid));
+				break;
 			}
-			else*/ if (dev_info.dwType == RIM_TYPEHID)
+			case 0x08:
 			{
-				if (dev_info.hid.usUsagePage == 1)
+				// Identify the device through its IDs in order to avoid
+				// reading the names during startup
+				if (findSpaceMouseModel(dev_info.hid.dwVendorId, dev_info.hid.dwProductId))
 				{
-					// Instantiate the generic HID and pass it to the actual
-					// implemenation.
-					auto hid = std::make_unique<GenericHID>(desc.hDevice);
-
-					switch (dev_info.hid.usUsage)
-					{
-					case 0x04:
-					{
-						device = std::make_unique<JoystickHID<Joystick>>(std::move(hid));
-						break;
-					}
-					case 0x05:
-					{
-						device = std::make_unique<GamepadHID<Gamepad>>(std::move(hid));
-						break;
-					}
-					case 0x08:
-					{
-						const auto names = hid->readDeviceName();
-						if (dev_info.hid.dwVendorId == SpaceNavigator::LogitechVendorID &&
-							names.first == L"3Dconnexion" && names.second == L"SpaceNavigator")
-						{
-							device = std::make_unique<SpaceNavigatorHID>(std::move(hid));
-						}
-						else
-						{
-							device = std::make_unique<MultiAxisControllerHID<MultiAxisController>>(std::move(hid));
-						}
-						break;
-					}
-					}
-					// Store a link to the created device for external use
-					if (device)
-					{
-						_deviceLinks.emplace_back(dynamic_cast<Device*>(device.get()));
-						_devices.emplace_back(std::move(device));
-					}
+					device = std::make_unique<SpaceNavigatorHID>(std::move(hid), _spaceNavigatorPolling.load(std::memory_order_relaxed));
+				}
+				else
+				{
+					device = std::make_unique<MultiAxisControllerHID<MultiAxisController>>(std::move(hid));
 				}
+				break;
+			}
 			}
 		}
+
+		return device;
 	}
 
-	gsl::span<Device const* const> DeviceManager::devices() const
+	bool DeviceManager::storeCalibration(gsl::span<const CalibrationRecord> records)
 	{
-		Device const* const* ptr = _deviceLinks.data();
-		return gsl::make_span<Device const* const>(ptr, _deviceLinks.size());
+		std::lock_guard<std::mutex> guard{ _writeLock };
+
+		CalibrationDatabaseBuilder builder{ *_calibration.load() };
+		for (const auto& record : records)
+		{
+			builder.add(record);
+		}
+
+		return commitCalibration(builder);
+	}
+
+	void DeviceManager::setAutoCalibration(bool enable)
+	{
+		std::lock_guard<std::mutex> guard{ _writeLock };
+
+		_autoCalibration.store(enable, std::memory_order_relaxed);
+		for (const auto& device : _devices)
+		{
+			device->device()->setAutoCalibration(enable);
+		}
+	}
+
+	void DeviceManager::setCoalescing(bool enable)
+	{
+		std::lock_guard<std::mutex> guard{ _writeLock };
+
+		_coalescing.store(enable, std::memory_order_relaxed);
+		for (const auto& device : _devices)
+		{
+			device->device()->setCoalescing(enable);
+		}
+	}
+
+	void DeviceManager::setDeferredNormalization(bool enable)
+	{
+		std::lock_guard<std::mutex> guard{ _writeLock };
+
+		_deferredNormalization.store(enable, std::memory_order_relaxed);
+		for (const auto& device : _devices)
+		{
+			device->device()->setDeferredNormalization(enable);
+		}
+	}
+
+	bool DeviceManager::saveCalibration()
+	{
+		std::lock_guard<std::mutex> guard{ _writeLock };
+
+		CalibrationDatabaseBuilder builder{ *_calibration.load() };
+		size_t nr_records = 0;
+		for (const auto& device : _devices)
+		{
+			for (const auto& record : device->device()->learnedCalibration())
+			{
+				builder.add(record);
+				nr_records++;
+			}
+		}
+
+		if (nr_records == 0)
+			return true;
+
+		return commitCalibration(builder);
+	}
+
+	bool DeviceManager::importCalibration(gsl::span<const HANDLE> raw_handles)
+	{
+		CalibrationDatabaseBuilder builder{ *_calibration.load() };
+		bool updated = false;
+		for (const auto raw_handle : raw_handles)
+		{
+			RID_DEVICE_INFO dev_info = {};
+			dev_info.cbSize = sizeof(RID_DEVICE_INFO);
+
+			UINT dev_info_size = sizeof(RID_DEVICE_INFO);
+			if (GetRawInputDeviceInfoW(raw_handle, RIDI_DEVICEINFO, &dev_info, &dev_info_size) != sizeof(RID_DEVICE_INFO))
+				continue;
+
+			// Only the devices created by 'createDevice' are considered
+			if (deviceUsage(dev_info) == 0)
+				continue;
+
+			const auto vendor_id = static_cast<uint16_t>(dev_info.hid.dwVendorId);
+			const auto product_id = static_cast<uint16_t>(dev_info.hid.dwProductId);
+			if (_calibration.load()->contains(vendor_id, product_id))
+				continue;
+
+			updated |= importDirectInputCalibration(raw_handle, builder);
+		}
+
+		if (!updated)
+			return false;
+
+		return commitCalibration(builder);
+	}
+
+	bool DeviceManager::commitCalibration(const CalibrationDatabaseBuilder& builder)
+	{
+		// Layouts of new devices pick up the changed names and calibrations
+		_layouts.clear();
+
+		// Readers may still access the old version, including its mapped
+		// file. The new version is thus served from memory.
+		auto calibration = std::make_unique<CalibrationDatabase>();
+		if (!calibration->load(builder.serialize()))
+			return false;
+
+		auto old_calibration = _calibration.exchange(calibration.release(), std::memory_order_seq_cst);
+		_epochs.retire(const_cast<CalibrationDatabase*>(old_calibration));
+		_epochs.collect();
+
+		if (_calibrationPath.empty())
+			return true;
+
+		// The file can only be replaced once the old mapping is released,
+		// which is the case if no reader accesses the old version anymore
+		return builder.write(_calibrationPath);
+	}
+
+	bool DeviceManager::insertDevice(HANDLE raw_handle)
+	{
+		// Windows reports all present devices once they are registered
+		// for notifications. Ignore devices which are already known.
+		auto dev_it = std::find_if(_devices.begin(), _devices.end(), [raw_handle](const auto& device)
+		{
+			return device->device()->rawHandle() == raw_handle;
+		});
+		if (dev_it != _devices.end())
+			return false;
+
+		auto device = createDevice(raw_handle);
+		if (!device)
+			return false;
+
+		device->attachTimers(&_timers, &_timerLock, &_timerSettings);
+		_devices.emplace_back(std::move(device));
+		return true;
+	}
+
+	bool DeviceManager::addDevice(HANDLE raw_handle)
+	{
+		std::lock_guard<std::mutex> guard{ _writeLock };
+		importCalibration(gsl::make_span(&raw_handle, 1));
+		if (!insertDevice(raw_handle))
+			return false;
+
+		publishDevices();
+		return true;
+	}
+
+	bool DeviceManager::removeDevice(HANDLE raw_handle)
+	{
+		std::lock_guard<std::mutex> guard{ _writeLock };
+
+		auto dev_it = std::find_if(_devices.begin(), _devices.end(), [raw_handle](const auto& device)
+		{
+			return device->device()->rawHandle() == raw_handle;
+		});
+		if (dev_it == _devices.end())
+			return false;
+
+		// Keep the data learned by the device for the next time it is connected
+		const auto learned = (*dev_it)->device()->learnedCalibration();
+		if (!learned.empty())
+		{
+			CalibrationDatabaseBuilder builder{ *_calibration.load() };
+			for (const auto& record : learned)
+				builder.add(record);
+			commitCalibration(builder);
+		}
+
+		// Pending timers must not reach the removed device
+		{
+			std::lock_guard<std::mutex> timer_guard{ _timerLock };
+			_timers.cancelAll(dev_it->get());
+			(*dev_it)->attachTimers(nullptr, nullptr, nullptr);
+		}
+
+		// Readers may still access the device through an old snapshot
+		auto removed = dev_it->release();
+		_devices.erase(dev_it);
+		publishDevices();
+		_epochs.retire(removed);
+		_epochs.collect();
+
+		return true;
+	}
+
+	void DeviceManager::publishDevices()
+	{
+		auto table = std::make_unique<DeviceTable>();
+		table->hids.reserve(_devices.size());
+		table->devices.reserve(_devices.size());
+		for (const auto& device : _devices)
+		{
+			// Store a link to the device for external use
+			table->hids.emplace_back(device.get());
+			table->devices.emplace_back(dynamic_cast<Device*>(device.get()));
+		}
+
+		auto old_table = _table.exchange(table.release(), std::memory_order_seq_cst);
+		_generation.fetch_add(1, std::memory_order_acq_rel);
+		if (old_table)
+		{
+			_epochs.retire(const_cast<DeviceTable*>(old_table));
+			_epochs.collect();
+		}
+	}
+
+	AbstractHID* DeviceManager::findDevice(const DeviceTable& table, HANDLE raw_handle)
+	{
+		auto dev_it = std::find_if(table.hids.begin(), table.hids.end(), [raw_handle](const AbstractHID* device)
+		{
+			return device->device()->rawHandle() == raw_handle;
+		});
+
+		return dev_it != table.hids.end() ? *dev_it : nullptr;
+	}
+
+	bool DeviceManager::processDeviceChange(HWND, UINT message, WPARAM wide_param, LPARAM low_param)
+	{
+		VclRequire(message == WM_INPUT_DEVICE_CHANGE, "Is called while processing WM_INPUT_DEVICE_CHANGE");
+
+		// Only the affected device is probed or removed
+		HANDLE raw_handle = reinterpret_cast<HANDLE>(low_param);
+		switch (wide_param)
+		{
+		case GIDC_ARRIVAL:
+			return addDevice(raw_handle);
+		case GIDC_REMOVAL:
+			return removeDevice(raw_handle);
+		}
+
+		return false;
 	}
 
-	bool DeviceManager::poll(HWND window_handle, UINT input_code)
+	void DeviceManager::setHotplugSource(std::unique_ptr<HotplugSource> source)
+	{
+		std::lock_guard<std::mutex> guard{ _hotplugLock };
+		_hotplugSource = std::move(source);
+	}
+
+	bool DeviceManager::pollHotplug()
+	{
+		std::lock_guard<std::mutex> guard{ _hotplugLock };
+		if (!_hotplugSource)
+			return false;
+
+		_hotplugEvents.clear();
+		_hotplugSource->poll(_hotplugEvents);
+
+		bool changed = false;
+		for (const auto& event : _hotplugEvents)
+		{
+			switch (event.action)
+			{
+			case HotplugAction::Arrival:
+				changed |= addDevice(event.handle);
+				break;
+			case HotplugAction::Removal:
+				changed |= removeDevice(event.handle);
+				break;
+			}
+		}
+
+		return changed;
+	}
+
+	DeviceList DeviceManager::devices() const
+	{
+		auto guard = _epochs.pin();
+		const auto table = _table.load(std::memory_order_seq_cst);
+		if (!table)
+			return { std::move(guard), {} };
+
+		Device const* const* ptr = table->devices.data();
+		return { std::move(guard), gsl::make_span<Device const* const>(ptr, table->devices.size()) };
+	}
+
+	CalibrationView DeviceManager::calibration() const
+	{
+		auto guard = _epochs.pin();
+		return { std::move(guard), _calibration.load(std::memory_order_seq_cst) };
+	}
+
+	bool DeviceManager::poll(HWND window_handle, UINT)
 	{
 		UINT input_buffer_size;
 		if (GetRawInputBuffer(nullptr, &input_buffer_size, sizeof(RAWINPUTHEADER)) != 0)
 			return false;
 
 		// According to the MSDN documentation use '*pcbSize * 8'.
-		// Add an additional 8 bytes for alignment
-		input_buffer_size *= 9;
+		// The buffer is allocated in words in order to be correctly aligned.
+		input_buffer_size *= 8;
+		_inputBuffer.resize((input_buffer_size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
 
-		auto raw_input_buffer = std::make_unique<uint8_t[]>(input_buffer_size);
-		auto aligned_raw_input_buffer = Mathematics::ceil<8>(reinterpret_cast<uint64_t>(raw_input_buffer.get()));
-		auto raw_input = reinterpret_cast<PRAWINPUT>(aligned_raw_input_buffer);
+		auto raw_input = reinterpret_cast<PRAWINPUT>(_inputBuffer.data());
 		UINT nr_buffers = GetRawInputBuffer(raw_input, &input_buffer_size, sizeof(RAWINPUTHEADER));
 		if (nr_buffers == UINT_MAX)
 			return false;
 
+		// Collect the reports of all the messages
+		const auto time = timestamp();
+		_rawInputs.clear();
+		_reports.clear();
 		for (UINT i = 0; i < nr_buffers; i++)
 		{
-			// Pass the input data to the correct device
-			auto dev_it = std::find_if(_devices.begin(), _devices.end(), [&raw_input](const auto& device)
+			_rawInputs.push_back(raw_input);
+			appendReports(raw_input, time, _reports);
+
+			raw_input = NEXTRAWINPUTBLOCK(raw_input);
+		}
+
+		const size_t nr_processed = ingestReports(_reports, window_handle);
+
+		// Clean the buffer
+		if (nr_processed < _reports.size() || _reports.empty())
+			::DefRawInputProc(_rawInputs.data(), static_cast<INT>(_rawInputs.size()), sizeof(RAWINPUTHEADER));
+
+		return true;
+	}
+
+	size_t DeviceManager::processReports(gsl::span<const RawReport> reports, HWND window_handle)
+	{
+		const size_t nr_reports = static_cast<size_t>(reports.size());
+		const size_t batch_size = _batchSize.load(std::memory_order_relaxed);
+
+		_nrProcessingPasses.fetch_add(1, std::memory_order_relaxed);
+
+		size_t nr_processed = 0;
+		for (size_t first = 0; first < nr_reports; first += batch_size)
+		{
+			const size_t count = nr_reports - first < batch_size ? nr_reports - first : batch_size;
+			nr_processed += processBatch(reports.subspan(first, count), window_handle);
+		}
+
+		return nr_processed;
+	}
+
+	size_t DeviceManager::ingestReports(gsl::span<const RawReport> reports, HWND window_handle)
+	{
+		if (reports.empty())
+			return 0;
+
+		const uint64_t budget = _latencyBudget.load(std::memory_order_relaxed);
+		if (budget == 0 && _pendingReports.empty())
+			return processReports(reports, window_handle);
+
+		const uint64_t now = timestamp();
+		if (_pendingReports.empty())
+			_pendingSince = now;
+		_pendingWindow = window_handle;
+
+		// Button changes are not delayed
+		bool has_edge = false;
+		{
+			const auto guard = _epochs.pin();
+			const auto table = _table.load(std::memory_order_seq_cst);
+			for (const auto& report : reports)
+			{
+				auto device = table ? findDevice(*table, report.device) : nullptr;
+				if (device && device->hasButtonEdge(report))
+					has_edge = true;
+
+				// The raw input buffer is reused by the next message
+				_pendingOffsets.push_back(_pendingData.size());
+				_pendingData.insert(_pendingData.end(), report.data, report.data + report.size);
+				_pendingReports.push_back(report);
+			}
+		}
+
+		if (has_edge)
+		{
+			_nrImmediatePasses.fetch_add(1, std::memory_order_relaxed);
+			flushPendingReports(now);
+		}
+		else if (now >= _pendingSince + budget)
+		{
+			flushPendingReports(now);
+		}
+
+		return static_cast<size_t>(reports.size());
+	}
+
+	size_t DeviceManager::flushPendingReports(uint64_t now)
+	{
+		if (_pendingReports.empty())
+			return 0;
+
+		uint64_t total_latency = 0;
+		uint64_t max_latency = 0;
+		for (size_t i = 0; i < _pendingReports.size(); i++)
+		{
+			auto& report = _pendingReports[i];
+			report.data = _pendingData.data() + _pendingOffsets[i];
+
+			const uint64_t latency = now > report.timestamp ? now - report.timestamp : 0;
+			total_latency += latency;
+			max_latency = std::max(max_latency, latency);
+		}
+
+		_nrDeferredReports.fetch_add(_pendingReports.size(), std::memory_order_relaxed);
+		_totalAddedLatency.fetch_add(total_latency, std::memory_order_relaxed);
+		if (max_latency > _maxAddedLatency.load(std::memory_order_relaxed))
+			_maxAddedLatency.store(max_latency, std::memory_order_relaxed);
+
+		const size_t nr_processed = processReports(_pendingReports, _pendingWindow);
+
+		_pendingReports.clear();
+		_pendingOffsets.clear();
+		_pendingData.clear();
+
+		return nr_processed;
+	}
+
+	size_t DeviceManager::processBatch(gsl::span<const RawReport> reports, HWND window_handle)
+	{
+		// Group the reports by device, keeping the order of the reports of each device
+		_batch.assign(reports.begin(), reports.end());
+		std::stable_sort(_batch.begin(), _batch.end(), [](const RawReport& a, const RawReport& b)
+		{
+			return std::less<>{}(a.device, b.device);
+		});
+
+		// Devices stay alive while they are processed
+		const auto guard = _epochs.pin();
+		const auto table = _table.load(std::memory_order_seq_cst);
+
+		// Devices only collect events if they are dispatched
+		const auto handler = _batchedHandler.load(std::memory_order_acquire);
+		_eventSources.clear();
+
+		InputStatistics skipped;
+		size_t nr_processed = 0;
+		size_t nr_unknown = 0;
+		size_t nr_groups = 0;
+
+		// Devices lock the timers only while they update them, since the
+		// SpaceNavigator invokes its handlers while processing the reports
+		for (auto first = _batch.begin(); first != _batch.end();)
+		{
+			const auto handle = first->device;
+			const auto last = std::find_if(first, _batch.end(), [handle](const RawReport& report)
 			{
-				return device->device()->rawHandle() == raw_input->header.hDevice;
+				return report.device != handle;
 			});
+			const gsl::span<const RawReport> group{ &*first, static_cast<std::ptrdiff_t>(last - first) };
 
-			bool processed = false;
-			if (dev_it != _devices.end())
-				processed = (*dev_it)->processInput(window_handle, input_code, raw_input);
-			
-			// Clean the buffer
-			if (!processed)
-				::DefRawInputProc(&raw_input, 1, sizeof(RAWINPUTHEADER)); 
+			if (auto device = table ? findDevice(*table, handle) : nullptr)
+			{
+				device->setEventCollection(handler != nullptr);
+				nr_processed += device->processReports(window_handle, group, skipped);
+				nr_groups++;
 
-			raw_input = NEXTRAWINPUTBLOCK(raw_input);
+				if (!device->events().empty())
+					_eventSources.push_back(device);
+			}
+			else
+			{
+				nr_unknown += static_cast<size_t>(group.size());
+			}
+
+			first = last;
 		}
 
-		return true;
+		dispatchEvents(handler);
+
+		_nrReports.fetch_add(nr_processed, std::memory_order_relaxed);
+		_nrBatches.fetch_add(1, std::memory_order_relaxed);
+		_nrDeviceGroups.fetch_add(nr_groups, std::memory_order_relaxed);
+		_nrUnknownReports.fetch_add(nr_unknown, std::memory_order_relaxed);
+		_nrDuplicateReports.fetch_add(skipped.nrDuplicateReports, std::memory_order_relaxed);
+		_nrCoalescedReports.fetch_add(skipped.nrCoalescedReports, std::memory_order_relaxed);
+
+		return nr_processed;
+	}
+
+	InputStatistics DeviceManager::statistics() const
+	{
+		InputStatistics stats;
+		stats.nrReports = _nrReports.load(std::memory_order_relaxed);
+		stats.nrBatches = _nrBatches.load(std::memory_order_relaxed);
+		stats.nrDeviceGroups = _nrDeviceGroups.load(std::memory_order_relaxed);
+		stats.nrUnknownReports = _nrUnknownReports.load(std::memory_order_relaxed);
+		stats.nrDuplicateReports = _nrDuplicateReports.load(std::memory_order_relaxed);
+		stats.nrCoalescedReports = _nrCoalescedReports.load(std::memory_order_relaxed);
+		stats.nrWakeups = _nrWakeups.load(std::memory_order_relaxed);
+		stats.nrProcessingPasses = _nrProcessingPasses.load(std::memory_order_relaxed);
+		stats.nrImmediatePasses = _nrImmediatePasses.load(std::memory_order_relaxed);
+		stats.nrDeferredReports = _nrDeferredReports.load(std::memory_order_relaxed);
+		stats.totalAddedLatency = _totalAddedLatency.load(std::memory_order_relaxed);
+		stats.maxAddedLatency = _maxAddedLatency.load(std::memory_order_relaxed);
+		stats.latencyBudget = _latencyBudget.load(std::memory_order_relaxed);
+		stats.uptime = timestamp() - _created;
+		return stats;
 	}
 	
+	void DeviceManager::dispatchEvents(BatchedInputHandler* handler)
+	{
+		// Handlers may call back into the manager. A single call passes
+		// all the events of a device.
+		for (auto device : _eventSources)
+		{
+			handler->onInputEvents(dynamic_cast<const Device*>(device), device->events());
+			device->clearEvents();
+		}
+		_eventSources.clear();
+	}
+
+	size_t DeviceManager::processTimers()
+	{
+		const auto now = timestamp();
+
+		// Reports waited for the latency budget
+		if (!_pendingReports.empty() && now >= _pendingSince + _latencyBudget.load(std::memory_order_relaxed))
+			flushPendingReports(now);
+
+		// Devices stay alive while their events are dispatched
+		const auto guard = _epochs.pin();
+
+		_expiredTimers.clear();
+		{
+			std::lock_guard<std::mutex> timer_guard{ _timerLock };
+			_timers.advance(now, [this](const TimerEvent& event)
+			{
+				auto hid = static_cast<AbstractHID*>(const_cast<void*>(event.target));
+				_expiredTimers.emplace_back(hid, event);
+			});
+		}
+
+		// Devices reset their state and reschedule their timers without
+		// holding the lock, as they may invoke their handlers
+		const auto batched_handler = _batchedHandler.load(std::memory_order_acquire);
+		_eventSources.clear();
+		for (const auto& expired : _expiredTimers)
+		{
+			auto device = expired.first;
+			device->setEventCollection(batched_handler != nullptr);
+			device->processTimer(expired.second, now);
+
+			// A device resetting its state reports the released buttons and the centered axes
+			if (!device->events().empty() && std::find(_eventSources.begin(), _eventSources.end(), device) == _eventSources.end())
+				_eventSources.push_back(device);
+		}
+		dispatchEvents(batched_handler);
+
+		// Handlers may call back into the manager
+		auto handler = _timerHandler.load(std::memory_order_acquire);
+		if (handler)
+		{
+			for (const auto& expired : _expiredTimers)
+			{
+				const auto device = dynamic_cast<const Device*>(expired.first);
+				switch (static_cast<InputTimer>(expired.second.type))
+				{
+				case InputTimer::Stale:
+					handler->onDeviceStale(device);
+					break;
+				case InputTimer::Repeat:
+					handler->onButtonRepeat(device, expired.second.data);
+					break;
+				case InputTimer::LongPress:
+					handler->onButtonLongPress(device, expired.second.data);
+					break;
+				}
+			}
+		}
+
+		return _expiredTimers.size();
+	}
+
+	DWORD DeviceManager::timerTimeout() const
+	{
+		std::lock_guard<std::mutex> guard{ _timerLock };
+
+		uint64_t deadline = _timers.nextDeadline();
+		if (!_pendingReports.empty())
+			deadline = std::min(deadline, _pendingSince + _latencyBudget.load(std::memory_order_relaxed));
+		if (deadline == std::numeric_limits<uint64_t>::max())
+			return INFINITE;
+
+		const uint64_t now = timestamp();
+		if (deadline <= now)
+			return 0;
+
+		// Round up in order to not wake up early
+		const uint64_t timeout = (deadline - now + 999) / 1000;
+		return static_cast<DWORD>(std::min<uint64_t>(timeout, INFINITE - 1));
+	}
+
+	bool DeviceManager::waitForInput(HWND window_handle, DWORD wake_mask)
+	{
+		// Raw input arriving while reports wait for the latency budget is
+		// left in the queue until the budget expired
+		DWORD mask = wake_mask & ~QS_RAWINPUT;
+		if (_pendingReports.empty())
+			mask |= QS_RAWINPUT;
+
+		const DWORD result = ::MsgWaitForMultipleObjects(0, nullptr, FALSE, timerTimeout(), mask);
+		_nrWakeups.fetch_add(1, std::memory_order_relaxed);
+
+		// Read all the queued raw input at once
+		poll(window_handle, 0);
+		processTimers();
+
+		return result == WAIT_OBJECT_0;
+	}
+
+	void DeviceManager::setTimerSettings(const InputTimerSettings& settings)
+	{
+		std::lock_guard<std::mutex> guard{ _timerLock };
+		_timerSettings = settings;
+	}
+
+	InputTimerSettings DeviceManager::timerSettings() const
+	{
+		std::lock_guard<std::mutex> guard{ _timerLock };
+		return _timerSettings;
+	}
+
 	void DeviceManager::registerDevices(Flags<DeviceType> device_types, HWND window_handle)
 	{
 		std::vector<RAWINPUTDEVICE> input_requests;
@@ -913,10 +2090,12 @@ namespace Vcl { namespace HID { namespace Windows
 					input_requests.emplace_back(RAWINPUTDEVICE{ 0x01, 0x06, RIDEV_INPUTSINK | RIDEV_NOLEGACY, window_handle });
 					break;
 				case DeviceType::Joystick:
-					input_requests.emplace_back(RAWINPUTDEVICE{ 0x01, 0x04, RIDEV_INPUTSINK, window_handle });
+					input_requests.emplace_back(RAWINPUTDEVICE{ 0x01, 0x04, RIDEV_INPUTSINK | RIDEV_DEVNOTIFY, window_handle });
+					input_requests.emplace_back(RAWINPUTDEVICE{ UsagePage::SimulationControls, 0x00, RIDEV_PAGEONLY | RIDEV_INPUTSINK | RIDEV_DEVNOTIFY, window_handle });
+					input_requests.emplace_back(RAWINPUTDEVICE{ UsagePage::GameControls, 0x00, RIDEV_PAGEONLY | RIDEV_INPUTSINK | RIDEV_DEVNOTIFY, window_handle });
 					break;
 				case DeviceType::Gamepad:
-					input_requests.emplace_back(RAWINPUTDEVICE{ 0x01, 0x05, RIDEV_INPUTSINK, window_handle });
+					input_requests.emplace_back(RAWINPUTDEVICE{ 0x01, 0x05, RIDEV_INPUTSINK | RIDEV_DEVNOTIFY, window_handle });
 					break;
 				case DeviceType::MultiAxisController:
 					input_requests.emplace_back(RAWINPUTDEVICE{ 0x01, 0x08, RIDEV_INPUTSINK | RIDEV_DEVNOTIFY, window_handle });
@@ -946,30 +2125,21 @@ namespace Vcl { namespace HID { namespace Windows
 		GetRawInputData(raw_input_handle, RID_INPUT, nullptr, &buffer_size, sizeof(RAWINPUTHEADER));
 
 		// Allocate enough space to hold the input data
-		HANDLE heap_handle = GetProcessHeap();
-		PRAWINPUT raw_input = (PRAWINPUT)HeapAlloc(heap_handle, 0, buffer_size);
-		if (!raw_input)
-			return false;
+		_inputBuffer.resize((buffer_size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+		PRAWINPUT raw_input = reinterpret_cast<PRAWINPUT>(_inputBuffer.data());
 
 		// Read the input data
-		GetRawInputData(raw_input_handle, RID_INPUT, raw_input, &buffer_size, sizeof(RAWINPUTHEADER));
+		if (GetRawInputData(raw_input_handle, RID_INPUT, raw_input, &buffer_size, sizeof(RAWINPUTHEADER)) == UINT(-1))
+			return false;
 
 		// Pass the input data to the correct device
-		auto dev_it = std::find_if(_devices.begin(), _devices.end(), [&raw_input](const auto& device)
-		{
-			return device->device()->rawHandle() == raw_input->header.hDevice;
-		});
-
-		bool processed = false;
-		if (dev_it != _devices.end())
-		{
-			processed = (*dev_it)->processInput(window_handle, input_code, raw_input);
-		}
+		_reports.clear();
+		appendReports(raw_input, timestamp(), _reports);
+		const bool processed = !_reports.empty() && ingestReports(_reports, window_handle) == _reports.size();
 
 		// Clean the buffer
 		if (!processed)
 			::DefRawInputProc(&raw_input, 1, sizeof(RAWINPUTHEADER));
-		HeapFree(heap_handle, 0, raw_input);
 
 		// Check if any other input messages are still in the pipeline
 		poll(window_handle, input_code);
@@ -28,9 +28,13 @@
 #include <vcl/config/global.h>
 
 // C++ Standard library
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 // GSL
@@ -44,7 +48,24 @@ extern "C" {
 }
 
 // VCL
+#include <vcl/hid/axiscalibrator.h>
+#include <vcl/hid/buttonset.h>
+#include <vcl/hid/calibrationdatabase.h>
+#include <vcl/hid/decodeplan.h>
 #include <vcl/hid/device.h>
+#include <vcl/hid/devicelist.h>
+#include <vcl/hid/epoch.h>
+#include <vcl/hid/generateddecoder.h>
+#include <vcl/hid/hotplug.h>
+#include <vcl/hid/inputevent.h>
+#include <vcl/hid/inputstatistics.h>
+#include <vcl/hid/inputtimers.h>
+#include <vcl/hid/rawreport.h>
+#include <vcl/hid/reportcoalescer.h>
+#include <vcl/hid/stringtable.h>
+#include <vcl/hid/timerwheel.h>
+#include <vcl/hid/units.h>
+#include <vcl/hid/usagemap.h>
 
 namespace Vcl { namespace HID { namespace Windows
 {
@@ -62,6 +83,9 @@ namespace Vcl { namespace HID { namespace Windows
 
 		//! Index as defined through Hidp_GetData()
 		USHORT index;
+
+		//! ID of the report containing the axis
+		UCHAR reportId;
 		
 		//! Minimum value defined by the HID device
 		int32_t                logicalMinimum;
@@ -69,7 +93,13 @@ namespace Vcl { namespace HID { namespace Windows
 		//! Maximum value defined by the HID device
 		int32_t                logicalMaximum;
 
-		//! Indicate wheter DirectInput calibration data was applied
+		//! Number of bits of a value in the report
+		USHORT                 bitSize;
+
+		//! Indicate whether the axis reports absolute values (or changes otherwise)
+		bool                   isAbsolute;
+
+		//! Indicate wheter calibration data was applied
 		bool                   isCalibrated;
 		
 		//! Minimum value after calibration
@@ -81,14 +111,26 @@ namespace Vcl { namespace HID { namespace Windows
 		//! Through calibration defined center value of the axis
 		int32_t                logicalCalibratedCenter;
 
+		//! Through calibration defined noise around the center
+		int32_t                logicalCalibratedNoise;
+
 		//! Physical minimum value
 		int32_t physicalMinimum;
 
 		//! Physical maxiumum value
 		int32_t physicalMaximum;
 
-		//! Name as given by the driver
-		std::wstring name;
+		//! Unit of the physical values as encoded by the device
+		ULONG units;
+
+		//! Exponent of the physical unit as encoded by the device
+		ULONG unitExponent;
+
+		//! Mapping of the logical values to the physical unit
+		PhysicalScale physical;
+
+		//! Name as given by the driver (UTF-8, interned)
+		std::string_view name;
 	};
 
 	struct Button
@@ -102,8 +144,8 @@ namespace Vcl { namespace HID { namespace Windows
 		//! Index as defined through Hidp_GetData()
 		USHORT index;
 
-		//! Name as given by the driver
-		std::wstring name;
+		//! Name as given by the driver (UTF-8, interned)
+		std::string_view name;
 	};
 	
 	//! Normalize the axix value using the device configuration data
@@ -121,10 +163,104 @@ namespace Vcl { namespace HID { namespace Windows
 		}
 	}
 
+	//! Immutable description of the objects of a device and their location
+	//! in the reports. Shared by all devices with the same IDs and the same
+	//! report descriptor.
+	struct DeviceLayout
+	{
+		//! Vendor ID
+		DWORD vendorId{ 0 };
+
+		//! Product ID
+		DWORD productId{ 0 };
+
+		//! Hash of the preparsed data
+		uint64_t descriptorHash{ 0 };
+
+		//! Preparsed data (report descriptor) of the device
+		std::vector<uint8_t> preparsedData;
+
+		//! Buttons associated with the device
+		std::vector<Button> buttons;
+
+		//! Axes associated with the device
+		std::vector<Axis> axes;
+
+		//! State slot of each axis ('UsageSlot')
+		std::vector<uint8_t> axisSlots;
+
+		//! Number of axis slots up to the highest slot in use
+		uint32_t nrAxisSlots{ 0 };
+
+		//! HID button representation
+		std::vector<HIDP_BUTTON_CAPS> buttonCaps;
+
+		//! HID axis representation
+		std::vector<HIDP_VALUE_CAPS> axesCaps;
+
+		//! Plan decoding the reports
+		DecodePlan plan;
+
+		//! Hash of the report layout, zero if the layout is not fully known
+		uint64_t layoutHash{ 0 };
+
+		//! Axis indices in the order of the positions of the values in the reports
+		std::vector<uint32_t> valueOrder;
+
+		//! Indicate whether the buttons are numbered in the order of the reports
+		bool buttonsInReportOrder{ false };
+
+		//! Access the preparsed data in the format of the HID API
+		PHIDP_PREPARSED_DATA preparsed() const
+		{
+			return preparsedData.empty() ? nullptr : reinterpret_cast<PHIDP_PREPARSED_DATA>(const_cast<uint8_t*>(preparsedData.data()));
+		}
+	};
+
+	/*!
+	 *	Layouts of the present devices, indexed by their report descriptor
+	 *
+	 *	Identical devices share a single layout, which is released together
+	 *	with the last device using it.
+	 *	\note Not synchronized. Accessed by the device manager while holding its write lock.
+	 */
+	class DeviceLayoutCache
+	{
+	public:
+		//! Look up the layout of a device
+		//! \param vendor_id Vendor ID of the device
+		//! \param product_id Product ID of the device
+		//! \param preparsed_data Preparsed data of the device
+		//! \returns The layout, or null if no present device uses the layout
+		std::shared_ptr<const DeviceLayout> find(DWORD vendor_id, DWORD product_id, gsl::span<const uint8_t> preparsed_data) const;
+
+		//! Add a new layout
+		void insert(const std::shared_ptr<const DeviceLayout>& layout);
+
+		//! Forget all layouts, e.g. after the calibration data changed.
+		//! Devices keep their layouts.
+		void clear() { _layouts.clear(); }
+
+		//! Hash of the preparsed data of a device
+		static uint64_t hash(gsl::span<const uint8_t> preparsed_data);
+
+	private:
+		//! Layouts indexed by the hash of their preparsed data
+		std::unordered_multimap<uint64_t, std::weak_ptr<const DeviceLayout>> _layouts;
+	};
+
 	class GenericHID
 	{
 	public:
-		GenericHID(HANDLE raw_handle);
+		//! \param raw_handle Raw input API handle of the device
+		//! \param strings Table used to store the names of the device
+		//! \param calibration Calibration and naming data of the known devices
+		//! \param layouts Layouts shared with identical devices
+		GenericHID(HANDLE raw_handle, StringTable& strings, const CalibrationDatabase& calibration, DeviceLayoutCache& layouts);
+		GenericHID(const GenericHID&) = delete;
+		~GenericHID();
+
+		GenericHID& operator=(const GenericHID&) = delete;
 		
 		//! Access the raw-input API handle
 		//! \returns The input device handle
@@ -136,81 +272,366 @@ namespace Vcl { namespace HID { namespace Windows
 
 		//! Access the vendor ID
 		//! \returns The vendor ID
-		DWORD vendorId() const { return _vendorId; }
+		DWORD vendorId() const { return _layout->vendorId; }
 
 		//! Access the product ID
 		//! \returns The product ID
-		DWORD productId() const { return _productId; }
+		DWORD productId() const { return _layout->productId; }
 
 		//! Read the device name from the hardware
-		//! \returns The vendor defined names (vendor, product)
-		auto readDeviceName() const -> std::pair<std::wstring, std::wstring>;
+		//! \returns The vendor defined, interned names (vendor, product)
+		auto readDeviceName() const -> std::pair<std::string_view, std::string_view>;
+
+		//! Access the layout shared with identical devices
+		const std::shared_ptr<const DeviceLayout>& layout() const { return _layout; }
+
+		const std::vector<Axis>& axes() const { return _layout->axes; }
+		const std::vector<Button>& buttons() const { return _layout->buttons; }
+
+		const std::vector<HIDP_VALUE_CAPS>& axisCaps() const { return _layout->axesCaps; }
+		const std::vector<HIDP_BUTTON_CAPS>& buttonCaps() const { return _layout->buttonCaps; }
+
+		//! Enable the online calibration of the axes
+		void setAutoCalibration(bool enable) { _autoCalibration.store(enable, std::memory_order_relaxed); }
+
+		//! \returns True, if the axes are calibrated online
+		bool autoCalibration() const { return _autoCalibration.load(std::memory_order_relaxed); }
+
+		//! Normalize an axis value
+		//! \param idx Index of the axis in 'axes()'
+		//! \param value Logical value of the axis
+		//! \returns The value mapped to [-1, 1]
+		//! \note Updates the online calibration, if enabled. Must only be
+		//!       called by the thread processing the input of the device.
+		float normalizeAxis(size_t idx, LONG value);
+
+		//! Feed a logical value to the online calibration without normalizing it
+		//! \param idx Index of the axis in 'axes()'
+		//! \param value Logical value of the axis
+		//! \note Only has an effect if online calibration is enabled. Must only
+		//!       be called by the thread processing the input of the device.
+		void learnAxis(size_t idx, LONG value);
+
+		//! Defer the normalization of the absolute axes until they are read
+		//! Decoding then only extracts the logical values, while the online
+		//! calibration still learns from every decoded value.
+		void setDeferredNormalization(bool enable) { _deferredNormalization.store(enable, std::memory_order_relaxed); }
+
+		//! \returns True, if the axes are normalized on demand
+		bool deferredNormalization() const { return _deferredNormalization.load(std::memory_order_relaxed); }
+
+		//! Access the calibrator of an axis
+		const AxisCalibrator* calibrator(size_t idx) const { return &_calibrators[idx]; }
+
+		//! Normalize the accumulated change of a relative axis
+		//! \param idx Index of the axis in 'axes()'
+		//! \param delta Sum of the logical values reported by the axis
+		//! \returns The change relative to the logical range of the axis
+		float normalizeDelta(size_t idx, int64_t delta) const;
+
+		//! Interpret a value read from a report as signed, if the
+		//! logical range of the axis contains negative values
+		LONG logicalValue(size_t idx, ULONG value) const;
+
+		//! Enable the coalescing of the reports
+		void setCoalescing(bool enable) { _coalescer.setEnabled(enable); }
+
+		//! Allow skipping reports, which are identical to their predecessor
+		//! \note Must be configured before the device processes any input.
+		void setSuppressDuplicates(bool suppress) { _coalescer.setSuppressDuplicates(suppress); }
+
+		//! \returns True, if identical and superseded reports are skipped
+		bool coalescing() const { return _coalescer.isEnabled(); }
 
-		const std::vector<Axis>& axes() const { return _axes; }
-		const std::vector<Button>& buttons() const { return _buttons; }
+		//! Select the reports of a batch which need to be decoded
+		//! \note Must only be called by the thread processing the input of the device.
+		gsl::span<const ReportAction> selectReports(gsl::span<const RawReport> reports, InputStatistics& stats)
+		{
+			return _coalescer.select(reports, stats);
+		}
+
+		//! Access the preparsed data of the device
+		PHIDP_PREPARSED_DATA preparsedData() const { return _layout->preparsed(); }
+
+		//! Access the plan used to decode the reports
+		const DecodePlan& decodePlan() const { return _layout->plan; }
+
+		//! \returns The hash of the report layout, zero if the layout is not fully known
+		uint64_t layoutHash() const { return _layout->layoutHash; }
+
+		//! Use a generated decoder instead of the plan
+		//! \param decoder Decoder generated for the layout of this device, may be null
+		//! \note Must be configured before the device processes any input.
+		void setGeneratedDecoder(const GeneratedDecoder* decoder);
+
+		//! Access the generated decoder used for this device
+		const GeneratedDecoder* generatedDecoder() const { return _generated; }
+
+		//! Read the axis values contained in a report
+		//! \param report Report to decode
+		//! \param include_absolute Decode the absolute axes in addition to the relative ones
+		//! \param visitor Called with the index and the logical value of each decoded axis
+		//! \note Must only be called by the thread processing the input of the device.
+		template<typename Visitor>
+		void readAxes(const RawReport& report, bool include_absolute, Visitor&& visitor);
 
-		const std::vector<HIDP_VALUE_CAPS>& axisCaps() const { return _axesCaps; }
-		const std::vector<HIDP_BUTTON_CAPS>& buttonCaps() const { return _buttonCaps; }
+		//! Read the button states from a report
+		//! \param report Report data, starting with the report ID
+		//! \param buttons Button states, numbered consecutively across all button caps.
+		//!                Buttons of other reports are not changed.
+		//! \returns True, if the report contained buttons
+		//! \note Must only be called by the thread processing the input of the device.
+		bool readButtons(gsl::span<const uint8_t> report, ButtonSet& buttons);
+
+		//! Access the current calibration of an axis
+		AxisCalibration axisCalibration(size_t idx) const { return _calibrators[idx].calibration(); }
+
+		//! Collect the calibrations learned online
+		//! \returns Records of all axes with refined calibration data
+		std::vector<CalibrationRecord> learnedCalibration() const;
 
 	private:		
 		//! Read the device capabilities
-		auto readDeviceCaps() const -> std::tuple<std::vector<HIDP_BUTTON_CAPS>, std::vector<HIDP_VALUE_CAPS>>;
+		static auto readDeviceCaps(const DeviceLayout& layout) -> std::tuple<std::vector<HIDP_BUTTON_CAPS>, std::vector<HIDP_VALUE_CAPS>>;
 
-		//! Map buttons and fetch calibration data
-		//! \param mapping Direct Input related remapping of buttons
-		void readButtonCalibration(gsl::span<struct DirectInputButtonMapping> mapping) const;
+		//! Create the layout of the device from its preparsed data
+		//! \param layout Layout with the IDs and the preparsed data set
+		//! \param calibration Calibration and naming data of the known devices
+		void createLayout(DeviceLayout& layout, const CalibrationDatabase& calibration) const;
 
-		//! Map axes and fetch calibration data
-		//! \param axes_caps
-		void readAxisCalibration(const std::vector<HIDP_VALUE_CAPS>& axes_caps, gsl::span<struct DirectInputAxisMapping> mapping) const;
+		//! Compile the plan decoding the buttons and values directly from the reports
+		static void compileDecodePlan(DeviceLayout& layout);
 
 		//! Convert and store the button caps
+		//! \param layout Layout receiving the buttons
 		//! \param button_caps
-		//! \param mapping Direct Input related remapping of buttons
-		void storeButtons(std::vector<HIDP_BUTTON_CAPS>&& button_caps, gsl::span<struct DirectInputButtonMapping> mapping);
+		//! \param calibration Calibration and naming data of the known devices
+		void storeButtons(DeviceLayout& layout, std::vector<HIDP_BUTTON_CAPS>&& button_caps, const CalibrationDatabase& calibration) const;
 
 		//! Convert and store the axes caps
+		//! \param layout Layout receiving the axes
 		//! \param axes_caps
-		void storeAxes(std::vector<HIDP_VALUE_CAPS>&& axes_caps, gsl::span<struct DirectInputAxisMapping> mapping);
+		//! \param calibration Calibration and naming data of the known devices
+		void storeAxes(DeviceLayout& layout, std::vector<HIDP_VALUE_CAPS>&& axes_caps, const CalibrationDatabase& calibration) const;
+
+		//! Initialize the state kept per device
+		void initializeState();
 
 	private:
+		//! Table storing the device related strings
+		StringTable* _strings;
+
 		//! Handle provided by the raw input API
 		HANDLE _rawInputHandle{ nullptr };
 
 		//! Handle from the file API
 		HANDLE _fileHandle{ nullptr };
 
-		//! Vendor ID
-		DWORD _vendorId;
+		//! Description of the device objects, shared with identical devices
+		std::shared_ptr<const DeviceLayout> _layout;
 
-		//! Product ID
-		DWORD _productId;
+		//! Decoder generated for this device
+		const GeneratedDecoder* _generated{ nullptr };
 
-		//! Buttons associated with the device
-		std::vector<Button> _buttons;
+		//! Values decoded by the generated decoder
+		std::vector<int32_t> _values;
 
-		//! Axes associated with the device
-		std::vector<Axis> _axes;
+		//! Buffer receiving the usages of the pressed buttons,
+		//! if the buttons cannot be decoded using the plan
+		std::vector<USAGE> _usages;
 
-		//! HID button representation
-		std::vector<HIDP_BUTTON_CAPS> _buttonCaps;
+		//! Online calibration of the axes (one per entry in 'axes()').
+		//! Updated by the thread processing the input of the device.
+		std::unique_ptr<AxisCalibrator[]> _calibrators;
 
-		//! HID axis representation
-		std::vector<HIDP_VALUE_CAPS> _axesCaps;
+		//! Indicate whether the axes are calibrated online
+		std::atomic<bool> _autoCalibration{ false };
+
+		//! Indicate whether the axes are normalized on demand
+		std::atomic<bool> _deferredNormalization{ false };
+
+		//! Selection of the reports which need to be decoded
+		ReportCoalescer _coalescer;
 	};
 	
+	template<typename Visitor>
+	void GenericHID::readAxes(const RawReport& report, bool include_absolute, Visitor&& visitor)
+	{
+		if (report.size == 0)
+			return;
+
+		// Only the fields contained in the report are decoded
+		if (_generated)
+		{
+			uint64_t decoded = _generated->decodeValues(report.bytes(), _values);
+			for (; decoded != 0; decoded &= decoded - 1)
+			{
+				// Generated decoders number the values in the order of the reports
+				const uint32_t field = findFirstSet(decoded);
+				const uint32_t idx = _layout->valueOrder[field];
+				if (include_absolute || !_layout->axes[idx].isAbsolute)
+					visitor(size_t{ idx }, static_cast<LONG>(_values[field]));
+			}
+		}
+		else if (_layout->plan.hasValues())
+		{
+			for (const auto& field : _layout->plan.fields(report.data[0]).values)
+			{
+				if (include_absolute || !_layout->axes[field.index].isAbsolute)
+					visitor(size_t{ field.index }, static_cast<LONG>(DecodePlan::readValue(report.bytes(), field)));
+			}
+		}
+		else if (const auto preparsed_data = preparsedData())
+		{
+			const auto& axes = _layout->axes;
+			for (size_t i = 0; i < axes.size(); i++)
+			{
+				const auto& axis = axes[i];
+				if (axis.reportId != report.data[0] || (axis.isAbsolute && !include_absolute))
+					continue;
+
+				ULONG value = 0;
+				if (HidP_GetUsageValue(
+					HidP_Input, axis.usagePage, 0,
+					axis.usage, &value, preparsed_data,
+					(PCHAR)report.data, report.size
+				) == HIDP_STATUS_SUCCESS)
+				{
+					visitor(i, logicalValue(i, value));
+				}
+			}
+		}
+	}
+
 	class AbstractHID
 	{
 	public:
 		AbstractHID(std::unique_ptr<GenericHID> device) : _device{ std::move(device) } {}
+		virtual ~AbstractHID() = default;
 
 		const GenericHID* device() const { return _device.get(); }
+		GenericHID* device() { return _device.get(); }
+
+		//! Process the reports of a single raw input message
+		//! \returns True, if any report was processed
+		bool processInput(HWND window_handle, UINT input_code, PRAWINPUT raw_input);
+
+		//! Process a batch of reports of this device
+		//! \param window_handle Handle of the window receiving the input
+		//! \param reports Reports in the order they were received
+		//! \param stats Counters of the work skipped while processing the batch
+		//! \returns The number of processed reports
+		virtual size_t processReports(HWND window_handle, gsl::span<const RawReport> reports, InputStatistics& stats) = 0;
+
+		//! Attach the device to the input timers of a manager
+		//! \param timers Timer wheel, null to detach the device
+		//! \param lock Mutex serializing the access to the wheel and the settings
+		//! \param settings Configuration of the timers
+		//! \note The device only holds 'lock' while it accesses the wheel or the
+		//!       settings. A device still processing input must be detached
+		//!       while holding 'lock'.
+		void attachTimers(TimerWheel* timers, std::mutex* lock, const InputTimerSettings* settings);
+
+		//! Process an expired timer of this device
+		//! \param event Payload of the expired timer
+		//! \param now Current time (steady clock, microseconds)
+		void processTimer(const TimerEvent& event, uint64_t now);
+
+		//! Check whether a report changes the state of any button
+		//! \note Must only be called by the thread processing the input of the device.
+		bool hasButtonEdge(const RawReport& report);
+
+		//! Enable the collection of the events for a batched handler
+		//! \note Must only be called by the thread processing the input of the device.
+		void setEventCollection(bool enable);
+
+		//! \returns The events collected since the last call to 'clearEvents'
+		gsl::span<const InputEvent> events() const { return { _events.data(), static_cast<std::ptrdiff_t>(_events.size()) }; }
+
+		//! Discard the collected events
+		void clearEvents() { _events.clear(); }
+
+	protected:
+		//! \returns True, if the events are collected for a batched handler
+		bool collectsEvents() const { return _collectEvents; }
+
+		//! Append an event to the collected events
+		void addEvent(uint64_t timestamp, InputEventType type, size_t index, float value)
+		{
+			_events.push_back({ timestamp, type, static_cast<uint16_t>(index), value });
+		}
+
+		//! Append the events of the buttons changed within a batch
+		//! \param states Current states of the buttons
+		//! \param pressed Buttons pressed since the last update
+		//! \param released Buttons released since the last update
+		//! \param timestamp Time the buttons changed
+		void addButtonEvents(const ButtonSet& states, const ButtonSet& pressed, const ButtonSet& released, uint64_t timestamp);
+
+		//! Set the time after which the state of the device is reset, if it
+		//! stopped sending reports. Overrides 'InputTimerSettings::staleTimeout'
+		//! for devices with a known report rate. Zero uses the setting.
+		void setStaleTimeout(uint64_t timeout) { _staleTimeout = timeout; }
+
+		//! Restart the stale timeout
+		//! \param timestamp Time the last report was received
+		void restartStaleTimer(uint64_t timestamp);
 
-		virtual bool processInput(HWND window_handle, UINT input_code, PRAWINPUT raw_input) = 0;
+		//! Reset the state of the device to rest after its stale timeout expired
+		//! \param now Current time (steady clock, microseconds)
+		virtual void resetStaleState(uint64_t now) { (void) now; }
+
+		//! Start and stop the repeat and long-press timers of the changed buttons
+		//! \param states Current states of the buttons
+		//! \param pressed Buttons pressed since the last update
+		//! \param released Buttons released since the last update
+		//! \param timestamp Time the buttons changed
+		void updateButtonTimers(const ButtonSet& states, const ButtonSet& pressed, const ButtonSet& released, uint64_t timestamp);
 
 	private:
 		//! Actual hardware device implementation
 		std::unique_ptr<GenericHID> _device;
+
+		//! Scratch buffer for the reports of a single raw input message
+		//! \note Must only be used by the thread processing the input of the device.
+		std::vector<RawReport> _reports;
+
+		//! Timers of the manager, null if the device is not attached
+		TimerWheel* _timers{ nullptr };
+
+		//! Serialize the access to the timers and their configuration
+		std::mutex* _timerLock{ nullptr };
+
+		//! Configuration of the button events
+		const InputTimerSettings* _timerSettings{ nullptr };
+
+		//! Device specific time after which the state is reset without new reports (microseconds)
+		uint64_t _staleTimeout{ 0 };
+
+		//! Pending stale timeout
+		TimerWheel::Handle _staleTimer;
+
+		//! Pending repeat timer of each button
+		std::vector<TimerWheel::Handle> _repeatTimers;
+
+		//! Pending long-press timer of each button
+		std::vector<TimerWheel::Handle> _longPressTimers;
+
+		//! Latest report of each report ID seen by 'hasButtonEdge', if the
+		//! layout has a decode plan
+		std::vector<std::vector<uint8_t>> _edgeReports;
+
+		//! Button states seen by 'hasButtonEdge', if the layout has no decode plan
+		ButtonSet _edgeButtons;
+
+		//! Button states decoded by 'hasButtonEdge', if the layout has no decode plan
+		ButtonSet _edgeScratch;
+
+		//! Indicate whether the events are collected
+		bool _collectEvents{ false };
+
+		//! Events collected since the last dispatch
+		std::vector<InputEvent> _events;
 	};
 
 	template<typename JoystickType>
@@ -219,7 +640,27 @@ namespace Vcl { namespace HID { namespace Windows
 	public:
 		JoystickHID(std::unique_ptr<GenericHID> device);
 
-		bool processInput(HWND window_handle, UINT input_code, PRAWINPUT raw_input) override;
+		size_t processReports(HWND window_handle, gsl::span<const RawReport> reports, InputStatistics& stats) override;
+
+	protected:
+		auto readNames() const -> std::pair<std::string_view, std::string_view> override;
+
+		//! Reset the axes and release the buttons
+		void resetStaleState(uint64_t now) override;
+
+	private:
+		//! Update the state of an axis from a logical value
+		//! \param idx Index of the axis in the device layout
+		//! \param value Logical value of the axis
+		//! \param timestamp Time the value was received
+		void updateAxis(size_t idx, LONG value, uint64_t timestamp);
+
+	private:
+		//! Button states decoded from the last report
+		ButtonSet _decodedButtons;
+
+		//! Changes of the relative axes accumulated over a batch
+		std::vector<int64_t> _deltas;
 	};
 
 	template<typename GamepadType>
@@ -228,7 +669,27 @@ namespace Vcl { namespace HID { namespace Windows
 	public:
 		GamepadHID(std::unique_ptr<GenericHID> device);
 
-		bool processInput(HWND window_handle, UINT input_code, PRAWINPUT raw_input) override;
+		size_t processReports(HWND window_handle, gsl::span<const RawReport> reports, InputStatistics& stats) override;
+
+	protected:
+		auto readNames() const -> std::pair<std::string_view, std::string_view> override;
+
+		//! Reset the axes and release the buttons
+		void resetStaleState(uint64_t now) override;
+
+	private:
+		//! Update the state of an axis from a logical value
+		//! \param idx Index of the axis in the device layout
+		//! \param value Logical value of the axis
+		//! \param timestamp Time the value was received
+		void updateAxis(size_t idx, LONG value, uint64_t timestamp);
+
+	private:
+		//! Button states decoded from the last report
+		ButtonSet _decodedButtons;
+
+		//! Changes of the relative axes accumulated over a batch
+		std::vector<int64_t> _deltas;
 	};
 	
 	template<typename ControllerType>
@@ -237,15 +698,50 @@ namespace Vcl { namespace HID { namespace Windows
 	public:
 		MultiAxisControllerHID(std::unique_ptr<GenericHID> device);
 
-		bool processInput(HWND window_handle, UINT input_code, PRAWINPUT raw_input) override;
+		size_t processReports(HWND window_handle, gsl::span<const RawReport> reports, InputStatistics& stats) override;
+
+	protected:
+		auto readNames() const -> std::pair<std::string_view, std::string_view> override;
+
+	private:
+		//! Update the state of an axis from a logical value
+		void updateAxis(size_t idx, LONG value);
+
+	private:
+		//! Button states decoded from the last report
+		ButtonSet _decodedButtons;
+
+		//! Changes of the relative axes accumulated over a batch
+		std::vector<int64_t> _deltas;
 	};
 
 	class DeviceManager
 	{
+	private:
+		//! Immutable snapshot of the managed devices
+		struct DeviceTable
+		{
+			//! Device implementations
+			std::vector<AbstractHID*> hids;
+
+			//! Public device interfaces (links to `hids`)
+			std::vector<Device const*> devices;
+		};
+
 	public:
-		DeviceManager();
+		//! \param calibration_path Location of the calibration database. If empty,
+		//!                         the database is only kept in memory.
+		explicit DeviceManager(const std::string& calibration_path = {});
+		DeviceManager(const DeviceManager&) = delete;
+		~DeviceManager();
+
+		DeviceManager& operator=(const DeviceManager&) = delete;
 	
-		gsl::span<Device const* const> devices() const;
+		//! Access the current devices
+		//! \returns A snapshot of the devices, which stays valid while
+		//!          devices are added or removed concurrently.
+		//! \note Accessing the devices never blocks.
+		DeviceList devices() const;
 		
 		//! Register devices with a specific window
 		//! \param device_types Types of devices for which input should
@@ -264,11 +760,337 @@ namespace Vcl { namespace HID { namespace Windows
 		//! Process the input of a specific device
 		bool processInput(HWND window_handle, UINT message, WPARAM wide_param, LPARAM low_param);
 
+		//! Process a batch of reports
+		//! The reports are grouped by device and each group is decoded at once.
+		//! \param reports Reports of any number of devices
+		//! \param window_handle Handle of the window receiving the input
+		//! \returns The number of processed reports
+		//! \note Must only be called by the thread processing the input.
+		size_t processReports(gsl::span<const RawReport> reports, HWND window_handle);
+
+		//! Set the maximum number of reports processed at once
+		void setBatchSize(size_t size) { _batchSize.store(size > 0 ? size : 1, std::memory_order_relaxed); }
+
+		//! \returns The maximum number of reports processed at once
+		size_t batchSize() const { return _batchSize.load(std::memory_order_relaxed); }
+
+		//! Access the counters of the input processing
+		InputStatistics statistics() const;
+
+		//! Set the latency budget of the input processing.
+		//! Reports read from the raw input are then collected until the oldest
+		//! one waited for the budget and processed as a single batch. A report
+		//! changing a button is processed immediately, together with the
+		//! collected reports. The collected reports are also processed by
+		//! 'processTimers', which 'timerTimeout' accounts for. Waiting with
+		//! 'waitForInput' avoids the wake ups for the deferred reports.
+		//! \param budget Maximum added latency (microseconds). Zero processes
+		//!               the input immediately.
+		void setLatencyBudget(uint64_t budget) { _latencyBudget.store(budget, std::memory_order_relaxed); }
+
+		//! \returns The latency budget of the input processing (microseconds)
+		uint64_t latencyBudget() const { return _latencyBudget.load(std::memory_order_relaxed); }
+
+		//! Process the reports which waited for the latency budget, expire
+		//! the pending input timers and invoke the timer handler. Devices
+		//! resetting their stale state pass the events of the reset to the
+		//! batched handler.
+		//! \returns The number of expired timers
+		//! \note Must only be called by the thread processing the input,
+		//!       whenever the time returned by 'timerTimeout' passed.
+		size_t processTimers();
+
+		//! \returns The time until the next input timer expires or the collected
+		//!          reports need to be processed (milliseconds), 'INFINITE' if
+		//!          nothing is pending. Suitable as timeout of
+		//!          'MsgWaitForMultipleObjects' in the input loop.
+		//! \note Must only be called by the thread processing the input.
+		DWORD timerTimeout() const;
+
+		//! Wait for the raw input, other messages or the input timers, then
+		//! read all the queued raw input with 'poll' and call 'processTimers'.
+		//! While reports wait for the latency budget, new raw input does not
+		//! wake up the thread. It stays queued and is read at once when the
+		//! budget expired, so a busy device causes a single wake up per budget.
+		//! \param window_handle Handle of the window receiving the input
+		//! \param wake_mask Queue status of the other messages ending the wait
+		//!                  (see 'MsgWaitForMultipleObjects')
+		//! \returns True, if the wait ended because of a queued message
+		//! \note Must only be called by the thread processing the input.
+		bool waitForInput(HWND window_handle, DWORD wake_mask = QS_ALLINPUT);
+
+		//! Configure the repeat and long-press events of the buttons of all devices
+		void setTimerSettings(const InputTimerSettings& settings);
+
+		//! \returns The configuration of the button events
+		InputTimerSettings timerSettings() const;
+
+		//! Set the handler receiving the events synthesized by the input timers
+		//! \param handler Handler invoked from 'processTimers', null to disable the events
+		void setTimerHandler(InputTimerHandler* handler) { _timerHandler.store(handler, std::memory_order_release); }
+
+		//! Set the handler receiving the input events in batches.
+		//! The devices then collect compact events of their axes, buttons and
+		//! motion, which are passed to the handler once per device after each
+		//! processed batch of reports and after each stale-state reset.
+		//! \param handler Handler invoked from the thread processing the input,
+		//!                null to stop collecting events
+		void setBatchedHandler(BatchedInputHandler* handler) { _batchedHandler.store(handler, std::memory_order_release); }
+
+		//! Process a device arrival or removal (WM_INPUT_DEVICE_CHANGE)
+		//! \returns True, if the set of devices changed
+		bool processDeviceChange(HWND window_handle, UINT message, WPARAM wide_param, LPARAM low_param);
+
+		//! Set an additional source of device changes
+		//! \param source Source of hot-plug events, replaces the previous source
+		void setHotplugSource(std::unique_ptr<HotplugSource> source);
+
+		//! Apply the pending changes of the hot-plug source
+		//! \returns True, if the set of devices changed
+		bool pollHotplug();
+
+		//! Generation of the device set. Incremented whenever a device
+		//! is added or removed.
+		uint64_t generation() const { return _generation.load(std::memory_order_acquire); }
+
+		//! Access the calibration data of the known devices
+		//! \returns A view keeping the current version of the data alive
+		CalibrationView calibration() const;
+
+		//! Enable the online calibration of the axes of all devices
+		void setAutoCalibration(bool enable);
+
+		//! Enable the coalescing of the reports of all devices.
+		//! Reports repeating their predecessor are skipped; of several pending
+		//! reports only the newest absolute values are decoded, while button
+		//! edges and relative values of all reports are accumulated.
+		void setCoalescing(bool enable);
+
+		//! \returns True, if the reports are coalesced
+		bool coalescing() const { return _coalescing.load(std::memory_order_relaxed); }
+
+		//! Defer the normalization of the axes of all devices until they
+		//! are read or latched ('latchAxes'). Decoding then only extracts
+		//! the logical values.
+		void setDeferredNormalization(bool enable);
+
+		//! \returns True, if the axes are normalized on demand
+		bool deferredNormalization() const { return _deferredNormalization.load(std::memory_order_relaxed); }
+
+		//! Poll the motion of the SpaceNavigators added afterwards with an
+		//! adaptive rate instead of processing it when it is received.
+		//! \note The handlers of polled devices are called from the thread of
+		//!       their poll scheduler instead of the thread processing the input.
+		void setSpaceNavigatorPolling(bool enable) { _spaceNavigatorPolling.store(enable, std::memory_order_relaxed); }
+
+		//! \returns True, if new SpaceNavigators are polled
+		bool spaceNavigatorPolling() const { return _spaceNavigatorPolling.load(std::memory_order_relaxed); }
+
+		//! Store the calibrations learned by all devices
+		//! \returns True, if the database was successfully updated
+		//! \note Learned calibrations are stored automatically when a device
+		//!       is removed and when the manager is destroyed.
+		bool saveCalibration();
+
+		//! Update the stored calibration data
+		//! \param records Records replacing or extending the current data
+		//! \returns True, if the database was successfully updated and written
+		//! \note Devices pick up the changed data when they are added the next time.
+		//! \note The file cannot be replaced while a view of the old data is alive.
+		//!       The updated data is used for the session regardless.
+		bool storeCalibration(gsl::span<const CalibrationRecord> records);
+
+	private:
+		//! Create the device implementation for a raw input device
+		//! \returns The device, or null if the device is not supported
+		std::unique_ptr<AbstractHID> createDevice(HANDLE raw_handle);
+
+		//! Import the calibration data of the devices unknown to the database
+		//! \returns True, if the database was updated
+		//! \note Requires the write lock to be held
+		bool importCalibration(gsl::span<const HANDLE> raw_handles);
+
+		//! Publish the content of the builder as new calibration database
+		//! and retire the old one
+		//! \returns True, if the database was published and written
+		//! \note Requires the write lock to be held
+		bool commitCalibration(const CalibrationDatabaseBuilder& builder);
+
+		//! Probe and add a single device without publishing it
+		//! \returns True, if the device was added
+		bool insertDevice(HANDLE raw_handle);
+
+		//! Probe, add and publish a single device
+		//! \returns True, if the device was added
+		bool addDevice(HANDLE raw_handle);
+
+		//! Remove a single device
+		//! \returns True, if the device was removed
+		bool removeDevice(HANDLE raw_handle);
+
+		//! Publish a new snapshot of the devices and retire the old one
+		void publishDevices();
+
+		//! Process a batch of at most 'batchSize()' reports
+		size_t processBatch(gsl::span<const RawReport> reports, HWND window_handle);
+
+		//! Pass the events collected by '_eventSources' to the batched handler
+		void dispatchEvents(BatchedInputHandler* handler);
+
+		//! Process the reports read from the raw input or defer them
+		//! according to the latency budget
+		//! \returns The number of processed or deferred reports
+		size_t ingestReports(gsl::span<const RawReport> reports, HWND window_handle);
+
+		//! Process the deferred reports
+		//! \returns The number of processed reports
+		size_t flushPendingReports(uint64_t now);
+
+		//! Find the device implementation associated with a raw input handle
+		static AbstractHID* findDevice(const DeviceTable& table, HANDLE raw_handle);
+
 	private:
+		//! Strings (names) associated with the devices
+		StringTable _strings;
+
+		//! Location of the calibration database
+		std::string _calibrationPath;
+
+		//! Indicate whether new devices are calibrated online
+		std::atomic<bool> _autoCalibration{ false };
+
+		//! Indicate whether the reports of new devices are coalesced
+		std::atomic<bool> _coalescing{ false };
+
+		//! Indicate whether the axes of new devices are normalized on demand
+		std::atomic<bool> _deferredNormalization{ false };
+
+		//! Indicate whether new SpaceNavigators are polled
+		std::atomic<bool> _spaceNavigatorPolling{ false };
+
+		//! Calibration and naming data of the known devices.
+		//! Replaced versions are retired through '_epochs'.
+		std::atomic<const CalibrationDatabase*> _calibration{ nullptr };
+
+		//! Layouts shared between identical devices
+		DeviceLayoutCache _layouts;
+
+		//! Serialize the processing of the hot-plug source
+		std::mutex _hotplugLock;
+
+		//! Optional source of device changes
+		std::unique_ptr<HotplugSource> _hotplugSource;
+
+		//! Buffer for the pending device changes
+		std::vector<HotplugEvent> _hotplugEvents;
+
+		//! Generation of the device set
+		std::atomic<uint64_t> _generation{ 0 };
+
+		//! Reclamation of the retired device tables, devices and calibration data
+		EpochDomain _epochs;
+
+		//! Serialize the access to the input timers
+		mutable std::mutex _timerLock;
+
+		//! Time-to-live, repeat and long-press timers of all devices
+		TimerWheel _timers;
+
+		//! Configuration of the button events
+		InputTimerSettings _timerSettings;
+
+		//! Receiver of the events synthesized by the timers
+		std::atomic<InputTimerHandler*> _timerHandler{ nullptr };
+
+		//! Expired timers waiting to be passed to the handler
+		std::vector<std::pair<AbstractHID*, TimerEvent>> _expiredTimers;
+
+		//! Receiver of the batched input events
+		std::atomic<BatchedInputHandler*> _batchedHandler{ nullptr };
+
+		//! Devices with events waiting to be passed to the batched handler
+		std::vector<AbstractHID*> _eventSources;
+
+		//! Serialize changes of the device set
+		std::mutex _writeLock;
+
+		//! Current snapshot of the devices
+		std::atomic<const DeviceTable*> _table{ nullptr };
+
 		//! List of Windows HID
 		std::vector<std::unique_ptr<AbstractHID>> _devices;
 
-		//! List of device pointers (links to `_devices`)
-		std::vector<Device*> _deviceLinks;
+		//! Maximum number of reports processed at once
+		std::atomic<size_t> _batchSize{ 64 };
+
+		//! Buffer receiving the raw input data
+		std::vector<uint64_t> _inputBuffer;
+
+		//! Raw input messages read from the buffer
+		std::vector<PRAWINPUT> _rawInputs;
+
+		//! Reports extracted from the raw input messages
+		std::vector<RawReport> _reports;
+
+		//! Reports of the current batch, grouped by device
+		std::vector<RawReport> _batch;
+
+		//! Number of processed reports
+		std::atomic<uint64_t> _nrReports{ 0 };
+
+		//! Number of processed batches
+		std::atomic<uint64_t> _nrBatches{ 0 };
+
+		//! Number of device groups of all the batches
+		std::atomic<uint64_t> _nrDeviceGroups{ 0 };
+
+		//! Number of reports of unknown devices
+		std::atomic<uint64_t> _nrUnknownReports{ 0 };
+
+		//! Number of reports skipped as duplicates
+		std::atomic<uint64_t> _nrDuplicateReports{ 0 };
+
+		//! Number of reports superseded within their batch
+		std::atomic<uint64_t> _nrCoalescedReports{ 0 };
+
+		//! Number of times the input thread woke up in 'waitForInput'
+		std::atomic<uint64_t> _nrWakeups{ 0 };
+
+		//! Number of times reports were processed
+		std::atomic<uint64_t> _nrProcessingPasses{ 0 };
+
+		//! Number of times deferred reports were processed because of a button change
+		std::atomic<uint64_t> _nrImmediatePasses{ 0 };
+
+		//! Number of reports deferred by the latency budget
+		std::atomic<uint64_t> _nrDeferredReports{ 0 };
+
+		//! Latency added to the deferred reports
+		std::atomic<uint64_t> _totalAddedLatency{ 0 };
+
+		//! Largest latency added to a single report
+		std::atomic<uint64_t> _maxAddedLatency{ 0 };
+
+		//! Time the manager was created
+		uint64_t _created{ 0 };
+
+		//! Maximum latency added to the reports read from the raw input
+		std::atomic<uint64_t> _latencyBudget{ 0 };
+
+		//! Reports deferred by the latency budget.
+		//! Their data pointers are assigned when they are processed.
+		std::vector<RawReport> _pendingReports;
+
+		//! Offsets of the data of the deferred reports
+		std::vector<size_t> _pendingOffsets;
+
+		//! Copies of the data of the deferred reports
+		std::vector<uint8_t> _pendingData;
+
+		//! Time the oldest deferred report was received
+		uint64_t _pendingSince{ 0 };
+
+		//! Window receiving the deferred reports
+		HWND _pendingWindow{ nullptr };
 	};
 }}}
@@ -24,6 +24,11 @@
  */
 #include "spacenavigator.h"
 
+// C++ Standard library
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
 // Debug tracing
 #define VCL_DEVICE_SPACENAVIGATOR_TRACE_WM_INPUT_PERIOD 0
 #define VCL_DEVICE_SPACENAVIGATOR_TRACE_3DINPUT_PERIOD 0
@@ -36,6 +41,20 @@
 // Configuration
 #define VCL_DEVICE_SPACENAVIGATOR_CONSTANT_INPUT_PERIOD 0
 
+namespace
+{
+	//! State slot of each axis of the device.
+	//! The rotations about x and y are stored swapped.
+	const std::array<uint32_t, 6> AxisSlots = { 0, 1, 2, 4, 3, 5 };
+
+	//! \returns The current time (steady clock, microseconds)
+	uint64_t currentTime()
+	{
+		const auto time = std::chrono::steady_clock::now().time_since_epoch();
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(time).count());
+	}
+}
+
 namespace Vcl { namespace HID { namespace Windows
 {
 	SpaceNavigatorHID::SpaceNavigatorHID
@@ -47,27 +66,51 @@ namespace Vcl { namespace HID { namespace Windows
 	, SpaceNavigator()
 	, _poll3DMouse(poll_3d_mouse)
 	{
-		const auto names = device()->readDeviceName();
-		setVendorName(names.first);
-		setDeviceName(names.second);
-		
 		setNrAxes(static_cast<uint32_t>(device()->axes().size()));
 		setNrButtons(static_cast<uint32_t>(device()->buttons().size()));
+		_decodedButtons.resize(nrButtons());
+
+		// Repeated motion reports keep the motion alive while the cap is held
+		device()->setSuppressDuplicates(false);
+
+		// The device sends reports continuously while the cap is deflected
+		setStaleTimeout(MaxSampleInterval);
+
+		// Devices of unknown models report the virtual keys directly
+		static const SpaceMouseKeymap DefaultKeymap = makeSpaceMouseKeymap(32);
+		const auto model = findSpaceMouseModel(device()->vendorId(), device()->productId());
+		_keymap = model ? &model->keymap : &DefaultKeymap;
+
+		// Physical values are computed from the raw values with a single scale
+		const auto& axes = device()->axes();
+		for (size_t i = 0; i < axes.size() && i < AxisSlots.size(); i++)
+			setAxisPhysicalScale(AxisSlots[i], axes[i].physical);
 
 		// Initialize axis data
 		_deviceData.axes.fill(0.0f);
+		_deviceData.isDirty = false;
 				
-		setAxisState(0, _deviceData.axes[0]);
-		setAxisState(1, _deviceData.axes[1]);
-		setAxisState(2, _deviceData.axes[2]);
+		setAxisState(0, 0, _deviceData.axes[0]);
+		setAxisState(1, 0, _deviceData.axes[1]);
+		setAxisState(2, 0, _deviceData.axes[2]);
 				
-		setAxisState(4, _deviceData.axes[3]);
-		setAxisState(3, _deviceData.axes[4]);
-		setAxisState(5, _deviceData.axes[5]);
+		setAxisState(4, 0, _deviceData.axes[3]);
+		setAxisState(3, 0, _deviceData.axes[4]);
+		setAxisState(5, 0, _deviceData.axes[5]);
+
+		if (_poll3DMouse)
+			_scheduler = std::make_unique<PollScheduler>([this]() { on3DMouseInput(); });
 	}
 	
+	auto SpaceNavigatorHID::readNames() const -> std::pair<std::string_view, std::string_view>
+	{
+		return device()->readDeviceName();
+	}
+
 	void SpaceNavigatorHID::onActivateApp(BOOL active, DWORD)
 	{
+		std::lock_guard<std::mutex> guard{ _pollLock };
+
 		if (!_poll3DMouse)
 		{
 			if (!active)
@@ -79,34 +122,46 @@ namespace Vcl { namespace HID { namespace Windows
 		// Initialize axis data
 		_deviceData.axes.fill(0.0f);
 				
-		setAxisState(0, _deviceData.axes[0]);
-		setAxisState(1, _deviceData.axes[1]);
-		setAxisState(2, _deviceData.axes[2]);
+		setAxisState(0, 0, _deviceData.axes[0]);
+		setAxisState(1, 0, _deviceData.axes[1]);
+		setAxisState(2, 0, _deviceData.axes[2]);
 				
-		setAxisState(4, _deviceData.axes[3]);
-		setAxisState(3, _deviceData.axes[4]);
-		setAxisState(5, _deviceData.axes[5]);
+		setAxisState(4, 0, _deviceData.axes[3]);
+		setAxisState(3, 0, _deviceData.axes[4]);
+		setAxisState(5, 0, _deviceData.axes[5]);
 	}
 
-	bool SpaceNavigatorHID::processInput(HWND window_handle, UINT input_code, PRAWINPUT raw_input)
+	size_t SpaceNavigatorHID::processReports(HWND, gsl::span<const RawReport> reports, InputStatistics& stats)
 	{
-		// We are not interested in keyboard or mouse data received via raw input
-		if (raw_input->header.dwType != RIM_TYPEHID)
-			return false;
+		std::lock_guard<std::mutex> guard{ _pollLock };
 
 		// Flag if we have new 6dof data and need to invoke the on3DMouseInput handler
 		bool have_new_input = false;
 
-		// Process the input data
-		have_new_input = translateRawInputData(input_code, raw_input);
+		// Process the input data. The handlers are only called once per batch.
+		// Motion reports are absolute, thus superseded ones can be skipped,
+		// while all the button reports are needed to track the edges.
+		// Accumulated motion integrates every sample and bypasses the coalescer.
+		const bool integrate = motionAccumulation();
+		const auto actions = integrate ? gsl::span<const ReportAction>{} : device()->selectReports(reports, stats);
+		for (size_t r = 0; r < static_cast<size_t>(reports.size()); r++)
+		{
+			const auto& report = reports[r];
+			if (!integrate && actions[r] == ReportAction::Skip)
+				continue;
+			if (!integrate && actions[r] == ReportAction::Accumulate && report.size > 0 && report.data[0] != 0x03)
+				continue;
+
+			have_new_input |= translateReport(report);
+		}
 
 		// If we have mouse input data for the application then tell the application about it
 		if (have_new_input)
 		{
-			// If we are polling and the timer is not running then start it
+			// If we are polling and the scheduler is idle then wake it up
 			if (_poll3DMouse)
 			{
-				startTimer(window_handle);
+				_scheduler->wake();
 			}
 			else
 			{
@@ -115,12 +170,13 @@ namespace Vcl { namespace HID { namespace Windows
 			}
 		}
 
-		return true;
+		return static_cast<size_t>(reports.size());
 	}
 	
-	bool SpaceNavigatorHID::translateRawInputData(UINT input_code, PRAWINPUT raw_input)
+	bool SpaceNavigatorHID::translateReport(const RawReport& report)
 	{
-		bool is_foreground = (input_code == RIM_INPUT) || !_only_foreground;
+		bool is_foreground = !report.isBackground || !_only_foreground;
+		_isForeground = is_foreground;
 
 #if VCL_DEVICE_SPACENAVIGATOR_TRACE_RI_TYPE
 		wprintf(L"Rawinput.header.dwType=0x%x\n", pRawInput->header.dwType);
@@ -169,142 +225,158 @@ namespace Vcl { namespace HID { namespace Windows
 		}
 #endif // VCL_DEVICE_SPACENAVIGATOR_TRACE_RIDI_DEVICEINFO
 
-		if (raw_input->data.hid.bRawData[0] == 0x01) // Translation vector
+		const uint32_t contents = decodeReport(report);
+		if (contents & SpaceNavigatorSample::Keystate)
+			translateKeystate(_sample.keystate, is_foreground, report.timestamp);
+
+		return translateMotion(_sample, contents, is_foreground, report.timestamp);
+	}
+
+	uint32_t SpaceNavigatorHID::decodeReport(const RawReport& report)
+	{
+		if (!device()->generatedDecoder())
+			return decodeSpaceNavigatorReport(report.bytes(), _sample);
+
+		// Axes are numbered in the order of the device caps
+		uint32_t contents = 0;
+		device()->readAxes(report, true, [this, &contents](size_t idx, LONG value)
 		{
-			_deviceData.timeToLive = InputData::MaxTimeToLive;
-			if (is_foreground)
-			{
-				short* pnRawData = reinterpret_cast<short*>(&raw_input->data.hid.bRawData[1]);
-				// Cache the pan zoom data
-				_deviceData.axes[0] = normalizeAxis(pnRawData[0], device()->axes()[0]);
-				_deviceData.axes[1] = normalizeAxis(pnRawData[1], device()->axes()[1]);
-				_deviceData.axes[2] = normalizeAxis(pnRawData[2], device()->axes()[2]);
-					
-				setAxisState(0, _deviceData.axes[0]);
-				setAxisState(1, _deviceData.axes[1]);
-				setAxisState(2, _deviceData.axes[2]);
-				
-#if VCL_DEVICE_SPACENAVIGATOR_TRACE_RI_RAWDATA
-				wprintf(L"Pan/Zoom RI Data =\t%d,\t%d,\t%d\n",
-						pnRawData[0],
-						pnRawData[1],
-						pnRawData[2]);
-#endif // VCL_DEVICE_SPACENAVIGATOR_TRACE_RI_RAWDATA
-				if (raw_input->data.hid.dwSizeHid >= 13) // Highspeed package
-				{
-					// Cache the rotation data
-					_deviceData.axes[3] = normalizeAxis(pnRawData[3], device()->axes()[3]);
-					_deviceData.axes[4] = normalizeAxis(pnRawData[4], device()->axes()[4]);
-					_deviceData.axes[5] = normalizeAxis(pnRawData[5], device()->axes()[5]);
-					_deviceData.isDirty = true;
-#if VCL_DEVICE_SPACENAVIGATOR_TRACE_RI_RAWDATA
-					wprintf(L"Rotation RI Data =\t%d,\t%d,\t%d\n",
-						pnRawData[3],
-						pnRawData[4],
-						pnRawData[5]);
-#endif // VCL_DEVICE_SPACENAVIGATOR_TRACE_RI_RAWDATA
-				
-					setAxisState(4, _deviceData.axes[3]);
-					setAxisState(3, _deviceData.axes[4]);
-					setAxisState(5, _deviceData.axes[5]);
-					return true;
-				}
-			}
-			else
+			if (idx >= _sample.axes.size())
+				return;
+
+			_sample.axes[idx] = static_cast<int16_t>(value);
+			contents |= idx < 3 ? SpaceNavigatorSample::Translation : SpaceNavigatorSample::Rotation;
+		});
+
+		if (device()->readButtons(report.bytes(), _decodedButtons))
+		{
+			_sample.keystate = _decodedButtons.words().empty() ? 0 : static_cast<uint32_t>(_decodedButtons.words()[0]);
+			contents |= SpaceNavigatorSample::Keystate;
+		}
+
+		return contents;
+	}
+
+	bool SpaceNavigatorHID::translateMotion(const SpaceNavigatorSample& sample, uint32_t contents, bool is_foreground, uint64_t timestamp)
+	{
+		const uint32_t motion = contents & (SpaceNavigatorSample::Translation | SpaceNavigatorSample::Rotation);
+		if (motion == 0)
+			return false;
+
+		if (!is_foreground)
+		{
+			// Zero out the data if the app is not in forground. The rotation
+			// is zeroed out together with the translation.
+			if (motion & SpaceNavigatorSample::Translation)
 			{
-				// Zero out the data if the app is not in forground
+				restartStaleTimer(timestamp);
 				_deviceData.axes.fill(0.f);
-				
-				setAxisState(0, _deviceData.axes[0]);
-				setAxisState(1, _deviceData.axes[1]);
-				setAxisState(2, _deviceData.axes[2]);
-				
-				setAxisState(4, _deviceData.axes[3]);
-				setAxisState(3, _deviceData.axes[4]);
-				setAxisState(5, _deviceData.axes[5]);
+				for (size_t i = 0; i < AxisSlots.size(); i++)
+					setAxisState(AxisSlots[i], 0, 0.0f);
+
+				if (motionAccumulation())
+					accumulateMotion(_deviceData.axes, timestamp);
+				if (collectsEvents())
+					addMotionEvents(_deviceData.axes, timestamp);
 			}
+			return false;
 		}
-		else if (raw_input->data.hid.bRawData[0] == 0x02)  // Rotation vector
+
+		restartStaleTimer(timestamp);
+
+		// Cache the pan zoom data and the rotation data
+		const size_t first = (motion & SpaceNavigatorSample::Translation) ? 0 : 3;
+		const size_t last  = (motion & SpaceNavigatorSample::Rotation) ? 6 : 3;
+		for (size_t i = first; i < last; i++)
 		{
-			// If we are not in foreground do nothing 
-			// The rotation vector was zeroed out with the translation vector in the previous message
-			if (is_foreground)
-			{
-				_deviceData.timeToLive = InputData::MaxTimeToLive;
-
-				short* pnRawData = reinterpret_cast<short*>(&raw_input->data.hid.bRawData[1]);
-				// Cache the rotation data
-				_deviceData.axes[3] = normalizeAxis(pnRawData[0], device()->axes()[3]);
-				_deviceData.axes[4] = normalizeAxis(pnRawData[1], device()->axes()[4]);
-				_deviceData.axes[5] = normalizeAxis(pnRawData[2], device()->axes()[5]);
-				_deviceData.isDirty = true;
-				
-				setAxisState(4, _deviceData.axes[3]);
-				setAxisState(3, _deviceData.axes[4]);
-				setAxisState(5, _deviceData.axes[5]);
+			_deviceData.axes[i] = device()->normalizeAxis(i, sample.axes[i]);
+			setAxisState(AxisSlots[i], sample.axes[i], _deviceData.axes[i]);
+		}
 
 #if VCL_DEVICE_SPACENAVIGATOR_TRACE_RI_RAWDATA
-				wprintf(L"Rotation RI Data =\t%d,\t%d,\t%d\n",
-						pnRawData[0],
-						pnRawData[1],
-						pnRawData[2]);
+		if (motion & SpaceNavigatorSample::Translation)
+			wprintf(L"Pan/Zoom RI Data =\t%d,\t%d,\t%d\n", sample.axes[0], sample.axes[1], sample.axes[2]);
+		if (motion & SpaceNavigatorSample::Rotation)
+			wprintf(L"Rotation RI Data =\t%d,\t%d,\t%d\n", sample.axes[3], sample.axes[4], sample.axes[5]);
 #endif // VCL_DEVICE_SPACENAVIGATOR_TRACE_RI_RAWDATA
-				return true;
+
+		// A sample is complete once the rotation is received
+		if (motion & SpaceNavigatorSample::Rotation)
+		{
+			if (collectsEvents() || motionAccumulation())
+			{
+				const auto velocity = scaleMotion(_deviceData.axes);
+				if (collectsEvents())
+					addMotionEvents(velocity, timestamp);
+
+				if (motionAccumulation())
+				{
+					accumulateMotion(velocity, timestamp);
+					return false;
+				}
 			}
+
+			_deviceData.isDirty = true;
+			return true;
 		}
-		/////////////////////////////////////////////////////////////////////////////////////////////
-		// this is a package that contains 3d mouse keystate information
-		// bit0=key1, bit=key2 etc.
-		else if (raw_input->data.hid.bRawData[0] == 0x03)  // Keystate change
-		{
-			unsigned long dwKeystate = *reinterpret_cast<unsigned long*>(&raw_input->data.hid.bRawData[1]); 
+		return false;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////
+	// this is a package that contains 3d mouse keystate information
+	// bit0=key1, bit=key2 etc.
+	void SpaceNavigatorHID::translateKeystate(uint32_t keystate, bool is_foreground, uint64_t timestamp)
+	{
 #if VCL_DEVICE_SPACENAVIGATOR_TRACE_RI_RAWDATA
-			wprintf(L"ButtonData =0x%x\n", dwKeystate);
+		wprintf(L"ButtonData =0x%x\n", keystate);
 #endif // VCL_DEVICE_SPACENAVIGATOR_TRACE_RI_RAWDATA
 
-			// Store the new keystate
-			setButtonStates(dwKeystate);
+		// Store the new keystate
+		if (!_decodedButtons.words().empty())
+		{
+			_decodedButtons.setWord(0, keystate);
+			setButtonStates(_decodedButtons);
+			updateButtonTimers(buttonStates(), pressedButtons(), releasedButtons(), timestamp);
+		}
 
-			// Log the keystate changes
-			unsigned long dwOldKeystate = _keystate;
-			if (dwKeystate != 0)
-				_keystate = dwKeystate;
-			else
-				_keystate = 0;
+		// Log the keystate changes
+		const uint32_t previous = _keystate;
+		_keystate = keystate;
 
-			//  Only call the keystate change handlers if the app is in foreground
-			if (is_foreground)
+		//  Only call the keystate change handlers if the app is in foreground
+		if (is_foreground)
+		{
+			_keymap->translate(previous, keystate, [this, timestamp](unsigned int virtual_key, bool is_pressed)
 			{
-				unsigned long dwChange = dwKeystate ^ dwOldKeystate;
+				if (collectsEvents())
+					addEvent(timestamp, InputEventType::Key, virtual_key, is_pressed ? 1.0f : 0.0f);
 
-				for (unsigned short key = 1; key < 33; key++)
+				if (is_pressed)
 				{
-					if (dwChange & 0x01)
-					{
-						unsigned int virtual_key_code = HidToVirtualKey(device()->productId(), key);
-						if (virtual_key_code)
-						{
-							if (dwKeystate & 0x01)
-								onSpaceMouseKeyDown(virtual_key_code);
-							else
-								onSpaceMouseKeyUp(virtual_key_code);
-						}
-					}
-					dwChange >>=1;
-					dwKeystate >>=1;
+					_filter.handleKey(virtual_key);
+					onSpaceMouseKeyDown(virtual_key);
 				}
-			}
-
-			// Don't signal further input processing as buttons were handled above
+				else
+					onSpaceMouseKeyUp(virtual_key);
+			});
 		}
-		return false;
 	}
 	
+	void SpaceNavigatorHID::addMotionEvents(const std::array<float, 6>& motion, uint64_t timestamp)
+	{
+		for (size_t i = 0; i < motion.size(); i++)
+			addEvent(timestamp, InputEventType::Motion, i, motion[i]);
+	}
+
 	void SpaceNavigatorHID::on3DMouseInput()
 	{
+		// The scheduler polls from its own thread
+		std::unique_lock<std::mutex> guard{ _pollLock, std::defer_lock };
+		if (_poll3DMouse)
+			guard.lock();
+
 		// Don't do any data processing in background
-		bool is_foreground = (::GetActiveWindow() != NULL) || !_only_foreground;
-		if (!is_foreground)
+		if (!_isForeground)
 		{
 			// Set all cached data to zero so that a zero event is seen 
 			// and the cached data deleted
@@ -312,60 +384,38 @@ namespace Vcl { namespace HID { namespace Windows
 			_deviceData.isDirty = true;
 		}
 
-		DWORD dwNow = ::GetTickCount();           // Current time;
-		DWORD dwElapsedTime;                      // Elapsed time since we were last here
+		const uint64_t now = currentTime();         // Current time
+		float elapsed_time;                         // Elapsed time since we were last here (ms)
 
 #if VCL_DEVICE_SPACENAVIGATOR_CONSTANT_INPUT_PERIOD
-		if (t_bPoll3dmouse)
-			dwElapsedTime = m3DMousePollingPeriod;
+		if (_poll3DMouse)
+			elapsed_time = 1000.0f / std::max(_scheduler->rate(), 1.0f);
 		else
-			dwElapsedTime = 16;
+			elapsed_time = 16.0f;
 #else
 		if (0 == _last3DMouseInputTime)
 		{
-			dwElapsedTime = 10;                    // System timer resolution
+			// Assume a single period of the input
+			elapsed_time = _poll3DMouse ? 1000.0f / std::max(_scheduler->rate(), 1.0f) : 10.0f;
 		}
 		else 
 		{
-			dwElapsedTime = dwNow - _last3DMouseInputTime;
-			if (_last3DMouseInputTime > dwNow)
-				dwElapsedTime = ~dwElapsedTime+1;
+			elapsed_time = static_cast<float>(now - _last3DMouseInputTime) / 1000.0f;
 
-			if (dwElapsedTime < 1)
-				dwElapsedTime = 1;
 			// Check for wild numbers because the device was removed while sending data
-			else if (dwElapsedTime > 500)
-				dwElapsedTime = 10;
+			if (elapsed_time > 500.0f)
+				elapsed_time = 10.0f;
 		}
 #endif // VCL_DEVICE_SPACENAVIGATOR_CONSTANT_INPUT_PERIOD
 
 #if VCL_DEVICE_SPACENAVIGATOR_TRACE_3DINPUT_PERIOD
-		wprintf(L"On3DmouseInput() period is %dms\n", dwElapsedTime);
+		wprintf(L"On3DmouseInput() period is %fms\n", elapsed_time);
 #endif // VCL_DEVICE_SPACENAVIGATOR_TRACE_3DINPUT_PERIOD
 
-		float fMouseData2Rotation = AngularVelocity;
-
-		// v = w * r,  we don't know r yet so lets assume r=1.)
-		float fMouseData2PanZoom = AngularVelocity;
-
-		// Take a look at the users preferred speed setting and adjust the sensitivity accordingly
-		Speed speed_setting = _speed;
-		// See "Programming for the 3D Mouse", Section 5.1.3
-		float fSpeed = (speed_setting == Speed::Low ? 0.25f : speed_setting == Speed::High ?  4.0f : 1.0f);
-
-		// Multiplying by the following will convert the 3d mouse data to real world units
-		fMouseData2PanZoom *= fSpeed;
-		fMouseData2Rotation *= fSpeed;
-
 		bool process_device_data = true;
 
-		// If we have not received data for a while send a zero event 
-		if ((--(_deviceData.timeToLive)) == 0)
-		{
-			_deviceData.axes.fill(0.0f);
-		}
 		// If we are not polling then only handle the data that was actually received
-		else if (!_poll3DMouse && !_deviceData.isDirty)
+		if (!_poll3DMouse && !_deviceData.isDirty)
 		{
 			process_device_data = false;
 		}
@@ -375,42 +425,16 @@ namespace Vcl { namespace HID { namespace Windows
 			_deviceData.isDirty = false;
 
 			////////////////////////////////////////////////////////////////////////////////
-			// get a copy of the motion vectors and apply the user filters
-			std::array<float, 6> motionData = _deviceData.axes;
-
-			////////////////////////////////////////////////////////////////////////////////
-			// apply the user filters
-
-			// Pan Zoom filter
-			// See "Programming for the 3D Mouse", Section 5.1.2
-			if (!_isPanZoom)
-			{
-				// Pan zoom is switched off so set the translation vector values to zero
-				motionData[0] =  motionData[1] =  motionData[2] = 0.0f;
-			}
-
-			// Rotate filter
-			// See "Programming for the 3D Mouse", Section 5.1.1
-			if (!_isRotate)
-			{
-				// Rotate is switched off so set the rotation vector values to zero
-				motionData[3] =  motionData[4] =  motionData[5] = 0.0f;
-			}
-
-			// Convert the translation vector into physical data
-			for (size_t axis = 0; axis < 3; axis++)
-				motionData[axis] *= fMouseData2PanZoom;
-
-			// Convert the directed Rotate vector into physical data
-			// See "Programming for the 3D Mouse", Section 7.2.2
-			for (size_t axis = 3; axis < 6; axis++)
-				motionData[axis] *= fMouseData2Rotation;
+			// get a copy of the motion vectors, apply the user filters and
+			// convert them into physical data
+			// See "Programming for the 3D Mouse", Sections 5.1 and 7.2.2
+			std::array<float, 6> motionData = scaleMotion(_deviceData.axes);
 
 			////////////////////////////////////////////////////////////////////////////
 			// Now that the data has had the filters and sensitivty settings applied
 			// calculate the displacements since the last view update
 			for (size_t axis = 0; axis < 6; axis++)
-				motionData[axis] *= static_cast<float>(dwElapsedTime);
+				motionData[axis] *= elapsed_time;
 
 			// Pass the 3dmouse input to the view controller
 			onSpaceMouseMove(motionData);
@@ -418,63 +442,68 @@ namespace Vcl { namespace HID { namespace Windows
 
 		if (!_deviceData.isZero())
 		{
-			_last3DMouseInputTime = dwNow;
+			_last3DMouseInputTime = now;
 		}
 		else
 		{  
 			_last3DMouseInputTime = 0;
-			killPollingTimer();
 		}
-	}
 
-	void SpaceNavigatorHID::onSpaceMouseMove(std::array<float, 6> motion_data)
-	{
-		for (auto handler : _handlers)
-			handler->onSpaceMouseMove(this, motion_data);
+		// Adapt the polling rate to the deflection of the cap.
+		// Polling stops once the cap is released.
+		if (_poll3DMouse)
+		{
+			float activity = 0.0f;
+			for (float axis : _deviceData.axes)
+				activity = std::max(activity, std::abs(axis));
+			_scheduler->reportActivity(activity);
+		}
 	}
 
-	void SpaceNavigatorHID::onSpaceMouseKeyDown(UINT virtual_key)
+	void SpaceNavigatorHID::resetStaleState(uint64_t now)
 	{
-		for (auto handler : _handlers)
-			handler->onSpaceMouseKeyDown(this, virtual_key);
-	}
+		std::lock_guard<std::mutex> guard{ _pollLock };
 
-	void SpaceNavigatorHID::onSpaceMouseKeyUp(UINT virtual_key)
-	{
-		for (auto handler : _handlers)
-			handler->onSpaceMouseKeyUp(this, virtual_key);
+		// If we have not received data for a while send a zero event
+		_deviceData.axes.fill(0.0f);
+		_deviceData.isDirty = true;
+		for (size_t i = 0; i < AxisSlots.size(); i++)
+			setAxisState(AxisSlots[i], 0, 0.0f);
+
+		if (motionAccumulation())
+			accumulateMotion(_deviceData.axes, now);
+		if (collectsEvents())
+			addMotionEvents(_deviceData.axes, now);
+
+		// The poll scheduler picks up the zero event by itself
+		if (!_poll3DMouse)
+			on3DMouseInput();
 	}
-	
-	void SpaceNavigatorHID::startTimer(HWND hwnd)
-	{
-		if (!_timer3DMouse)
-		{
-			// Create a new unused timer
-			_timer3DMouse = ::SetTimer(0, 0, USER_TIMER_MAXIMUM, nullptr);
 
-			// Now set the HWND to the derived window and correct the timeout
-			_timer3DMouse = ::SetTimer(hwnd, _timer3DMouse, _pollingPeriod3DMouse, NULL);
-		}
+	void SpaceNavigatorHID::onSpaceMouseMove(std::array<float, 6> motion_data)
+	{
+		SpaceNavigatorEvent event;
+		event.type = SpaceNavigatorEvent::Move;
+		event.device = this;
+		event.motion = motion_data;
+		dispatchEvent(event);
 	}
 
-	void SpaceNavigatorHID::onTimer(UINT_PTR event_id) 
+	void SpaceNavigatorHID::onSpaceMouseKeyDown(UINT virtual_key)
 	{
-		// Only if polling is enabled
-		if (_poll3DMouse)
-		{
-			if (event_id == _timer3DMouse)
-				on3DMouseInput();
-		}
+		SpaceNavigatorEvent event;
+		event.type = SpaceNavigatorEvent::KeyDown;
+		event.device = this;
+		event.virtualKey = virtual_key;
+		dispatchEvent(event);
 	}
 
-	void SpaceNavigatorHID::killPollingTimer()
+	void SpaceNavigatorHID::onSpaceMouseKeyUp(UINT virtual_key)
 	{
-		if (_poll3DMouse)
-		{
-			UINT_PTR timer = _timer3DMouse;
-			_timer3DMouse = 0;
-			if (timer)
-				::KillTimer(nullptr, timer);
-		}
+		SpaceNavigatorEvent event;
+		event.type = SpaceNavigatorEvent::KeyUp;
+		event.device = this;
+		event.virtualKey = virtual_key;
+		dispatchEvent(event);
 	}
 }}}
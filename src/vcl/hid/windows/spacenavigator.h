@@ -28,7 +28,9 @@
 #include <vcl/config/global.h>
 
 // C++ Standard library
+#include <array>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 // GSL
@@ -36,7 +38,10 @@
 
 // VCL
 #include <vcl/hid/windows/hid.h>
+#include <vcl/hid/pollscheduler.h>
 #include <vcl/hid/spacenavigator.h>
+#include <vcl/hid/spacenavigatorkeymap.h>
+#include <vcl/hid/spacenavigatorreport.h>
 
 namespace Vcl { namespace HID { namespace Windows
 {
@@ -46,10 +51,6 @@ namespace Vcl { namespace HID { namespace Windows
 	private:
 		struct InputData 
 		{
-			//! Current time to live for telling
-			//! if the device was unplugged while sending data
-			int timeToLive;
-
 			//! Indicate if the data is dirty
 			bool isDirty;
 
@@ -62,19 +63,30 @@ namespace Vcl { namespace HID { namespace Windows
 				return (0 == axes[0] && 0 == axes[1] && 0 == axes[2] &&
 						0 == axes[3] && 0 == axes[4] && 0 == axes[5]    );
 			}
-
-			//! Maximum time to live
-			static const int MaxTimeToLive = 5;
 		};
 
 	public:
+		//! \param dev Device implementation
+		//! \param poll_3d_mouse Poll the motion with an adaptive rate instead
+		//!        of processing it when it is received. The handlers are then
+		//!        called from the thread of the poll scheduler.
 		SpaceNavigatorHID(std::unique_ptr<GenericHID> dev, bool poll_3d_mouse = false);
 		
 		//! Reset device when activating the program
 		void onActivateApp(BOOL active, DWORD dwThreadID);
 
 		//! Handle device input
-		bool processInput(HWND window_handle, UINT input_code, PRAWINPUT raw_input) override;
+		size_t processReports(HWND window_handle, gsl::span<const RawReport> reports, InputStatistics& stats) override;
+
+		//! Access the scheduler polling the motion
+		//! \returns The scheduler, or null if the device is not polled
+		PollScheduler* pollScheduler() { return _scheduler.get(); }
+
+	protected:
+		auto readNames() const -> std::pair<std::string_view, std::string_view> override;
+
+		//! Send a zero event if the device was unplugged while sending data
+		void resetStaleState(uint64_t now) override;
 		
 	private:
 		
@@ -83,7 +95,7 @@ namespace Vcl { namespace HID { namespace Windows
 		 *        finally calling the move3D method.
 		 *
 		 * If polling is enabled (_poll3DMouse == true) this method is called
-		 * from the windows timer message handler
+		 * from the poll scheduler
 		 * If polling is not enabled (_poll3DMouse == false) this method is
 		 * called directly from the WM_INPUT handler
 		 */
@@ -119,39 +131,65 @@ namespace Vcl { namespace HID { namespace Windows
 		void onSpaceMouseKeyUp(UINT virtual_key);
 
 	private:
-		//! Process a raw input message
-		bool translateRawInputData(UINT input_code, PRAWINPUT raw_input);
+		//! Process a single report
+		bool translateReport(const RawReport& report);
+
+		//! Decode a single report into '_sample'
+		//! Uses the decoder generated for the device if there is one.
+		//! \returns The parts of the sample contained in the report
+		uint32_t decodeReport(const RawReport& report);
+
+		//! Process the motion contained in a report
+		//! \param sample Decoded report
+		//! \param contents Parts of the sample contained in the report
+		//! \param is_foreground Indicate whether the application receives the input in the foreground
+		//! \param timestamp Time the report was received
+		//! \returns True, if the report completed a new motion sample, which needs
+		//!          to be passed to the handlers
+		bool translateMotion(const SpaceNavigatorSample& sample, uint32_t contents, bool is_foreground, uint64_t timestamp);
+
+		//! Process the key state contained in a report
+		//! \param keystate Decoded key state
+		//! \param is_foreground Indicate whether the application receives the input in the foreground
+		//! \param timestamp Time the report was received
+		void translateKeystate(uint32_t keystate, bool is_foreground, uint64_t timestamp);
+
+		//! Append the events of a motion sample to the collected events
+		//! \param motion Motion per millisecond as returned by 'scaleMotion'
+		//! \param timestamp Time the sample was completed
+		void addMotionEvents(const std::array<float, 6>& motion, uint64_t timestamp);
+
+		//! Reports decoded so far. Split reports are merged into a single sample.
+		SpaceNavigatorSample _sample;
 
 		//! Axis input data
 		InputData _deviceData;
 
 		//! Button input data
 		uint32_t _keystate{ 0 };
-		
-		//! Last time the data was updated.
-		//! Use to calculate distance traveled since last event
-		DWORD _last3DMouseInputTime{ 0 };
 
-	private: // Polling support methods
+		//! Translation of the keys of this device model
+		const SpaceMouseKeymap* _keymap{ nullptr };
 
-		//! Start the timer
-		void startTimer(HWND hwnd);
-
-		//! Timer callback
-		void onTimer(UINT_PTR event_id);
-
-		//! Kill the currently running timer
-		void killPollingTimer();
+		//! Button states decoded from the last report
+		ButtonSet _decodedButtons;
+		
+		//! Indicate whether the last report was received in the foreground
+		bool _isForeground{ true };
+		
+		//! Last time the data was updated (steady clock, microseconds).
+		//! Use to calculate distance traveled since last event
+		uint64_t _last3DMouseInputTime{ 0 };
 		
 	private: // Polling support
 		//! 3D mouse is in polling mode
 		bool _poll3DMouse{ false };
-		
-		//! Polling period. Default is 50 Hz)
-		UINT _pollingPeriod3DMouse{ 20 };
 
-		//! 3DMouse data polling timer
+		//! Serialize the processing of the reports with the polling
+		std::mutex _pollLock;
+
+		//! Scheduler polling the motion.
 		//! Only used if _poll3DMouse == true
-		UINT_PTR _timer3DMouse{ 0 };
+		std::unique_ptr<PollScheduler> _scheduler;
 	};
 }}}
@@ -0,0 +1,171 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <cstdint>
+
+// VCL
+#include <vcl/hid/axiscalibrator.h>
+
+// Google test
+#include <gtest/gtest.h>
+
+using namespace Vcl::HID;
+
+namespace
+{
+	//! Feed a linear ramp of samples to the calibrator
+	void ramp(AxisCalibrator& calibrator, int32_t from, int32_t to, int32_t step)
+	{
+		if (from <= to)
+		{
+			for (int32_t value = from; value <= to; value += step)
+				calibrator.update(value);
+		}
+		else
+		{
+			for (int32_t value = from; value >= to; value -= step)
+				calibrator.update(value);
+		}
+	}
+}
+
+TEST(AxisCalibratorTest, NormalizeWithDeadZone)
+{
+	const AxisNormalization normalize{ AxisCalibration{ 0, 500, 1000, 10 } };
+
+	EXPECT_EQ(0.0f, normalize(500));
+	EXPECT_EQ(0.0f, normalize(510));
+	EXPECT_EQ(0.0f, normalize(490));
+	EXPECT_FLOAT_EQ(1.0f, normalize(1000));
+	EXPECT_FLOAT_EQ(-1.0f, normalize(0));
+	EXPECT_FLOAT_EQ(0.5f, normalize(755));
+
+	// Values beyond the calibrated range are clamped
+	EXPECT_FLOAT_EQ(1.0f, normalize(1200));
+	EXPECT_FLOAT_EQ(-1.0f, normalize(-200));
+}
+
+TEST(AxisCalibratorTest, PartialDeflectionKeepsInitialRange)
+{
+	AxisCalibrator calibrator;
+	calibrator.reset(0, 1023, { 0, 512, 1023, 0 }, false);
+
+	ramp(calibrator, 512, 700, 4);
+	ramp(calibrator, 700, 400, 4);
+
+	const auto calibration = calibrator.calibration();
+	EXPECT_EQ(0, calibration.minimum);
+	EXPECT_EQ(1023, calibration.maximum);
+	EXPECT_NEAR((700.0f - 512.0f) / 511.0f, calibrator.update(700), 1e-5f);
+	EXPECT_FALSE(calibrator.hasLearned());
+}
+
+TEST(AxisCalibratorTest, MeasuredRangeIsWidened)
+{
+	AxisCalibrator calibrator;
+	calibrator.reset(0, 1023, { 100, 512, 900, 0 }, true);
+
+	ramp(calibrator, 512, 950, 2);
+
+	const auto calibration = calibrator.calibration();
+	EXPECT_EQ(100, calibration.minimum);
+	EXPECT_EQ(950, calibration.maximum);
+	EXPECT_FLOAT_EQ(1.0f, calibrator.update(950));
+}
+
+TEST(AxisCalibratorTest, FullSweepReplacesInitialRange)
+{
+	AxisCalibrator calibrator;
+	calibrator.reset(0, 1023, { 0, 512, 1023, 0 }, false);
+
+	ramp(calibrator, 512, 30, 2);
+	EXPECT_FALSE(calibrator.hasLearned());
+
+	ramp(calibrator, 30, 990, 2);
+	ramp(calibrator, 990, 512, 2);
+
+	const auto calibration = calibrator.calibration();
+	EXPECT_EQ(30, calibration.minimum);
+	EXPECT_EQ(990, calibration.maximum);
+	EXPECT_TRUE(calibrator.hasLearned());
+	EXPECT_FLOAT_EQ(1.0f, calibrator.update(990));
+}
+
+TEST(AxisCalibratorTest, EstimateRestPosition)
+{
+	AxisCalibrator calibrator;
+	calibrator.reset(0, 1023, { 0, 512, 1023, 0 }, false);
+
+	// Noisy rest position off the nominal center
+	for (int i = 0; i < 400; i++)
+		calibrator.update(520 + (i & 1));
+
+	const auto calibration = calibrator.calibration();
+	EXPECT_NEAR(520.5, calibration.center, 1.0);
+	EXPECT_GE(calibration.noise, 1);
+	EXPECT_LE(calibration.noise, 3);
+
+	// The range was not swept, thus nothing is stored
+	EXPECT_FALSE(calibrator.hasLearned());
+
+	// Samples at rest are reported as zero
+	EXPECT_EQ(0.0f, calibrator.update(520));
+}
+
+TEST(AxisCalibratorTest, ResetRestoresInitialCalibration)
+{
+	AxisCalibrator calibrator;
+	calibrator.reset(0, 1023, { 0, 512, 1023, 0 }, false);
+	ramp(calibrator, 512, 0, 2);
+	ramp(calibrator, 0, 1023, 2);
+	EXPECT_TRUE(calibrator.hasLearned());
+
+	calibrator.reset(0, 1023, { 10, 500, 1000, 4 }, true);
+	const auto calibration = calibrator.calibration();
+	EXPECT_EQ(10, calibration.minimum);
+	EXPECT_EQ(500, calibration.center);
+	EXPECT_EQ(1000, calibration.maximum);
+	EXPECT_EQ(4, calibration.noise);
+	EXPECT_FALSE(calibrator.hasLearned());
+}
+
+TEST(AxisCalibratorTest, LearnWithoutNormalizing)
+{
+	AxisCalibrator calibrator;
+	calibrator.reset(0, 1023, { 0, 512, 1023, 0 }, false);
+	for (int32_t value = 512; value >= 30; value -= 2)
+		calibrator.learn(value);
+	for (int32_t value = 30; value <= 990; value += 2)
+		calibrator.learn(value);
+
+	// The published calibration normalizes like the learning thread
+	EXPECT_TRUE(calibrator.hasLearned());
+	EXPECT_FLOAT_EQ(1.0f, calibrator.normalizePublished(990));
+	EXPECT_FLOAT_EQ(calibrator.normalize(700), calibrator.normalizePublished(700));
+}
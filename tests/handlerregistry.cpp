@@ -0,0 +1,138 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// VCL
+#include <vcl/hid/handlerregistry.h>
+
+// Google test
+#include <gtest/gtest.h>
+
+using namespace Vcl::HID;
+
+namespace
+{
+	const uint32_t MoveEvent = 1;
+	const uint32_t KeyEvent = 2;
+}
+
+TEST(HandlerRegistryTest, DispatchByMask)
+{
+	HandlerRegistry<int> registry;
+	EXPECT_FALSE(registry.isSubscribed(MoveEvent));
+
+	std::vector<int> moves, keys;
+	registry.subscribe(MoveEvent, [&moves](const int& event) { moves.push_back(event); });
+	registry.subscribe(KeyEvent, [&keys](const int& event) { keys.push_back(event); });
+	EXPECT_TRUE(registry.isSubscribed(MoveEvent));
+	EXPECT_TRUE(registry.isSubscribed(KeyEvent));
+
+	registry.dispatch(MoveEvent, 1);
+	registry.dispatch(KeyEvent, 2);
+	registry.dispatch(MoveEvent | KeyEvent, 3);
+
+	EXPECT_EQ(moves, (std::vector<int>{ 1, 3 }));
+	EXPECT_EQ(keys, (std::vector<int>{ 2, 3 }));
+}
+
+TEST(HandlerRegistryTest, Unsubscribe)
+{
+	HandlerRegistry<int> registry;
+
+	int nr_calls = 0;
+	const auto id = registry.subscribe(MoveEvent, [&nr_calls](const int&) { nr_calls++; });
+	EXPECT_NE(id, HandlerRegistry<int>::Id{ 0 });
+
+	registry.dispatch(MoveEvent, 0);
+	EXPECT_TRUE(registry.unsubscribe(id));
+	EXPECT_FALSE(registry.unsubscribe(id));
+	EXPECT_FALSE(registry.isSubscribed(MoveEvent));
+
+	registry.dispatch(MoveEvent, 0);
+	EXPECT_EQ(nr_calls, 1);
+}
+
+TEST(HandlerRegistryTest, ChangeSubscriptionsDuringDispatch)
+{
+	HandlerRegistry<int> registry;
+
+	// The dispatch keeps iterating the table it started with
+	int nr_added_calls = 0;
+	HandlerRegistry<int>::Id self = 0;
+	self = registry.subscribe(MoveEvent, [&](const int&)
+	{
+		registry.unsubscribe(self);
+		registry.subscribe(MoveEvent, [&nr_added_calls](const int&) { nr_added_calls++; });
+	});
+
+	int nr_calls = 0;
+	registry.subscribe(MoveEvent, [&nr_calls](const int&) { nr_calls++; });
+
+	registry.dispatch(MoveEvent, 0);
+	EXPECT_EQ(nr_calls, 1);
+	EXPECT_EQ(nr_added_calls, 0);
+
+	// The next dispatch uses the published table
+	registry.dispatch(MoveEvent, 0);
+	EXPECT_EQ(nr_calls, 2);
+	EXPECT_EQ(nr_added_calls, 1);
+}
+
+TEST(HandlerRegistryTest, SubscribeWhileDispatching)
+{
+	HandlerRegistry<int> registry;
+
+	std::atomic<int> nr_calls{ 0 };
+	registry.subscribe(MoveEvent, [&nr_calls](const int&) { nr_calls++; });
+
+	std::atomic<bool> stop{ false };
+	std::thread dispatcher{ [&]()
+	{
+		while (!stop.load())
+			registry.dispatch(MoveEvent, 0);
+	} };
+
+	while (nr_calls.load() == 0)
+		std::this_thread::yield();
+
+	// Replacing the tables retires the snapshots used by the dispatcher
+	for (int i = 0; i < 1000; i++)
+	{
+		const auto id = registry.subscribe(KeyEvent, [](const int&) {});
+		registry.unsubscribe(id);
+	}
+
+	stop = true;
+	dispatcher.join();
+	EXPECT_TRUE(registry.isSubscribed(MoveEvent));
+	EXPECT_FALSE(registry.isSubscribed(KeyEvent));
+}
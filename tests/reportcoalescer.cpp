@@ -0,0 +1,173 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// VCL
+#include <vcl/hid/reportcoalescer.h>
+
+// Google test
+#include <gtest/gtest.h>
+
+using namespace Vcl::HID;
+
+namespace
+{
+	//! Reports with a report ID followed by a single data byte
+	class ReportBatch
+	{
+	public:
+		void add(uint8_t id, uint8_t value)
+		{
+			_data.push_back({ id, value });
+		}
+
+		std::vector<RawReport> reports() const
+		{
+			std::vector<RawReport> reports;
+			for (const auto& data : _data)
+			{
+				RawReport report;
+				report.data = data.data();
+				report.size = static_cast<uint32_t>(data.size());
+				reports.push_back(report);
+			}
+			return reports;
+		}
+
+	private:
+		std::vector<std::array<uint8_t, 2>> _data;
+	};
+}
+
+TEST(ReportCoalescerTest, DisabledDecodesAll)
+{
+	ReportBatch batch;
+	batch.add(1, 5);
+	batch.add(1, 5);
+	const auto reports = batch.reports();
+
+	ReportCoalescer coalescer;
+	InputStatistics stats;
+	const auto actions = coalescer.select(reports, stats);
+
+	ASSERT_EQ(2, actions.size());
+	EXPECT_EQ(ReportAction::Decode, actions[0]);
+	EXPECT_EQ(ReportAction::Decode, actions[1]);
+	EXPECT_EQ(0u, stats.nrDuplicateReports);
+	EXPECT_EQ(0u, stats.nrCoalescedReports);
+}
+
+TEST(ReportCoalescerTest, SkipDuplicates)
+{
+	ReportBatch batch;
+	batch.add(1, 5);
+	batch.add(1, 5);
+	batch.add(1, 6);
+	const auto reports = batch.reports();
+
+	ReportCoalescer coalescer;
+	coalescer.setEnabled(true);
+	InputStatistics stats;
+	const auto actions = coalescer.select(reports, stats);
+
+	ASSERT_EQ(3, actions.size());
+	EXPECT_EQ(ReportAction::Accumulate, actions[0]);
+	EXPECT_EQ(ReportAction::Skip, actions[1]);
+	EXPECT_EQ(ReportAction::Decode, actions[2]);
+	EXPECT_EQ(1u, stats.nrDuplicateReports);
+	EXPECT_EQ(1u, stats.nrCoalescedReports);
+}
+
+TEST(ReportCoalescerTest, SkipDuplicatesAcrossBatches)
+{
+	ReportBatch first;
+	first.add(1, 5);
+	ReportBatch second;
+	second.add(1, 5);
+
+	ReportCoalescer coalescer;
+	coalescer.setEnabled(true);
+	InputStatistics stats;
+	coalescer.select(first.reports(), stats);
+	const auto reports = second.reports();
+	const auto actions = coalescer.select(reports, stats);
+
+	ASSERT_EQ(1, actions.size());
+	EXPECT_EQ(ReportAction::Skip, actions[0]);
+
+	// Forgetting the previous reports decodes the report again
+	coalescer.reset();
+	EXPECT_EQ(ReportAction::Decode, coalescer.select(reports, stats)[0]);
+}
+
+TEST(ReportCoalescerTest, KeepDuplicatesOfRelativeAxes)
+{
+	ReportBatch batch;
+	batch.add(1, 5);
+	batch.add(1, 5);
+	const auto reports = batch.reports();
+
+	ReportCoalescer coalescer;
+	coalescer.setEnabled(true);
+	coalescer.setSuppressDuplicates(false);
+	InputStatistics stats;
+	const auto actions = coalescer.select(reports, stats);
+
+	ASSERT_EQ(2, actions.size());
+	EXPECT_EQ(ReportAction::Accumulate, actions[0]);
+	EXPECT_EQ(ReportAction::Decode, actions[1]);
+	EXPECT_EQ(0u, stats.nrDuplicateReports);
+}
+
+TEST(ReportCoalescerTest, DecodeNewestReportPerId)
+{
+	ReportBatch batch;
+	batch.add(1, 1);
+	batch.add(2, 1);
+	batch.add(1, 2);
+	batch.add(200, 1);
+	batch.add(2, 2);
+	const auto reports = batch.reports();
+
+	ReportCoalescer coalescer;
+	coalescer.setEnabled(true);
+	InputStatistics stats;
+	const auto actions = coalescer.select(reports, stats);
+
+	ASSERT_EQ(5, actions.size());
+	EXPECT_EQ(ReportAction::Accumulate, actions[0]);
+	EXPECT_EQ(ReportAction::Accumulate, actions[1]);
+	EXPECT_EQ(ReportAction::Decode, actions[2]);
+	EXPECT_EQ(ReportAction::Decode, actions[3]);
+	EXPECT_EQ(ReportAction::Decode, actions[4]);
+	EXPECT_EQ(2u, stats.nrCoalescedReports);
+}
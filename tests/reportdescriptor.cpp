@@ -0,0 +1,133 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <cstdint>
+#include <vector>
+
+// VCL
+#include <vcl/hid/decodeplan.h>
+#include <vcl/hid/reportdescriptor.h>
+
+// Google test
+#include <gtest/gtest.h>
+
+using namespace Vcl::HID;
+
+namespace
+{
+	//! Report descriptor of the 3Dconnexion SpaceNavigator (see 'data/descriptors')
+	const std::vector<uint8_t> SpaceNavigatorDescriptor =
+	{
+		0x05, 0x01, 0x09, 0x08, 0xa1, 0x01,
+		0xa1, 0x00, 0x85, 0x01, 0x16, 0xa2, 0xfe, 0x26, 0x5e, 0x01, 0x36, 0x88, 0xfa, 0x46, 0x78, 0x05, 0x55, 0x0c, 0x65, 0x11,
+		0x09, 0x30, 0x09, 0x31, 0x09, 0x32, 0x75, 0x10, 0x95, 0x03, 0x81, 0x06,
+		0xc0,
+		0xa1, 0x00, 0x85, 0x02,
+		0x09, 0x33, 0x09, 0x34, 0x09, 0x35, 0x75, 0x10, 0x95, 0x03, 0x81, 0x06,
+		0xc0,
+		0xa1, 0x02, 0x85, 0x03, 0x05, 0x01, 0x05, 0x09, 0x19, 0x01, 0x29, 0x02, 0x15, 0x00, 0x25, 0x01, 0x35, 0x00, 0x45, 0x01,
+		0x75, 0x01, 0x95, 0x02, 0x81, 0x02, 0x95, 0x0e, 0x81, 0x03,
+		0xc0,
+		0xa1, 0x02, 0x85, 0x04, 0x05, 0x08, 0x09, 0x4b, 0x15, 0x00, 0x25, 0x01, 0x95, 0x01, 0x75, 0x01, 0x91, 0x02, 0x95, 0x01, 0x75, 0x07, 0x91, 0x03,
+		0xc0,
+		0xc0
+	};
+}
+
+TEST(ReportDescriptorTest, ParseSpaceNavigator)
+{
+	ReportDescriptor descriptor;
+	ASSERT_TRUE(descriptor.parse(SpaceNavigatorDescriptor)) << descriptor.error();
+
+	const auto& values = descriptor.values();
+	ASSERT_EQ(6u, values.size());
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		EXPECT_EQ(i < 3 ? 0x01 : 0x02, values[i].reportId);
+		EXPECT_EQ(0x30 + i, values[i].usage);
+		EXPECT_EQ(8 + 16 * (i % 3), values[i].bit);
+		EXPECT_EQ(16u, values[i].bitSize);
+		EXPECT_EQ(-350, values[i].logicalMinimum);
+		EXPECT_EQ(350, values[i].logicalMaximum);
+		EXPECT_FALSE(values[i].isAbsolute);
+	}
+
+	// Padding and output reports are not part of the input fields
+	const auto& buttons = descriptor.buttons();
+	ASSERT_EQ(2u, buttons.size());
+	EXPECT_EQ(0x03, buttons[0].reportId);
+	EXPECT_EQ(8u, buttons[0].bit);
+	EXPECT_EQ(9u, buttons[1].bit);
+}
+
+TEST(ReportDescriptorTest, LayoutHashIsIndependentOfTheFieldOrder)
+{
+	ReportDescriptor descriptor;
+	ASSERT_TRUE(descriptor.parse(SpaceNavigatorDescriptor)) << descriptor.error();
+
+	const auto buttons = descriptor.buttonLocations();
+	const auto values = descriptor.valueLocations();
+	const uint64_t hash = layoutHash(buttons, values);
+
+	// Platforms may enumerate the fields in a different order
+	const std::vector<ButtonLocation> swapped_buttons = { buttons[1], buttons[0] };
+	const std::vector<ValueLocation> swapped_values = { values[3], values[4], values[5], values[0], values[1], values[2] };
+	EXPECT_EQ(hash, layoutHash(swapped_buttons, swapped_values));
+
+	const auto order = reportOrder<ValueLocation>(swapped_values);
+	EXPECT_EQ((std::vector<uint32_t>{ 3, 4, 5, 0, 1, 2 }), order);
+
+	// Moving a field changes the layout
+	auto moved_values = values;
+	moved_values[5].bit += 16;
+	EXPECT_NE(hash, layoutHash(buttons, moved_values));
+}
+
+TEST(ReportDescriptorTest, CompareButtonsOfReports)
+{
+	ReportDescriptor descriptor;
+	ASSERT_TRUE(descriptor.parse(SpaceNavigatorDescriptor)) << descriptor.error();
+
+	const auto buttons = descriptor.buttonLocations();
+	const DecodePlan plan{ buttons, descriptor.valueLocations() };
+
+	const std::vector<uint8_t> released = { 0x03, 0x00, 0x00 };
+	const std::vector<uint8_t> pressed = { 0x03, 0x02, 0x00 };
+	const std::vector<uint8_t> padding = { 0x03, 0x04, 0x80 };
+	EXPECT_TRUE(plan.buttonsDiffer(pressed, released));
+	EXPECT_FALSE(plan.buttonsDiffer(pressed, pressed));
+
+	// Bits outside of the buttons are ignored
+	EXPECT_FALSE(plan.buttonsDiffer(padding, released));
+
+	// Reports without buttons never differ
+	const std::vector<uint8_t> motion = { 0x01, 0x10, 0x00, 0x20, 0x00, 0x30, 0x00 };
+	const std::vector<uint8_t> rest = { 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+	EXPECT_FALSE(plan.buttonsDiffer(motion, rest));
+}
@@ -0,0 +1,119 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <array>
+#include <memory>
+#include <utility>
+
+// VCL
+#include <vcl/hid/smallfunction.h>
+
+// Google test
+#include <gtest/gtest.h>
+
+using namespace Vcl::HID;
+
+TEST(SmallFunctionTest, Empty)
+{
+	SmallFunction<int(int)> func;
+	EXPECT_FALSE(func);
+	EXPECT_FALSE(func.isInline());
+
+	SmallFunction<int(int)> null_func = nullptr;
+	EXPECT_FALSE(null_func);
+}
+
+TEST(SmallFunctionTest, StoreSmallCallableInline)
+{
+	int offset = 3;
+	SmallFunction<int(int)> func = [&offset](int value) { return value + offset; };
+	ASSERT_TRUE(func);
+	EXPECT_TRUE(func.isInline());
+	EXPECT_EQ(func(4), 7);
+
+	offset = 5;
+	EXPECT_EQ(func(4), 9);
+}
+
+TEST(SmallFunctionTest, StoreLargeCallableOnHeap)
+{
+	std::array<int, 32> values;
+	values.fill(2);
+
+	SmallFunction<int(size_t)> func = [values](size_t idx) { return values[idx]; };
+	ASSERT_TRUE(func);
+	EXPECT_FALSE(func.isInline());
+	EXPECT_EQ(func(5), 2);
+}
+
+TEST(SmallFunctionTest, MoveTransfersCallable)
+{
+	auto counter = std::make_shared<int>(0);
+	SmallFunction<void()> func = [counter]() { (*counter)++; };
+	EXPECT_EQ(counter.use_count(), 2);
+
+	SmallFunction<void()> moved = std::move(func);
+	EXPECT_FALSE(func);
+	ASSERT_TRUE(moved);
+	moved();
+	EXPECT_EQ(*counter, 1);
+	EXPECT_EQ(counter.use_count(), 2);
+
+	// Assigning destroys the previous callable
+	SmallFunction<void()> other = []() {};
+	other = std::move(moved);
+	other();
+	EXPECT_EQ(*counter, 2);
+	EXPECT_EQ(counter.use_count(), 2);
+
+	other.reset();
+	EXPECT_FALSE(other);
+	EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(SmallFunctionTest, MoveHeapCallable)
+{
+	auto counter = std::make_shared<int>(0);
+	std::array<char, 64> padding{};
+	SmallFunction<int()> func = [counter, padding]() { return ++(*counter) + padding[0]; };
+	ASSERT_FALSE(func.isInline());
+
+	SmallFunction<int()> moved = std::move(func);
+	EXPECT_EQ(moved(), 1);
+	EXPECT_EQ(counter.use_count(), 2);
+
+	moved = nullptr;
+	EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(SmallFunctionTest, ForwardMoveOnlyArguments)
+{
+	SmallFunction<int(std::unique_ptr<int>)> func = [](std::unique_ptr<int> value) { return *value; };
+	EXPECT_EQ(func(std::make_unique<int>(42)), 42);
+}
@@ -0,0 +1,143 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+// VCL configuration
+#include <vcl/config/global.h>
+#include <vcl/config/eigen.h>
+
+// C++ Standard library
+#include <array>
+#include <atomic>
+#include <thread>
+
+// VCL
+#include <vcl/hid/spacenavigatorfilter.h>
+#include <vcl/hid/spacenavigatorvirtualkeys.h>
+
+// Google test
+#include <gtest/gtest.h>
+
+using namespace Vcl::HID;
+
+namespace
+{
+	//! Compare the filtered axes
+	void expectNear(const std::array<float, 6>& expected, const std::array<float, 6>& actual)
+	{
+		for (size_t axis = 0; axis < 6; axis++)
+			EXPECT_NEAR(expected[axis], actual[axis], 1e-6f) << "Axis " << axis;
+	}
+}
+
+TEST(SpaceNavigatorFilterTest, PassByDefault)
+{
+	SpaceNavigatorFilter filter;
+	expectNear({ 0.1f, -0.2f, 0.3f, -0.4f, 0.5f, -1.0f }, filter.apply({ 0.1f, -0.2f, 0.3f, -0.4f, 0.5f, -1.0f }));
+}
+
+TEST(SpaceNavigatorFilterTest, ApplySensitivityAndCurve)
+{
+	SpaceNavigatorFilterSettings settings;
+	settings.sensitivity = { 2.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.5f };
+	settings.curve = { 0.0f, 1.0f, 0.5f, 2.0f, -1.0f, 0.0f };
+
+	SpaceNavigatorFilter filter;
+	filter.configure(settings);
+
+	// Curves beyond [0, 1] are clamped
+	expectNear({ 1.0f, -0.125f, 0.3125f, 0.125f, 0.5f, -0.25f }, filter.apply({ 0.5f, -0.5f, 0.5f, 0.5f, 0.5f, -0.5f }));
+}
+
+TEST(SpaceNavigatorFilterTest, MaskAxes)
+{
+	SpaceNavigatorFilterSettings settings;
+	settings.axisMask = 0x05;
+
+	SpaceNavigatorFilter filter;
+	filter.configure(settings);
+	expectNear({ 1, 0, 3, 0, 0, 0 }, filter.apply({ 1, 2, 3, 4, 5, 6 }));
+}
+
+TEST(SpaceNavigatorFilterTest, KeepDominantAxis)
+{
+	SpaceNavigatorFilterSettings settings;
+	settings.dominantAxis = true;
+
+	SpaceNavigatorFilter filter;
+	filter.configure(settings);
+	expectNear({ 0, 0, 0, -0.7f, 0, 0 }, filter.apply({ 0.1f, 0.2f, 0.3f, -0.7f, 0.5f, 0.6f }));
+
+	// The dominant axis is chosen after masking
+	settings.axisMask = 0x07;
+	filter.configure(settings);
+	expectNear({ 0, 0, 0.3f, 0, 0, 0 }, filter.apply({ 0.1f, 0.2f, 0.3f, -0.7f, 0.5f, 0.6f }));
+}
+
+TEST(SpaceNavigatorFilterTest, ToggleThroughKeys)
+{
+	SpaceNavigatorFilter filter;
+
+	EXPECT_TRUE(filter.handleKey(V3DK_ROTATE));
+	EXPECT_EQ(0x07u, filter.settings().axisMask);
+	expectNear({ 1, 2, 3, 0, 0, 0 }, filter.apply({ 1, 2, 3, 4, 5, 6 }));
+
+	EXPECT_TRUE(filter.handleKey(V3DK_PANZOOM));
+	EXPECT_EQ(0x00u, filter.settings().axisMask);
+
+	EXPECT_TRUE(filter.handleKey(V3DK_DOMINANT));
+	EXPECT_TRUE(filter.settings().dominantAxis);
+
+	// Other keys do not change the configuration
+	EXPECT_FALSE(filter.handleKey(V3DK_FIT));
+	EXPECT_EQ(0x00u, filter.settings().axisMask);
+	EXPECT_TRUE(filter.settings().dominantAxis);
+}
+
+TEST(SpaceNavigatorFilterTest, ConfigureWhileFiltering)
+{
+	SpaceNavigatorFilter filter;
+
+	std::atomic<bool> done{ false };
+	std::thread reader{ [&filter, &done]()
+	{
+		// Every result is produced by one of the two configurations
+		while (!done.load())
+		{
+			const auto y = filter.apply({ 1, 1, 1, 1, 1, 1 });
+			EXPECT_TRUE(y[0] == 1.0f || y[0] == 2.0f);
+			EXPECT_EQ(y[0], y[5]);
+		}
+	} };
+
+	SpaceNavigatorFilterSettings settings;
+	for (int i = 0; i < 1000; i++)
+	{
+		const float sensitivity = (i & 1) ? 2.0f : 1.0f;
+		settings.sensitivity = { sensitivity, sensitivity, sensitivity, sensitivity, sensitivity, sensitivity };
+		filter.configure(settings);
+	}
+
+	done = true;
+	reader.join();
+}
@@ -0,0 +1,134 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+// VCL configuration
+#include <vcl/config/global.h>
+#include <vcl/config/eigen.h>
+
+// C++ Standard library
+#include <array>
+#include <cmath>
+
+// VCL
+#include <vcl/hid/spacenavigatorpose.h>
+
+// Google test
+#include <gtest/gtest.h>
+
+using namespace Vcl::HID;
+
+namespace
+{
+	const float HalfPi = 1.57079632679f;
+
+	//! Compare two vectors component-wise
+	void expectNear(const Eigen::Vector3f& expected, const Eigen::Vector3f& actual)
+	{
+		EXPECT_NEAR(expected.x(), actual.x(), 1e-5f);
+		EXPECT_NEAR(expected.y(), actual.y(), 1e-5f);
+		EXPECT_NEAR(expected.z(), actual.z(), 1e-5f);
+	}
+}
+
+TEST(SpaceNavigatorPoseTest, TranslateInDeviceFrame)
+{
+	SpaceNavigatorPose pose{ SpaceNavigatorPose::Frame::Device };
+	pose.integrate(std::array<float, 6>{ 1, 2, 3, 0, 0, 0 });
+	pose.integrate(std::array<float, 6>{ 1, 0, 0, 0, 0, 0 });
+
+	expectNear({ 2, 2, 3 }, pose.position());
+	EXPECT_TRUE(pose.orientation().isApprox(Eigen::Quaternionf::Identity()));
+}
+
+TEST(SpaceNavigatorPoseTest, ConvertToUserFrame)
+{
+	// Pushing the cap down moves along -y in a y-up frame
+	SpaceNavigatorPose y_up{ SpaceNavigatorPose::Frame::YUp };
+	y_up.integrate(std::array<float, 6>{ 0, 0, 1, 0, 0, 0 });
+	expectNear({ 0, -1, 0 }, y_up.position());
+
+	// ... and along -z in a z-up frame
+	SpaceNavigatorPose z_up{ SpaceNavigatorPose::Frame::ZUp };
+	z_up.integrate(std::array<float, 6>{ 0, 0, 1, 0, 0, 0 });
+	expectNear({ 0, 0, -1 }, z_up.position());
+
+	// Pulling the cap towards the user
+	y_up.reset();
+	y_up.integrate(std::array<float, 6>{ 0, 1, 0, 0, 0, 0 });
+	expectNear({ 0, 0, 1 }, y_up.position());
+}
+
+TEST(SpaceNavigatorPoseTest, RotateAboutWorldPivot)
+{
+	SpaceNavigatorPose pose{ SpaceNavigatorPose::Frame::Device, SpaceNavigatorPose::Reference::World };
+	pose.setPivot({ 1, 0, 0 });
+	pose.integrate(std::array<float, 6>{ 0, 0, 0, 0, HalfPi, 0 });
+
+	// A quarter turn about y maps -x onto +z
+	expectNear({ 1, 0, 1 }, pose.position());
+	expectNear({ 0, 0, -1 }, pose.orientation() * Eigen::Vector3f::UnitX());
+}
+
+TEST(SpaceNavigatorPoseTest, MoveAlongLocalAxes)
+{
+	SpaceNavigatorPose pose{ SpaceNavigatorPose::Frame::Device, SpaceNavigatorPose::Reference::Local };
+	pose.reset(Eigen::Quaternionf{ Eigen::AngleAxisf{ HalfPi, Eigen::Vector3f::UnitZ() } });
+
+	// The local x-axis points along the world y-axis
+	pose.integrate(std::array<float, 6>{ 1, 0, 0, 0, 0, 0 });
+	expectNear({ 0, 1, 0 }, pose.position());
+
+	// Rotating about the local origin keeps the position
+	pose.integrate(std::array<float, 6>{ 0, 0, 0, HalfPi, 0, 0 });
+	expectNear({ 0, 1, 0 }, pose.position());
+	expectNear({ 0, 0, 1 }, pose.orientation() * Eigen::Vector3f::UnitY());
+}
+
+TEST(SpaceNavigatorPoseTest, ScaleMotion)
+{
+	SpaceNavigatorPose pose{ SpaceNavigatorPose::Frame::Device };
+	pose.setSensitivity(2.0f, 0.5f);
+
+	SpaceNavigatorMotion motion;
+	motion.translation = { 1, 0, 0 };
+	motion.rotation = { 0, 0, 2 * HalfPi };
+	pose.integrate(motion);
+
+	expectNear({ 2, 0, 0 }, pose.position());
+	expectNear({ 0, 1, 0 }, pose.orientation() * Eigen::Vector3f::UnitX());
+}
+
+TEST(SpaceNavigatorPoseTest, KeepOrientationNormalized)
+{
+	SpaceNavigatorPose pose{ SpaceNavigatorPose::Frame::YUp };
+	for (int i = 0; i < 100000; i++)
+		pose.integrate(std::array<float, 6>{ 0, 0, 0, 1e-3f, 2e-3f, -3e-3f });
+
+	EXPECT_NEAR(1.0f, pose.orientation().norm(), 1e-6f);
+
+	const Eigen::Matrix4f matrix = pose.matrix();
+	const Eigen::Matrix3f rotation = matrix.topLeftCorner<3, 3>();
+	EXPECT_TRUE(rotation.isApprox(pose.orientation().toRotationMatrix()));
+	EXPECT_EQ(Eigen::Vector4f(0, 0, 0, 1), Eigen::Vector4f(matrix.row(3)));
+}
@@ -0,0 +1,109 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// VCL
+#include <vcl/hid/spacenavigatorreport.h>
+
+// Google test
+#include <gtest/gtest.h>
+
+using namespace Vcl::HID;
+
+TEST(SpaceNavigatorReportTest, DecodeSplitMotionReports)
+{
+	SpaceNavigatorSample sample;
+
+	// Translation of (1, -2, 350) in little-endian order
+	const std::vector<uint8_t> translation = { 0x01, 0x01, 0x00, 0xfe, 0xff, 0x5e, 0x01 };
+	EXPECT_EQ(uint32_t{ SpaceNavigatorSample::Translation }, decodeSpaceNavigatorReport(translation, sample));
+	EXPECT_EQ(1, sample.axes[0]);
+	EXPECT_EQ(-2, sample.axes[1]);
+	EXPECT_EQ(350, sample.axes[2]);
+
+	// The rotation keeps the translation
+	const std::vector<uint8_t> rotation = { 0x02, 0xa2, 0xfe, 0x00, 0x80, 0xff, 0x7f };
+	EXPECT_EQ(uint32_t{ SpaceNavigatorSample::Rotation }, decodeSpaceNavigatorReport(rotation, sample));
+	EXPECT_EQ(350, sample.axes[2]);
+	EXPECT_EQ(-350, sample.axes[3]);
+	EXPECT_EQ(-32768, sample.axes[4]);
+	EXPECT_EQ(32767, sample.axes[5]);
+}
+
+TEST(SpaceNavigatorReportTest, DecodeHighSpeedReport)
+{
+	SpaceNavigatorSample sample;
+
+	// Place the report at an odd address to exercise unaligned loads
+	const std::array<uint8_t, 14> buffer = { 0x00, 0x01, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00, 0x04, 0x00, 0x05, 0x00, 0xfa, 0xff };
+	const gsl::span<const uint8_t> report{ buffer.data() + 1, buffer.size() - 1 };
+
+	EXPECT_EQ(SpaceNavigatorSample::Translation | SpaceNavigatorSample::Rotation, decodeSpaceNavigatorReport(report, sample));
+	EXPECT_EQ((std::array<int16_t, 6>{ 1, 2, 3, 4, 5, -6 }), sample.axes);
+}
+
+TEST(SpaceNavigatorReportTest, DecodeKeystate)
+{
+	SpaceNavigatorSample sample;
+
+	const std::vector<uint8_t> one_byte = { 0x03, 0x02 };
+	EXPECT_EQ(uint32_t{ SpaceNavigatorSample::Keystate }, decodeSpaceNavigatorReport(one_byte, sample));
+	EXPECT_EQ(0x2u, sample.keystate);
+
+	const std::vector<uint8_t> four_bytes = { 0x03, 0x01, 0x00, 0x00, 0x80 };
+	EXPECT_EQ(uint32_t{ SpaceNavigatorSample::Keystate }, decodeSpaceNavigatorReport(four_bytes, sample));
+	EXPECT_EQ(0x80000001u, sample.keystate);
+
+	// Additional bytes are ignored
+	const std::vector<uint8_t> six_bytes = { 0x03, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff };
+	EXPECT_EQ(uint32_t{ SpaceNavigatorSample::Keystate }, decodeSpaceNavigatorReport(six_bytes, sample));
+	EXPECT_EQ(0x0u, sample.keystate);
+}
+
+TEST(SpaceNavigatorReportTest, RejectInvalidReports)
+{
+	SpaceNavigatorSample sample;
+	sample.axes = { 1, 2, 3, 4, 5, 6 };
+
+	EXPECT_EQ(0u, decodeSpaceNavigatorReport({}, sample));
+
+	const std::vector<uint8_t> truncated_translation = { 0x01, 0x01, 0x00, 0x02, 0x00, 0x03 };
+	EXPECT_EQ(0u, decodeSpaceNavigatorReport(truncated_translation, sample));
+
+	const std::vector<uint8_t> truncated_rotation = { 0x02, 0x01 };
+	EXPECT_EQ(0u, decodeSpaceNavigatorReport(truncated_rotation, sample));
+
+	const std::vector<uint8_t> led = { 0x04, 0x01 };
+	EXPECT_EQ(0u, decodeSpaceNavigatorReport(led, sample));
+
+	// Rejected reports do not change the sample
+	EXPECT_EQ((std::array<int16_t, 6>{ 1, 2, 3, 4, 5, 6 }), sample.axes);
+}
@@ -0,0 +1,199 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <cstdint>
+#include <vector>
+
+// VCL
+#include <vcl/hid/timerwheel.h>
+
+// Google test
+#include <gtest/gtest.h>
+
+using namespace Vcl::HID;
+
+namespace
+{
+	TimerEvent makeEvent(uint32_t data)
+	{
+		TimerEvent event;
+		event.type = 1;
+		event.data = data;
+		return event;
+	}
+}
+
+TEST(TimerWheelTest, ExpireAtDeadline)
+{
+	TimerWheel wheel{ 0, 1000 };
+	wheel.schedule(5000, makeEvent(1));
+	EXPECT_EQ(wheel.size(), size_t{ 1 });
+
+	std::vector<uint32_t> expired;
+	auto collect = [&expired](const TimerEvent& event) { expired.push_back(event.data); };
+
+	EXPECT_EQ(wheel.advance(4999, collect), size_t{ 0 });
+	EXPECT_TRUE(expired.empty());
+
+	EXPECT_EQ(wheel.advance(5000, collect), size_t{ 1 });
+	ASSERT_EQ(expired.size(), size_t{ 1 });
+	EXPECT_EQ(expired[0], uint32_t{ 1 });
+	EXPECT_EQ(wheel.size(), size_t{ 0 });
+}
+
+TEST(TimerWheelTest, CascadeFromHigherLevels)
+{
+	// Deadlines on the first, second and third level of the wheel
+	const std::vector<uint64_t> deadlines = { 30, 100, 4000, 70000, 300000 };
+
+	TimerWheel wheel{ 0, 1 };
+	for (uint32_t i = 0; i < deadlines.size(); i++)
+		wheel.schedule(deadlines[i], makeEvent(i));
+
+	// Advance in steps not aligned with the levels of the wheel
+	const uint64_t step = 37;
+
+	std::vector<uint64_t> expired_at;
+	uint64_t now = 0;
+	auto collect = [&](const TimerEvent& event)
+	{
+		EXPECT_GE(now, deadlines[event.data]);
+		EXPECT_LT(now, deadlines[event.data] + step);
+		expired_at.push_back(event.data);
+	};
+
+	while (wheel.size() > 0 && now < 400000)
+	{
+		now += step;
+		wheel.advance(now, collect);
+	}
+
+	ASSERT_EQ(expired_at.size(), deadlines.size());
+	for (uint32_t i = 0; i < deadlines.size(); i++)
+		EXPECT_EQ(expired_at[i], i);
+}
+
+TEST(TimerWheelTest, CascadeInSingleAdvance)
+{
+	TimerWheel wheel{ 0, 1 };
+	wheel.schedule(70000, makeEvent(1));
+	wheel.schedule(65, makeEvent(0));
+
+	std::vector<uint32_t> expired;
+	auto collect = [&expired](const TimerEvent& event) { expired.push_back(event.data); };
+
+	EXPECT_EQ(wheel.advance(69999, collect), size_t{ 1 });
+	EXPECT_EQ(wheel.advance(70000, collect), size_t{ 1 });
+	ASSERT_EQ(expired.size(), size_t{ 2 });
+	EXPECT_EQ(expired[0], uint32_t{ 0 });
+	EXPECT_EQ(expired[1], uint32_t{ 1 });
+}
+
+TEST(TimerWheelTest, Cancel)
+{
+	TimerWheel wheel{ 0, 1 };
+	auto first = wheel.schedule(100, makeEvent(0));
+	auto second = wheel.schedule(5000, makeEvent(1));
+
+	EXPECT_TRUE(wheel.cancel(second));
+	EXPECT_FALSE(second.isValid());
+	EXPECT_FALSE(wheel.cancel(second));
+	EXPECT_EQ(wheel.size(), size_t{ 1 });
+
+	std::vector<uint32_t> expired;
+	auto collect = [&expired](const TimerEvent& event) { expired.push_back(event.data); };
+	wheel.advance(10000, collect);
+	ASSERT_EQ(expired.size(), size_t{ 1 });
+	EXPECT_EQ(expired[0], uint32_t{ 0 });
+
+	// The first timer expired, its handle is stale
+	EXPECT_FALSE(wheel.cancel(first));
+}
+
+TEST(TimerWheelTest, StaleHandleAfterNodeReuse)
+{
+	TimerWheel wheel{ 0, 1 };
+	auto stale = wheel.schedule(10, makeEvent(0));
+	auto copy = stale;
+	EXPECT_TRUE(wheel.cancel(stale));
+
+	// The new timer reuses the node of the cancelled one
+	auto fresh = wheel.schedule(20, makeEvent(1));
+	EXPECT_EQ(fresh.node, copy.node);
+	EXPECT_FALSE(wheel.cancel(copy));
+	EXPECT_EQ(wheel.size(), size_t{ 1 });
+	EXPECT_TRUE(wheel.cancel(fresh));
+}
+
+TEST(TimerWheelTest, CancelAll)
+{
+	int owner_a = 0, owner_b = 0;
+
+	TimerWheel wheel{ 0, 1 };
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		TimerEvent event = makeEvent(i);
+		event.target = (i % 2) ? &owner_a : &owner_b;
+		wheel.schedule(100 + 1000 * i, event);
+	}
+
+	EXPECT_EQ(wheel.cancelAll(&owner_a), size_t{ 2 });
+	EXPECT_EQ(wheel.size(), size_t{ 2 });
+
+	std::vector<const void*> expired;
+	wheel.advance(10000, [&expired](const TimerEvent& event) { expired.push_back(event.target); });
+	ASSERT_EQ(expired.size(), size_t{ 2 });
+	EXPECT_EQ(expired[0], &owner_b);
+	EXPECT_EQ(expired[1], &owner_b);
+}
+
+TEST(TimerWheelTest, RescheduleFromCallback)
+{
+	TimerWheel wheel{ 0, 1 };
+	wheel.schedule(10, makeEvent(0));
+
+	uint32_t nr_expired = 0;
+	wheel.advance(100, [&](const TimerEvent& event)
+	{
+		if (nr_expired++ < 3)
+			wheel.schedule(10 * (nr_expired + 1), event);
+	});
+	EXPECT_EQ(nr_expired, uint32_t{ 4 });
+	EXPECT_EQ(wheel.size(), size_t{ 0 });
+}
+
+TEST(TimerWheelTest, NextDeadline)
+{
+	TimerWheel wheel{ 0, 1000 };
+	EXPECT_EQ(wheel.nextDeadline(), std::numeric_limits<uint64_t>::max());
+
+	wheel.schedule(3000, makeEvent(0));
+	EXPECT_LE(wheel.nextDeadline(), uint64_t{ 3000 });
+	EXPECT_GT(wheel.nextDeadline(), uint64_t{ 0 });
+}
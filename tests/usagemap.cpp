@@ -0,0 +1,94 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <cstdint>
+
+// VCL
+#include <vcl/hid/usagemap.h>
+
+// Google test
+#include <gtest/gtest.h>
+
+using namespace Vcl::HID;
+
+TEST(UsageMapTest, TableIsSorted)
+{
+	for (size_t i = 1; i < UsageMap.size(); i++)
+	{
+		const auto& prev = UsageMap[i - 1];
+		const auto& curr = UsageMap[i];
+		EXPECT_TRUE(prev.usagePage < curr.usagePage || (prev.usagePage == curr.usagePage && prev.usage < curr.usage))
+			<< "Entry " << i;
+	}
+}
+
+TEST(UsageMapTest, FindMappedUsages)
+{
+	// Every entry of the table is found
+	for (const auto& mapping : UsageMap)
+		EXPECT_EQ(mapping.slot, findUsageSlot(mapping.usagePage, mapping.usage));
+
+	EXPECT_EQ(UsageSlot::X, findUsageSlot(UsagePage::GenericDesktop, 0x30));
+	EXPECT_EQ(UsageSlot::Hat, findUsageSlot(UsagePage::GenericDesktop, 0x39));
+	EXPECT_EQ(UsageSlot::Throttle, findUsageSlot(UsagePage::SimulationControls, 0xbb));
+	EXPECT_EQ(UsageSlot::Wheel, findUsageSlot(UsagePage::Consumer, 0x238));
+}
+
+TEST(UsageMapTest, IgnoreUnmappedUsages)
+{
+	EXPECT_EQ(UsageSlot::None, findUsageSlot(UsagePage::GenericDesktop, 0x00));
+	EXPECT_EQ(UsageSlot::None, findUsageSlot(UsagePage::GenericDesktop, 0x3a));
+	EXPECT_EQ(UsageSlot::None, findUsageSlot(0x09, 0x30));
+	EXPECT_EQ(UsageSlot::None, findUsageSlot(0xffff, 0xffff));
+}
+
+TEST(UsageMapTest, AssignSecondSlider)
+{
+	uint32_t used_slots = 0;
+	EXPECT_EQ(UsageSlot::X, assignUsageSlot(UsagePage::GenericDesktop, 0x30, used_slots));
+	EXPECT_EQ(UsageSlot::Slider, assignUsageSlot(UsagePage::GenericDesktop, 0x36, used_slots));
+	EXPECT_EQ(UsageSlot::Slider2, assignUsageSlot(UsagePage::SimulationControls, 0xc6, used_slots));
+	EXPECT_EQ(UsageSlot::Hat, assignUsageSlot(UsagePage::GenericDesktop, 0x39, used_slots));
+
+	// The hat switch does not occupy an axis slot
+	EXPECT_EQ(uint32_t{ UsageSlot::Slider2 } + 1, nrUsedAxisSlots(used_slots));
+}
+
+TEST(UsageMapTest, CountSlotsUpToHighestSlot)
+{
+	uint32_t used_slots = 0;
+	EXPECT_EQ(0u, nrUsedAxisSlots(used_slots));
+
+	// Axes without a slot do not count
+	assignUsageSlot(UsagePage::GenericDesktop, 0x3a, used_slots);
+	EXPECT_EQ(0u, nrUsedAxisSlots(used_slots));
+
+	// A throttle is stored behind the unused slots
+	assignUsageSlot(UsagePage::SimulationControls, 0xbb, used_slots);
+	EXPECT_EQ(uint32_t{ UsageSlot::Throttle } + 1, nrUsedAxisSlots(used_slots));
+}
@@ -0,0 +1,322 @@
+/*  
+ * This file is part of the Visual Computing Library (VCL) release under the
+ * license.
+ * 
+ * Copyright (c) 2017 Basil Fierz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// VCL configuration
+#include <vcl/config/global.h>
+
+// C++ Standard library
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// VCL
+#include <vcl/hid/decodeplan.h>
+#include <vcl/hid/reportdescriptor.h>
+
+/*
+ *	Generate decoders for known devices
+ *
+ *	Usage: vcl.hid.gen <output header> <descriptor files...>
+ *
+ *	A descriptor file contains the metadata of a device followed by its
+ *	captured report descriptor as hexadecimal bytes:
+ *
+ *		# Comment
+ *		name SpaceNavigator
+ *		vendor 0x046d
+ *		product 0xc626
+ *		descriptor
+ *		05 01 09 08 a1 01 ...
+ */
+
+namespace
+{
+	//! Device read from a descriptor file
+	struct DeviceDescription
+	{
+		std::string name;
+		uint16_t vendorId{ 0 };
+		std::vector<uint16_t> productIds;
+		std::vector<uint8_t> descriptor;
+	};
+
+	bool readDescription(const std::string& path, DeviceDescription& device)
+	{
+		std::ifstream file{ path };
+		if (!file)
+		{
+			std::cerr << path << ": Cannot open file\n";
+			return false;
+		}
+
+		bool in_descriptor = false;
+		std::string line;
+		while (std::getline(file, line))
+		{
+			const auto comment = line.find('#');
+			if (comment != std::string::npos)
+				line.erase(comment);
+
+			std::istringstream tokens{ line };
+			std::string token;
+			while (tokens >> token)
+			{
+				if (in_descriptor)
+				{
+					device.descriptor.push_back(static_cast<uint8_t>(std::stoul(token, nullptr, 16)));
+				}
+				else if (token == "name")
+				{
+					tokens >> device.name;
+				}
+				else if (token == "vendor")
+				{
+					tokens >> token;
+					device.vendorId = static_cast<uint16_t>(std::stoul(token, nullptr, 0));
+				}
+				else if (token == "product")
+				{
+					tokens >> token;
+					device.productIds.push_back(static_cast<uint16_t>(std::stoul(token, nullptr, 0)));
+				}
+				else if (token == "descriptor")
+				{
+					in_descriptor = true;
+				}
+				else
+				{
+					std::cerr << path << ": Unknown keyword '" << token << "'\n";
+					return false;
+				}
+			}
+		}
+
+		if (device.name.empty() || device.productIds.empty() || device.descriptor.empty())
+		{
+			std::cerr << path << ": Name, product and descriptor are required\n";
+			return false;
+		}
+
+		return true;
+	}
+
+	std::string hex(uint64_t value, int digits)
+	{
+		char buffer[24];
+		std::snprintf(buffer, sizeof(buffer), "0x%0*llx", digits, static_cast<unsigned long long>(value));
+		return buffer;
+	}
+
+	void writeDecoder(std::ostream& out, const DeviceDescription& device, const Vcl::HID::ReportDescriptor& descriptor, uint64_t hash)
+	{
+		// Fields are numbered in the order of their position in the reports
+		auto buttons = descriptor.buttonLocations();
+		auto values = descriptor.valueLocations();
+		std::stable_sort(buttons.begin(), buttons.end(), Vcl::HID::isStoredBefore<Vcl::HID::ButtonLocation>);
+		std::stable_sort(values.begin(), values.end(), Vcl::HID::isStoredBefore<Vcl::HID::ValueLocation>);
+
+		// Report IDs in the order of their first appearance
+		std::vector<uint8_t> report_ids;
+		const auto add_report = [&report_ids](uint8_t id)
+		{
+			for (auto known : report_ids)
+				if (known == id)
+					return;
+			report_ids.push_back(id);
+		};
+		for (const auto& button : buttons)
+			add_report(button.reportId);
+		for (const auto& value : values)
+			add_report(value.reportId);
+
+		out << "\t\t//! Decoder of the " << device.name << "\n";
+		out << "\t\tstruct " << device.name << "\n";
+		out << "\t\t{\n";
+		out << "\t\t\tstatic constexpr uint16_t VendorId = " << hex(device.vendorId, 4) << ";\n";
+		out << "\t\t\tstatic constexpr uint64_t LayoutHash = " << hex(hash, 16) << "ull;\n";
+		out << "\t\t\tstatic constexpr uint32_t NrButtons = " << buttons.size() << ";\n";
+		out << "\t\t\tstatic constexpr uint32_t NrValues = " << values.size() << ";\n\n";
+
+		// Buttons are read in runs of consecutive bits
+		out << "\t\t\tstatic bool decodeButtons(gsl::span<const uint8_t> report, ButtonSet& buttons)\n";
+		out << "\t\t\t{\n";
+		out << "\t\t\t\tif (report.empty())\n";
+		out << "\t\t\t\t\treturn false;\n\n";
+		out << "\t\t\t\tswitch (report[0])\n";
+		out << "\t\t\t\t{\n";
+		for (auto id : report_ids)
+		{
+			bool has_buttons = false;
+			for (size_t i = 0; i < buttons.size();)
+			{
+				if (buttons[i].reportId != id)
+				{
+					i++;
+					continue;
+				}
+
+				size_t count = 1;
+				while (i + count < buttons.size() && count < 56 &&
+				       buttons[i + count].reportId == id &&
+				       buttons[i + count].bit == buttons[i].bit + count)
+				{
+					count++;
+				}
+
+				if (!has_buttons)
+					out << "\t\t\t\tcase " << hex(id, 2) << ":\n";
+				has_buttons = true;
+
+				out << "\t\t\t\t\tbuttons.setBits(" << i << ", " << count << ", Generated::readBits<" << buttons[i].bit << ", " << count << ">(report));\n";
+				i += count;
+			}
+			if (has_buttons)
+				out << "\t\t\t\t\treturn true;\n";
+		}
+		out << "\t\t\t\tdefault:\n";
+		out << "\t\t\t\t\treturn false;\n";
+		out << "\t\t\t\t}\n";
+		out << "\t\t\t}\n\n";
+
+		out << "\t\t\tstatic uint64_t decodeValues(gsl::span<const uint8_t> report, gsl::span<int32_t> values)\n";
+		out << "\t\t\t{\n";
+		out << "\t\t\t\tif (report.empty())\n";
+		out << "\t\t\t\t\treturn 0;\n\n";
+		out << "\t\t\t\tswitch (report[0])\n";
+		out << "\t\t\t\t{\n";
+		for (auto id : report_ids)
+		{
+			uint64_t mask = 0;
+			for (size_t i = 0; i < values.size(); i++)
+			{
+				if (values[i].reportId != id)
+					continue;
+
+				if (mask == 0)
+					out << "\t\t\t\tcase " << hex(id, 2) << ":\n";
+				mask |= uint64_t{ 1 } << i;
+
+				out << "\t\t\t\t\tvalues[" << i << "] = Generated::readValue<" << values[i].bit << ", " << unsigned(values[i].bitSize) << ", " << (values[i].isSigned ? "true" : "false") << ">(report);\n";
+			}
+			if (mask != 0)
+				out << "\t\t\t\t\treturn " << hex(mask, 1) << "ull;\n";
+		}
+		out << "\t\t\t\tdefault:\n";
+		out << "\t\t\t\t\treturn 0;\n";
+		out << "\t\t\t\t}\n";
+		out << "\t\t\t}\n";
+		out << "\t\t};\n";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	using namespace Vcl::HID;
+
+	if (argc < 3)
+	{
+		std::cerr << "Usage: vcl.hid.gen <output header> <descriptor files...>\n";
+		return 1;
+	}
+
+	std::vector<DeviceDescription> devices;
+	std::vector<uint64_t> hashes;
+	std::ostringstream out;
+	out << "// Generated by vcl.hid.gen. Do not edit.\n";
+	out << "#pragma once\n\n";
+	out << "// VCL\n";
+	out << "#include <vcl/hid/generateddecoder.h>\n\n";
+	out << "namespace Vcl { namespace HID { namespace Generated\n";
+	out << "{\n";
+	out << "\tnamespace Devices\n";
+	out << "\t{\n";
+	for (int i = 2; i < argc; i++)
+	{
+		DeviceDescription device;
+		if (!readDescription(argv[i], device))
+			return 1;
+
+		ReportDescriptor descriptor;
+		if (!descriptor.parse(device.descriptor))
+		{
+			std::cerr << argv[i] << ": " << descriptor.error() << "\n";
+			return 1;
+		}
+		if (descriptor.values().size() > 64)
+		{
+			std::cerr << argv[i] << ": More than 64 values are not supported\n";
+			return 1;
+		}
+
+		const auto hash = layoutHash(descriptor.buttonLocations(), descriptor.valueLocations());
+		if (!devices.empty())
+			out << "\n";
+		writeDecoder(out, device, descriptor, hash);
+
+		devices.push_back(std::move(device));
+		hashes.push_back(hash);
+	}
+	out << "\t}\n\n";
+
+	out << "\t//! Decoders of all known devices\n";
+	out << "\tconstexpr GeneratedDecoder Decoders[] =\n";
+	out << "\t{\n";
+	for (const auto& device : devices)
+	{
+		const std::string type = "Devices::" + device.name;
+		for (auto product_id : device.productIds)
+		{
+			out << "\t\t{ \"" << device.name << "\", " << type << "::VendorId, " << hex(product_id, 4) << ", "
+			    << type << "::LayoutHash, " << type << "::NrButtons, " << type << "::NrValues, "
+			    << "&" << type << "::decodeButtons, &" << type << "::decodeValues },\n";
+		}
+	}
+	out << "\t};\n";
+	out << "}}}\n";
+
+	// Only touch the output if it changed to avoid needless rebuilds
+	const std::string content = out.str();
+	{
+		std::ifstream existing{ argv[1] };
+		std::stringstream current;
+		current << existing.rdbuf();
+		if (existing && current.str() == content)
+			return 0;
+	}
+
+	std::ofstream file{ argv[1] };
+	if (!file)
+	{
+		std::cerr << argv[1] << ": Cannot write file\n";
+		return 1;
+	}
+	file << content;
+
+	return 0;
+}